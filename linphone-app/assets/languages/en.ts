@@ -49,6 +49,18 @@
         <source>commandLineOptionVerbose</source>
         <translation>log to stdout some debug information while running</translation>
     </message>
+    <message>
+        <source>commandLineOptionCallQualityReport</source>
+        <translation>print a summary of the quality of the calls of the last &lt;days&gt; days (0 for all calls) and exit</translation>
+    </message>
+    <message>
+        <source>commandLineOptionCallQualityReportArg</source>
+        <translation>days</translation>
+    </message>
+    <message>
+        <source>commandLineOptionProfileStartup</source>
+        <translation>print the duration of the startup stages, and their allocation count in profiling builds</translation>
+    </message>
     <message>
         <source>commandLineOptionConfig</source>
         <translation>specify the %1 configuration file to be used</translation>
@@ -49,6 +49,18 @@
         <source>commandLineOptionVerbose</source>
         <translation>afficher dans le flux de sortie &apos;stdout&apos; les informations de débogage</translation>
     </message>
+    <message>
+        <source>commandLineOptionCallQualityReport</source>
+        <translation>afficher un résumé de la qualité des appels des &lt;jours&gt; derniers jours (0 pour tous les appels) et quitter</translation>
+    </message>
+    <message>
+        <source>commandLineOptionCallQualityReportArg</source>
+        <translation>jours</translation>
+    </message>
+    <message>
+        <source>commandLineOptionProfileStartup</source>
+        <translation>afficher la durée des étapes de démarrage, et leur nombre d&apos;allocations dans les versions de profilage</translation>
+    </message>
     <message>
         <source>commandLineOptionConfig</source>
         <translation>spécifier le fichier de configuration %1 à utiliser</translation>
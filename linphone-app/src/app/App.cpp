@@ -38,9 +38,11 @@
 
 #include "config.h"
 #include "cli/Cli.hpp"
+#include "component-cache/ComponentCache.hpp"
 #include "components/Components.hpp"
 #include "logger/Logger.hpp"
 #include "paths/Paths.hpp"
+#include "profiler/StartupProfiler.hpp"
 #include "providers/AvatarProvider.hpp"
 #include "providers/ImageProvider.hpp"
 #include "providers/ExternalImageProvider.hpp"
@@ -147,11 +149,22 @@ static inline bool installLocale (App &app, QTranslator &translator, const QLoca
 	return translator.load(locale, Constants::LanguagePath) && app.installTranslator(&translator);
 }
 
-static inline string getConfigPathIfExists (const QCommandLineParser &parser) {
-	QString filePath = parser.value("config");
+// A remote config is fetched in background: the app starts from the last fetched one and
+// is restarted if the server provides a new one.
+string App::getConfigPathIfExists () {
+	QString filePath = mParser->value("config");
 	string configPath;
 	if(!QUrl(filePath).isRelative()){
-		configPath = Utils::appStringToCoreString(FileDownloader::synchronousDownload(filePath, Utils::coreStringToAppString(Paths::getConfigDirPath(false)), true));
+		QUrl url(filePath);
+		if (!mConfigFetcher || mConfigFetcher->getUrl() != url) {
+			delete mConfigFetcher;
+			mConfigFetcher = new RemoteConfigFetcher(url, Utils::coreStringToAppString(Paths::getConfigDirPath(false)), this);
+			QObject::connect(mConfigFetcher, &RemoteConfigFetcher::configChanged, this, &App::handleRemoteConfigChanged);
+			mConfigFetcher->fetch();
+		}
+		configPath = Utils::appStringToCoreString(mConfigFetcher->getCachedFilePath());
+		if (configPath == "")
+			qInfo() << QStringLiteral("No cached remote config yet, starting without it.");
 	}
 	if( configPath == "")
 		configPath = Paths::getConfigFilePath(filePath, false);
@@ -160,6 +173,25 @@ static inline string getConfigPathIfExists (const QCommandLineParser &parser) {
 	return configPath;
 }
 
+// Calls are not interrupted: the new config is applied when the last one is over.
+void App::handleRemoteConfigChanged () {
+	CoreManager *coreManager = CoreManager::getInstance();
+	if (!coreManager || !coreManager->started() || coreManager->getCallsListModel()->rowCount() == 0) {
+		qInfo() << QStringLiteral("Remote config changed, restarting app...");
+		restart();
+		return;
+	}
+	qInfo() << QStringLiteral("Remote config changed, it will be applied after the current calls.");
+	CallsListModel *calls = coreManager->getCallsListModel();
+	QObject *context = new QObject(calls);
+	QObject::connect(calls, &CallsListModel::rowsRemoved, context, [this, calls, context] {
+		if (calls->rowCount() == 0) {
+			delete context;
+			restart();
+		}
+	});
+}
+
 bool App::setFetchConfig (QCommandLineParser *parser) {
 	bool fetched = false;
 	QString filePath = parser->value("fetch-config");
@@ -195,6 +227,7 @@ bool App::setFetchConfig (QCommandLineParser *parser) {
 
 
 App::App (int &argc, char *argv[]) : SingleApplication(argc, argv, true, Mode::User | Mode::ExcludeAppPath | Mode::ExcludeAppVersion) {
+	mStartupTimer.start();
 	
 	connect(this, SIGNAL(applicationStateChanged(Qt::ApplicationState)), this, SLOT(stateChanged(Qt::ApplicationState)));
 	
@@ -213,9 +246,12 @@ App::App (int &argc, char *argv[]) : SingleApplication(argc, argv, true, Mode::U
 
 	createParser();
 	mParser->process(*this);
+	if (mParser->isSet("profile-startup"))
+		StartupProfiler::enable(mStartupTimer.elapsed());
 	
 	// Initialize logger.
-	shared_ptr<linphone::Config> config = Utils::getConfigIfExists (QString::fromStdString(getConfigPathIfExists(*mParser)));
+	StartupProfiler::start("app: logger and locale");
+	shared_ptr<linphone::Config> config = Utils::getConfigIfExists (QString::fromStdString(getConfigPathIfExists()));
 	Logger::init(config);
 	if (mParser->isSet("verbose"))
 		Logger::getInstance()->setVerbose(true);
@@ -228,6 +264,7 @@ App::App (int &argc, char *argv[]) : SingleApplication(argc, argv, true, Mode::U
 	mTranslator = new DefaultTranslator(this);
 	mDefaultTranslator = new DefaultTranslator(this);
 	initLocale(config);
+	StartupProfiler::stop("app: logger and locale");
 	
 	if (mParser->isSet("help")) {
 		mParser->showHelp();
@@ -238,6 +275,12 @@ App::App (int &argc, char *argv[]) : SingleApplication(argc, argv, true, Mode::U
 		::exit(EXIT_SUCCESS);
 	}
 	
+	if (mParser->isSet("call-quality-report")) {
+		QTextStream out(stdout);
+		CallQualityArchive::printReport(out, mParser->value("call-quality-report").toInt());
+		::exit(EXIT_SUCCESS);
+	}
+	
 	if (mParser->isSet("version"))
 		mParser->showVersion();
 	
@@ -254,6 +297,10 @@ App::~App () {
 void App::stop(){
 	qInfo() << QStringLiteral("Stopping app...");
 	if( mEngine ){
+		delete mNotifier;
+		mNotifier = nullptr;
+		delete mComponentCache;
+		mComponentCache = nullptr;
 		delete mEngine;
 		processEvents(QEventLoop::AllEvents);
 	}
@@ -289,22 +336,26 @@ void App::processArguments(QHash<QString,QString> args){
 		qWarning() << "Parsing error : " << mParser->errorText();
 }
 
-static QQuickWindow *createSubWindow (QQmlApplicationEngine *engine, const char *path) {
+QQuickWindow *App::createSubWindow (const char *path) {
 	qInfo() << QStringLiteral("Creating subwindow: `%1`.").arg(path);
+	QElapsedTimer timer;
+	timer.start();
 	
-	QQmlComponent component(engine, QUrl(path));
-	if (component.isError()) {
-		qWarning() << component.errors();
+	QQmlComponent *component = mComponentCache->getComponent(path);
+	if (component->isError()) {
+		qWarning() << component->errors();
 		abort();
 	}
-	qInfo() << QStringLiteral("Subwindow status: `%1`.").arg(component.status());
+	qInfo() << QStringLiteral("Subwindow status: `%1`.").arg(component->status());
 	
-	QObject *object = component.create();
+	QObject *object = mComponentCache->create(path);
 	Q_ASSERT(object);
 	
 	QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
-	object->setParent(engine);
+	object->setParent(mEngine);
 	
+	qInfo() << QStringLiteral("Subwindow `%1` created in %2 ms (%3 ms after startup).")
+			   .arg(path).arg(timer.elapsed()).arg(mStartupTimer.elapsed());
 	return qobject_cast<QQuickWindow *>(object);
 }
 
@@ -322,10 +373,17 @@ void App::initContentApp () {
 		setFetchConfig(mParser);
 		setOpened(false);
 		qInfo() << QStringLiteral("Restarting app...");
+		mStartupTimer.restart();
 		
-		delete mEngine;
-		
+		// Notification views must be deleted before their engine.
+		delete mNotifier;
 		mNotifier = nullptr;
+		delete mComponentCache;
+		mComponentCache = nullptr;
+		
+		delete mEngine;
+		mCallsWindow = nullptr;
+		mSettingsWindow = nullptr;
 		//
 		CoreManager::uninit();
 		removeTranslator(mTranslator);
@@ -334,15 +392,17 @@ void App::initContentApp () {
 		delete mDefaultTranslator;
 		mTranslator = new DefaultTranslator(this);
 		mDefaultTranslator = new DefaultTranslator(this);
-		configPath = getConfigPathIfExists(*mParser);
+		configPath = getConfigPathIfExists();
 		config = Utils::getConfigIfExists (QString::fromStdString(configPath));
 		initLocale(config);
 	} else {
-		configPath = getConfigPathIfExists(*mParser);
+		StartupProfiler::start("app: config and codecs");
+		configPath = getConfigPathIfExists();
 		config = Utils::getConfigIfExists(QString::fromStdString(configPath));
 		// Update and download codecs.
 		VideoCodecsModel::updateCodecs();
-		VideoCodecsModel::downloadUpdatableCodecs(this);
+		VideoCodecsModel::downloadUpdatableCodecs(this, config);
+		StartupProfiler::stop("app: config and codecs");
 		
 		// Don't quit if last window is closed!!!
 		setQuitOnLastWindowClosed(false);
@@ -373,7 +433,9 @@ void App::initContentApp () {
 	
 	
 	// Init engine content.
+	StartupProfiler::start("qml: engine");
 	mEngine = new QQmlApplicationEngine(this);
+	mComponentCache = new ComponentCache(mEngine, this);
 	
 	// Provide `+custom` folders for custom components and `5.9` for old components.
 	{
@@ -420,19 +482,26 @@ void App::initContentApp () {
 	mEngine->rootContext()->setContextProperty("Images", mImageListModel->getQmlData());
 	
 	mEngine->rootContext()->setContextProperty("qtIsNewer_5_15_0", QT_VERSION >= QT_VERSION_CHECK(5, 15, 0) );
+	StartupProfiler::stop("qml: engine");
 	
+	StartupProfiler::start("qml: types");
 	registerTypes();
 	registerSharedTypes();
 	registerToolTypes();
 	registerSharedToolTypes();
+	StartupProfiler::stop("qml: types");
 	
 	// Enable notifications.
+	StartupProfiler::start("app: notifier");
 	mNotifier = new Notifier(mEngine);
+	StartupProfiler::stop("app: notifier");
 	// Load main view.
 	qInfo() << QStringLiteral("Loading main view...");
+	StartupProfiler::start("qml: main window");
 	mEngine->load(QUrl(Constants::QmlViewMainWindow));
 	if (mEngine->rootObjects().isEmpty())
 		qFatal("Unable to open main window.");
+	StartupProfiler::stop("qml: main window");
 	
 	QObject::connect(
 				CoreManager::getInstance(),
@@ -486,12 +555,14 @@ bool App::event (QEvent *event) {
 
 // -----------------------------------------------------------------------------
 
-QQuickWindow *App::getCallsWindow () const {
+QQuickWindow *App::getCallsWindow (bool create) {
 	if (CoreManager::getInstance()->getCore()->getConfig()->getInt(
 				SettingsModel::UiSection, "disable_calls_window", 0
 				))
 		return nullptr;
 	
+	if (!mCallsWindow && create && mEngine)
+		mCallsWindow = createSubWindow(Constants::QmlViewCallsWindow);
 	return mCallsWindow;
 }
 
@@ -501,7 +572,18 @@ QQuickWindow *App::getMainWindow () const {
 				);
 }
 
-QQuickWindow *App::getSettingsWindow () const {
+QQuickWindow *App::getSettingsWindow (bool create) {
+	if (!mSettingsWindow && create && mEngine) {
+		mSettingsWindow = createSubWindow(Constants::QmlViewSettingsWindow);
+		CoreManager *coreManager = CoreManager::getInstance();
+		QObject::connect(mSettingsWindow, &QWindow::visibilityChanged, this, [coreManager](QWindow::Visibility visibility) {
+			if (visibility == QWindow::Hidden) {
+				qInfo() << QStringLiteral("Update nat policy.");
+				shared_ptr<linphone::Core> core = coreManager->getCore();
+				core->setNatPolicy(core->getNatPolicy());
+			}
+		});
+	}
 	return mSettingsWindow;
 }
 
@@ -548,7 +630,9 @@ void App::createParser () {
 						#ifndef Q_OS_MACOS
 							{ "iconified", tr("commandLineOptionIconified") },
 						#endif // ifndef Q_OS_MACOS
-							{ { "V", "verbose" }, tr("commandLineOptionVerbose") }
+							{ { "V", "verbose" }, tr("commandLineOptionVerbose") },
+							{ "call-quality-report", tr("commandLineOptionCallQualityReport"), tr("commandLineOptionCallQualityReportArg") },
+							{ "profile-startup", tr("commandLineOptionProfileStartup") }
 						});
 }
 
@@ -685,6 +769,7 @@ void App::registerTypes () {
 	
 	
 	registerUncreatableType<CallModel>("CallModel");
+	registerUncreatableType<CallStatsModel>("CallStatsModel");
 	registerUncreatableType<ChatCallModel>("ChatCallModel");
 	registerUncreatableType<ChatMessageModel>("ChatMessageModel");
 	registerUncreatableType<ChatNoticeModel>("ChatNoticeModel");
@@ -699,11 +784,13 @@ void App::registerTypes () {
 	registerUncreatableType<ContentListModel>("ContentListModel");
 	registerUncreatableType<HistoryModel>("HistoryModel");
 	registerUncreatableType<LdapModel>("LdapModel");
+	registerUncreatableType<AudioLevelMeter>("AudioLevelMeter");
 	registerUncreatableType<RecorderModel>("RecorderModel");
 	registerUncreatableType<SearchResultModel>("SearchResultModel");
 	registerUncreatableType<SipAddressObserver>("SipAddressObserver");	
 	registerUncreatableType<VcardModel>("VcardModel");
 	registerUncreatableType<TimelineModel>("TimelineModel");
+	registerUncreatableType<TransferModel>("TransferModel");
 	registerUncreatableType<TunnelModel>("TunnelModel");
 	registerUncreatableType<TunnelConfigModel>("TunnelConfigModel");
 	registerUncreatableType<TunnelConfigProxyModel>("TunnelConfigProxyModel");
@@ -733,6 +820,7 @@ void App::registerSharedTypes () {
 	registerSharedSingletonType<LdapListModel, &CoreManager::getLdapListModel>("LdapListModel");
 	registerSharedSingletonType<TimelineListModel, &CoreManager::getTimelineListModel>("TimelineListModel");
 	registerSharedSingletonType<RecorderManager, &CoreManager::getRecorderManager>("RecorderManager");
+	registerSharedSingletonType<TransferScheduler, &CoreManager::getTransferScheduler>("TransferScheduler");
 	
 	//qmlRegisterSingletonType<ColorListModel>(Constants::MainQmlUri, 1, 0, "ColorList", mColorListModel);
 	
@@ -986,19 +1074,11 @@ void App::setAutoStart (bool enabled) {
 // -----------------------------------------------------------------------------
 
 void App::openAppAfterInit (bool mustBeIconified) {
+	StartupProfiler::Stage stage("app: open");
 	qInfo() << QStringLiteral("Open " APPLICATION_NAME " app.");
 	auto coreManager = CoreManager::getInstance();
 	coreManager->getSettingsModel()->updateCameraMode();
-	// Create other windows.
-	mCallsWindow = createSubWindow(mEngine, Constants::QmlViewCallsWindow);
-	mSettingsWindow = createSubWindow(mEngine, Constants::QmlViewSettingsWindow);
-	QObject::connect(mSettingsWindow, &QWindow::visibilityChanged, this, [coreManager](QWindow::Visibility visibility) {
-		if (visibility == QWindow::Hidden) {
-			qInfo() << QStringLiteral("Update nat policy.");
-			shared_ptr<linphone::Core> core = coreManager->getCore();
-			core->setNatPolicy(core->getNatPolicy());
-		}
-	});
+	// Calls and settings windows are created on first use or preloaded after the first frame.
 	
 	QQuickWindow *mainWindow = getMainWindow();
 	
@@ -1048,14 +1128,70 @@ void App::openAppAfterInit (bool mustBeIconified) {
 #ifndef __APPLE__
 		if (!mustBeIconified)
 			smartShowWindow(mainWindow);
+		handleFirstFrame(mainWindow, !mustBeIconified);
 #else
 		Q_UNUSED(mustBeIconified);
 		smartShowWindow(mainWindow);
+		handleFirstFrame(mainWindow, true);
 #endif
 		setOpened(true);
 	}
 }
 
+// Models restored from a startup snapshot are reconciled with the core only when the user can see something.
+void App::handleFirstFrame (QQuickWindow *mainWindow, bool visible) {
+	mDeferredStep = 0;
+	SipAddressesModel *sipAddressesModel = CoreManager::getInstance()->getSipAddressesModel();
+	const bool fromSnapshot = sipAddressesModel->isSnapshotPending();
+	if (!visible) {
+		QTimer::singleShot(0, sipAddressesModel, &SipAddressesModel::reconcileWithCore);
+		QTimer::singleShot(Constants::SubWindowsPreloadDelay, this, &App::loadDeferredStage);
+		return;
+	}
+	QObject *context = new QObject();
+	// `frameSwapped` can be emitted from the render thread: the connection is queued on `context`.
+	QObject::connect(mainWindow, &QQuickWindow::frameSwapped, context, [this, context, sipAddressesModel, fromSnapshot]() mutable {
+		if (context) {
+			context->deleteLater();
+			context = nullptr;
+			qInfo() << QStringLiteral("First frame of main window displayed in %1 ms (startup snapshot: %2).")
+					   .arg(mStartupTimer.elapsed()).arg(fromSnapshot ? "on" : "off");
+			StartupProfiler::mark("first frame");
+			QTimer::singleShot(0, sipAddressesModel, &SipAddressesModel::reconcileWithCore);
+			QTimer::singleShot(Constants::SubWindowsPreloadDelay, this, &App::loadDeferredStage);
+		}
+	});
+}
+
+// Sub windows and the few models that the main window does not use: loaded one step per iteration of the event loop,
+// to let the main window process its events between them.
+void App::loadDeferredStage () {
+	if (!mEngine)
+		return;
+	switch (mDeferredStep++) {
+		case 0: {
+			StartupProfiler::Stage stage("deferred: models");
+			CoreManager::getInstance()->loadDeferredModels();
+			break;
+		}
+		case 1: {// Not created if the calls window is disabled.
+			StartupProfiler::Stage stage("deferred: calls window");
+			getCallsWindow();
+			break;
+		}
+		case 2: {
+			StartupProfiler::Stage stage("deferred: settings window");
+			getSettingsWindow();
+			mComponentCache->preload({ Constants::QmlViewConfirmDialog, Constants::QmlViewNewConferenceDialog });
+			break;
+		}
+		default:
+			StartupProfiler::report();
+			return;
+	}
+	QTimer::singleShot(0, this, &App::loadDeferredStage);
+}
+
 // -----------------------------------------------------------------------------
 QString App::getStrippedApplicationVersion(){// x.y.z but if 'z-*' then x.y.z-1
 	QString currentVersion = applicationVersion();
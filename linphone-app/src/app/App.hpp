@@ -23,6 +23,8 @@
 
 #include <memory>
 
+#include <QElapsedTimer>
+
 #include "single-application/SingleApplication.hpp"
 
 // =============================================================================
@@ -37,9 +39,11 @@ namespace linphone {
 }
 
 class ColorListModel;
+class ComponentCache;
 class DefaultTranslator;
 class ImageListModel;
 class Notifier;
+class RemoteConfigFetcher;
 
 
 class App : public SingleApplication {
@@ -77,6 +81,10 @@ public:
     return mNotifier;
   }
 
+  ComponentCache *getComponentCache () const {
+    return mComponentCache;
+  }
+
   ColorListModel *getColorListModel () const {
 	return mColorListModel;
 	}
@@ -110,8 +118,9 @@ public:
     exit(RestartCode);
   }
 
-  Q_INVOKABLE QQuickWindow *getCallsWindow () const;
-  Q_INVOKABLE QQuickWindow *getSettingsWindow () const;
+  // Sub windows are created on first use if `create` is set.
+  Q_INVOKABLE QQuickWindow *getCallsWindow (bool create = true);
+  Q_INVOKABLE QQuickWindow *getSettingsWindow (bool create = true);
 
   Q_INVOKABLE static void smartShowWindow (QQuickWindow *window);
   Q_INVOKABLE static void checkForUpdates(bool force = false);
@@ -139,6 +148,9 @@ private:
 
   void initLocale (const std::shared_ptr<linphone::Config> &config);
 
+  std::string getConfigPathIfExists ();
+  void handleRemoteConfigChanged ();
+
   QString getConfigLocale () const;
   void setConfigLocale (const QString &locale);
 
@@ -155,6 +167,10 @@ private:
   void setAutoStart (bool enabled);
 
   void openAppAfterInit (bool mustBeIconified = false);
+  void handleFirstFrame (QQuickWindow *mainWindow, bool visible);
+  void loadDeferredStage ();
+
+  QQuickWindow *createSubWindow (const char *path);
 
   void setOpened (bool status) {
     if (mIsOpened != status) {
@@ -181,6 +197,8 @@ private:
   DefaultTranslator *mTranslator = nullptr;
   DefaultTranslator *mDefaultTranslator = nullptr;
   Notifier *mNotifier = nullptr;
+  ComponentCache *mComponentCache = nullptr;
+  RemoteConfigFetcher *mConfigFetcher = nullptr;
 
   QQuickWindow *mCallsWindow = nullptr;
   QQuickWindow *mSettingsWindow = nullptr;
@@ -191,6 +209,9 @@ private:
   QSystemTrayIcon *mSystemTrayIcon = nullptr;
 
   bool mIsOpened = false;
+
+  QElapsedTimer mStartupTimer;
+  int mDeferredStep = 0;
 };
 
 #endif // APP_H_
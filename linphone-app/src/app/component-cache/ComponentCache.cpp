@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QQmlComponent>
+#include <QQmlEngine>
+#include <QQuickView>
+#include <QScreen>
+#include <QtDebug>
+
+#include "ComponentCache.hpp"
+
+// =============================================================================
+
+static inline QString getPoolKey (const QString &url, const QScreen *screen) {
+  return url + "|" + screen->name();
+}
+
+ComponentCache::ComponentCache (QQmlEngine *engine, QObject *parent) : QObject(parent), mEngine(engine) {
+  // A zero timer is triggered when all pending events are processed.
+  mPreloadTimer.setSingleShot(true);
+  mPreloadTimer.setInterval(0);
+  QObject::connect(&mPreloadTimer, &QTimer::timeout, this, &ComponentCache::compileNext);
+
+  QObject::connect(qApp, &QGuiApplication::screenRemoved, this, &ComponentCache::clearViewPool);
+}
+
+ComponentCache::~ComponentCache () {
+  logStatistics();
+  for (const auto &views : mViewPool)
+    qDeleteAll(views);
+}
+
+// -----------------------------------------------------------------------------
+
+QQmlComponent *ComponentCache::getComponent (const QString &url) {
+  QQmlComponent *component = mComponents.value(url);
+  return component ? component : compile(url);
+}
+
+// Components with errors are kept too: they are not compiled again.
+QQmlComponent *ComponentCache::compile (const QString &url) {
+  QElapsedTimer timer;
+  timer.start();
+  QQmlComponent *component = new QQmlComponent(mEngine, QUrl(url), this);
+  mComponents[url] = component;
+
+  Statistics &statistics = mStatistics[url];
+  statistics.compileTime = timer.elapsed();
+  statistics.asynchronous = false;
+  if (component->isError())
+    qWarning() << QStringLiteral("Unable to compile component `%1`:").arg(url) << component->errors();
+  else
+    qInfo() << QStringLiteral("Component `%1` compiled in %2 ms.").arg(url).arg(statistics.compileTime);
+  return component;
+}
+
+// -----------------------------------------------------------------------------
+
+void ComponentCache::preload (const QString &url) {
+  if (mComponents.contains(url) || mPendingUrls.contains(url))
+    return;
+  mPendingUrls << url;
+  if (!mLoadingComponent)
+    mPreloadTimer.start();
+}
+
+void ComponentCache::preload (const QStringList &urls) {
+  for (const QString &url : urls)
+    preload(url);
+}
+
+void ComponentCache::compileNext () {
+  while (!mPendingUrls.isEmpty() && mComponents.contains(mPendingUrls.first()))
+    mPendingUrls.removeFirst();
+  if (mPendingUrls.isEmpty())
+    return;
+
+  const QString url = mPendingUrls.takeFirst();
+  QElapsedTimer timer;
+  timer.start();
+  QQmlComponent *component = new QQmlComponent(mEngine, this);
+  mLoadingComponent = component;
+  // Can be emitted in `loadUrl` if the type is already loaded.
+  QObject::connect(component, &QQmlComponent::statusChanged, this, [this, component, url, timer](QQmlComponent::Status status) {
+    if (status != QQmlComponent::Loading)
+      handleCompiled(component, url, timer.elapsed());
+  });
+  component->loadUrl(QUrl(url), QQmlComponent::Asynchronous);
+}
+
+void ComponentCache::handleCompiled (QQmlComponent *component, const QString &url, qint64 compileTime) {
+  QObject::disconnect(component, &QQmlComponent::statusChanged, this, nullptr);
+  if (mLoadingComponent == component)
+    mLoadingComponent = nullptr;
+
+  // Requested before the end of the preload: compiled synchronously meanwhile.
+  if (mComponents.contains(url))
+    component->deleteLater();
+  else {
+    mComponents[url] = component;
+    Statistics &statistics = mStatistics[url];
+    statistics.compileTime = compileTime;
+    statistics.asynchronous = true;
+    if (component->isError())
+      qWarning() << QStringLiteral("Unable to preload component `%1`:").arg(url) << component->errors();
+    else
+      qInfo() << QStringLiteral("Component `%1` preloaded in %2 ms.").arg(url).arg(compileTime);
+  }
+
+  if (!mPendingUrls.isEmpty())
+    mPreloadTimer.start();
+}
+
+// -----------------------------------------------------------------------------
+
+QObject *ComponentCache::create (const QString &url) {
+  QQmlComponent *component = getComponent(url);
+  if (component->isError())
+    return nullptr;
+
+  QElapsedTimer timer;
+  timer.start();
+  QObject *object = component->create();
+  if (object) {
+    Statistics &statistics = mStatistics[url];
+    ++statistics.instances;
+    statistics.instantiateTime += timer.elapsed();
+  }
+  return object;
+}
+
+QQuickView *ComponentCache::createView (const QString &url, QScreen *screen) {
+  // The view loads its source from the compiled type of the kept component.
+  getComponent(url);
+
+  QElapsedTimer timer;
+  timer.start();
+  QQuickView *view = new QQuickView(mEngine, nullptr);
+  view->setScreen(screen);
+  view->setSource(QUrl(url));
+
+  Statistics &statistics = mStatistics[url];
+  ++statistics.instances;
+  statistics.instantiateTime += timer.elapsed();
+  return view;
+}
+
+QQuickView *ComponentCache::takeView (const QString &url, QScreen *screen) {
+  QList<QQuickView *> &pool = mViewPool[getPoolKey(url, screen)];
+  while (!pool.isEmpty()) {
+    QQuickView *view = pool.takeLast();
+    if (view->screen() == screen) {
+      ++mStatistics[url].reusedInstances;
+      return view;
+    }
+    view->deleteLater();
+  }
+  return nullptr;
+}
+
+bool ComponentCache::recycleView (const QString &url, QQuickView *view, int maxPooledViews) {
+  QScreen *screen = view->screen();
+  if (!screen || !QGuiApplication::screens().contains(screen))
+    return false;
+
+  QList<QQuickView *> &pool = mViewPool[getPoolKey(url, screen)];
+  if (pool.size() >= maxPooledViews)
+    return false;
+
+  view->hide();
+  pool << view;
+  return true;
+}
+
+int ComponentCache::getPooledViewsCount (const QString &url, QScreen *screen) const {
+  return mViewPool.value(getPoolKey(url, screen)).size();
+}
+
+void ComponentCache::clearViewPool (QScreen *screen) {
+  const QString suffix = "|" + screen->name();
+  for (auto it = mViewPool.begin(); it != mViewPool.end(); )
+    if (it.key().endsWith(suffix)) {
+      for (QQuickView *view : *it)
+        view->deleteLater();
+      it = mViewPool.erase(it);
+    } else
+      ++it;
+}
+
+// -----------------------------------------------------------------------------
+
+void ComponentCache::logStatistics () const {
+  for (auto it = mStatistics.cbegin(); it != mStatistics.cend(); ++it) {
+    const Statistics &statistics = it.value();
+    qInfo() << QStringLiteral("Component `%1`: compiled in %2 ms%3, %4 instance(s) created in %5 ms on average, %6 reused.")
+      .arg(it.key())
+      .arg(statistics.compileTime)
+      .arg(statistics.asynchronous ? QStringLiteral(" (preloaded)") : QString())
+      .arg(statistics.instances)
+      .arg(statistics.instances > 0 ? statistics.instantiateTime / statistics.instances : 0)
+      .arg(statistics.reusedInstances);
+  }
+}
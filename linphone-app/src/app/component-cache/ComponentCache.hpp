@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPONENT_CACHE_H_
+#define COMPONENT_CACHE_H_
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+// =============================================================================
+
+class QQmlComponent;
+class QQmlEngine;
+class QQuickView;
+class QScreen;
+
+// Compiled components shared by notifications, dialogs and windows created from C++.
+// A kept component is never compiled again: views and loaders of the same url only pay the instantiation.
+class ComponentCache : public QObject {
+  Q_OBJECT;
+
+public:
+  ComponentCache (QQmlEngine *engine, QObject *parent = Q_NULLPTR);
+  ~ComponentCache ();
+
+  // Compiled synchronously if it was not preloaded yet.
+  QQmlComponent *getComponent (const QString &url);
+
+  // Compiled asynchronously, one by one, when the event loop is idle.
+  void preload (const QString &url);
+  void preload (const QStringList &urls);
+
+  // Return nullptr on error.
+  QObject *create (const QString &url);
+
+  // Views are bound to a screen. A recycled view is kept hidden until it is taken again.
+  QQuickView *createView (const QString &url, QScreen *screen);
+  QQuickView *takeView (const QString &url, QScreen *screen);// Return nullptr if there is no pooled view.
+  bool recycleView (const QString &url, QQuickView *view, int maxPooledViews);// Return false if the view must be deleted.
+  int getPooledViewsCount (const QString &url, QScreen *screen) const;
+
+  void logStatistics () const;
+
+private:
+  struct Statistics {
+    qint64 compileTime = -1;// In milliseconds.
+    bool asynchronous = false;
+    int instances = 0;
+    int reusedInstances = 0;
+    qint64 instantiateTime = 0;// Sum, in milliseconds.
+  };
+
+  QQmlComponent *compile (const QString &url);
+  void compileNext ();
+  void handleCompiled (QQmlComponent *component, const QString &url, qint64 compileTime);
+  void clearViewPool (QScreen *screen);
+
+  QQmlEngine *mEngine = nullptr;
+  QHash<QString, QQmlComponent *> mComponents;
+  QHash<QString, Statistics> mStatistics;
+
+  QStringList mPendingUrls;
+  QQmlComponent *mLoadingComponent = nullptr;
+  QTimer mPreloadTimer;
+
+  QHash<QString, QList<QQuickView *>> mViewPool;// By url and screen name.
+};
+
+#endif // COMPONENT_CACHE_H_
@@ -201,6 +201,10 @@ string Paths::getCallHistoryFilePath () {
 	return getWritableFilePath(getAppCallHistoryFilePath());
 }
 
+string Paths::getCallQualityArchiveFilePath () {
+	return getReadableFilePath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathCallQualityArchive);
+}
+
 string Paths::getCapturesDirPath () {
 	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + Constants::PathCaptures);
 }
@@ -255,6 +259,10 @@ string Paths::getLogsDirPath () {
 	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathLogs);
 }
 
+string Paths::getOutgoingImagesDirPath () {
+	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathOutgoingImages);
+}
+
 string Paths::getMessageHistoryFilePath () {
 	return getReadableFilePath(getAppMessageHistoryFilePath());// No need to ensure that the file exists as this DB is deprecated
 }
@@ -294,9 +302,17 @@ string Paths::getRootCaFilePath () {
 	return getReadableFilePath(getAppRootCaFilePath());
 }
 
+string Paths::getSipAddressesSnapshotFilePath () {
+	return getReadableFilePath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathSipAddressesSnapshot);
+}
+
 string Paths::getThumbnailsDirPath () {
 	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathThumbnails);
 }
+
+string Paths::getTransfersQueueFilePath () {
+	return getReadableFilePath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathTransfersQueue);
+}
 string Paths::getToolsDirPath () {
 	return getWritableDirPath(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + Constants::PathTools);
 }
@@ -32,6 +32,7 @@ namespace Paths {
 	std::string getAssistantConfigDirPath ();
 	std::string getAvatarsDirPath ();
 	std::string getCallHistoryFilePath ();
+	std::string getCallQualityArchiveFilePath ();
 	std::string getCapturesDirPath ();
 	std::string getCodecsDirPath ();
 	std::string getConfigDirPath (bool writable = true);
@@ -43,6 +44,7 @@ namespace Paths {
 	std::string getLimeDatabasePath ();
 	std::string getLogsDirPath ();
 	std::string getMessageHistoryFilePath ();
+	std::string getOutgoingImagesDirPath ();
 	std::string getPackageDataDirPath ();
 	std::string getPackageMsPluginsDirPath ();
 	std::string getPackagePluginsAppDirPath ();
@@ -51,7 +53,9 @@ namespace Paths {
 	std::string getPluginsAppDirPath ();
 	QStringList getPluginsAppFolders();
 	std::string getRootCaFilePath ();
+	std::string getSipAddressesSnapshotFilePath ();
 	std::string getThumbnailsDirPath ();
+	std::string getTransfersQueueFilePath ();
 	std::string getToolsDirPath ();
 	std::string getUserCertificatesDirPath ();
 	std::string getZrtpDataFilePath ();
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <QTextStream>
+#include <QtDebug>
+
+#include "StartupProfiler.hpp"
+
+// =============================================================================
+
+#ifdef ENABLE_STARTUP_ALLOCATIONS_PROFILING
+
+namespace {
+  std::atomic<bool> gCountAllocations(false);
+  std::atomic<quint64> gAllocations(0);
+}
+
+// Count the allocations while profiling. The replacement is global, it is only a counter in front of malloc.
+// On Linux, it is also used by the shared libraries. On macOS and Windows, only the allocations of the app are counted.
+void *operator new (std::size_t size) {
+  if (gCountAllocations.load(std::memory_order_relaxed))
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (size == 0)
+    size = 1;
+  for (;;) {
+    if (void *ptr = std::malloc(size))
+      return ptr;
+    std::new_handler handler = std::get_new_handler();
+    if (!handler)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void *operator new[] (std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete (void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[] (void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete (void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[] (void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+static constexpr bool CountAllocations = true;
+
+static void setCountAllocations (bool enabled) {
+  gCountAllocations = enabled;
+}
+
+static quint64 getAllocations () {
+  return gAllocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+static constexpr bool CountAllocations = false;
+
+static void setCountAllocations (bool) {}
+
+static quint64 getAllocations () {
+  return 0;
+}
+
+#endif // ifdef ENABLE_STARTUP_ALLOCATIONS_PROFILING
+
+// -----------------------------------------------------------------------------
+
+bool StartupProfiler::mEnabled = false;
+qint64 StartupProfiler::mOffset = 0;
+QElapsedTimer StartupProfiler::mTimer;
+QVector<StartupProfiler::StageData> StartupProfiler::mStages;
+
+void StartupProfiler::enable (qint64 elapsedSinceStart) {
+  if (mEnabled)
+    return;
+  mEnabled = true;
+  mOffset = elapsedSinceStart;
+  mTimer.start();
+  setCountAllocations(true);
+}
+
+qint64 StartupProfiler::elapsed () {
+  return mOffset + mTimer.elapsed();
+}
+
+// -----------------------------------------------------------------------------
+
+void StartupProfiler::start (const char *name) {
+  if (!mEnabled)
+    return;
+  const quint64 allocations = getAllocations();
+  mStages.append({ QString::fromLatin1(name), elapsed(), -1, allocations, allocations });
+}
+
+void StartupProfiler::stop (const char *name) {
+  if (!mEnabled)
+    return;
+  const QString stageName = QString::fromLatin1(name);
+  for (int i = mStages.count() - 1; i >= 0; --i) {
+    StageData &stage = mStages[i];
+    if (stage.end < 0 && stage.name == stageName) {
+      stage.end = elapsed();
+      stage.endAllocations = getAllocations();
+      return;
+    }
+  }
+  qWarning() << QStringLiteral("Startup stage not started: `%1`.").arg(stageName);
+}
+
+void StartupProfiler::mark (const char *name) {
+  start(name);
+  stop(name);
+}
+
+// -----------------------------------------------------------------------------
+
+void StartupProfiler::report () {
+  if (!mEnabled)
+    return;
+  mEnabled = false;
+  setCountAllocations(false);
+
+  QString text;
+  QTextStream stream(&text);
+  if (CountAllocations)
+    stream << QStringLiteral("Startup profile (%1 ms, %2 allocations):\n").arg(elapsed()).arg(getAllocations());
+  else
+    stream << QStringLiteral("Startup profile (%1 ms, allocations not counted in this build):\n").arg(elapsed());
+  stream << QStringLiteral("%1 %2 %3 %4\n")
+    .arg("stage", -32).arg("start (ms)", 12).arg("time (ms)", 12).arg("allocations", 12);
+  for (const StageData &stage : mStages) {
+    const bool finished = stage.end >= 0;
+    stream << QStringLiteral("%1 %2 %3 %4\n")
+      .arg(stage.name, -32)
+      .arg(stage.start, 12)
+      .arg(finished ? QString::number(stage.end - stage.start) : QStringLiteral("-"), 12)
+      .arg(finished && CountAllocations ? QString::number(stage.endAllocations - stage.startAllocations) : QStringLiteral("-"), 12);
+  }
+  stream.flush();
+  mStages.clear();
+
+  qInfo().noquote() << text;
+  QTextStream out(stdout);
+  out << text;
+  out.flush();
+}
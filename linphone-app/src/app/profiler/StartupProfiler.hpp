@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STARTUP_PROFILER_H_
+#define STARTUP_PROFILER_H_
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+// =============================================================================
+
+// Wall time and allocation count of the startup stages, enabled with `--profile-startup`.
+// The report is written when the deferred stage is over. Allocations are only counted in builds with
+// ENABLE_STARTUP_ALLOCATIONS_PROFILING (see StartupProfiler.cpp for what is counted).
+class StartupProfiler {
+public:
+  // Profile the current scope.
+  class Stage {
+  public:
+    Stage (const char *name) : mName(name) {
+      StartupProfiler::start(name);
+    }
+
+    ~Stage () {
+      StartupProfiler::stop(mName);
+    }
+
+  private:
+    const char *mName;
+  };
+
+  static void enable (qint64 elapsedSinceStart);// In milliseconds.
+  static bool isEnabled () {
+    return mEnabled;
+  }
+
+  static void start (const char *name);
+  static void stop (const char *name);
+  static void mark (const char *name);// An instant, like the first frame.
+
+  static void report ();
+
+private:
+  struct StageData {
+    QString name;
+    qint64 start;
+    qint64 end;
+    quint64 startAllocations;
+    quint64 endAllocations;
+  };
+
+  static qint64 elapsed ();
+
+  static bool mEnabled;
+  static qint64 mOffset;
+  static QElapsedTimer mTimer;
+  static QVector<StageData> mStages;
+};
+
+#endif // STARTUP_PROFILER_H_
@@ -19,6 +19,7 @@
  */
 
 #include "app/paths/Paths.hpp"
+#include "utils/DecodedImageCache.hpp"
 #include "utils/Utils.hpp"
 
 #include "AvatarProvider.hpp"
@@ -34,8 +35,8 @@ AvatarProvider::AvatarProvider () : QQuickImageProvider(
   mAvatarsPath = Utils::coreStringToAppString(Paths::getAvatarsDirPath());
 }
 
-QImage AvatarProvider::requestImage (const QString &id, QSize *size, const QSize &) {
-  QImage image(mAvatarsPath + id);
+QImage AvatarProvider::requestImage (const QString &id, QSize *size, const QSize &requestedSize) {
+  QImage image = DecodedImageCache::getImage(mAvatarsPath + id, requestedSize);
   *size = image.size();
   return image;
 }
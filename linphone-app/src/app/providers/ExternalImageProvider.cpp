@@ -18,13 +18,10 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "app/paths/Paths.hpp"
-#include "utils/Utils.hpp"
+#include "utils/DecodedImageCache.hpp"
 
 #include "ExternalImageProvider.hpp"
 
-#include <QImageReader>
-
 // =============================================================================
 
 const QString ExternalImageProvider::ProviderId = "external";
@@ -35,8 +32,8 @@ ExternalImageProvider::ExternalImageProvider () : QQuickImageProvider(
 ) {
 }
 
-QImage ExternalImageProvider::requestImage (const QString &id, QSize *size, const QSize &) {
-  QImage image(Utils::getImage(id));
+QImage ExternalImageProvider::requestImage (const QString &id, QSize *size, const QSize &requestedSize) {
+  QImage image = DecodedImageCache::getImage(id, requestedSize);
   *size = image.size();
   return image;
 }
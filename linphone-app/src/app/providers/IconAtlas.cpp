@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCache>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QRect>
+#include <QTextStream>
+#include <QtDebug>
+
+#include "IconAtlas.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr char PagePath[] = ":/assets/icons-atlas-%1.png";
+	constexpr char IndexPath[] = ":/assets/icons-atlas.index";
+	
+	// Decoded pages, in bytes. Usually only one or two sizes are displayed at a time.
+	constexpr int MaxPagesCost = 8 * 1024 * 1024;
+	
+	struct Entry {
+		int page;
+		QRect rect;
+		QString colorName;// Empty if the icon is not tinted.
+		QPoint maskPosition;
+	};
+	
+	QMutex Mutex;
+	bool Loaded = false;
+	QCache<int, QImage> Pages(MaxPagesCost);
+	QHash<QString, Entry> Entries;// "id|width|height" => rect in page.
+	QHash<QString, QSize> DefaultSizes;
+}
+
+static QString getKey (const QString &id, const QSize &size) {
+	return QStringLiteral("%1|%2|%3").arg(id).arg(size.width()).arg(size.height());
+}
+
+// Must be called with the mutex locked. Only the index is read here, pages are decoded on demand.
+void IconAtlas::load () {
+	if (Loaded)
+		return;
+	Loaded = true;
+	
+	QFile file(IndexPath);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;// Built without atlas.
+	
+	QTextStream stream(&file);
+	while (!stream.atEnd()) {
+		const QStringList fields = stream.readLine().split(' ');
+		if (fields.size() == 3 && fields[0].startsWith('@'))
+			DefaultSizes[fields[0].mid(1)] = QSize(fields[1].toInt(), fields[2].toInt());
+		else if (fields.size() == 6 || fields.size() == 9) {
+			const QRect rect(fields[2].toInt(), fields[3].toInt(), fields[4].toInt(), fields[5].toInt());
+			Entry entry{ fields[1].toInt(), rect, QString(), QPoint() };
+			if (fields.size() == 9) {
+				entry.colorName = fields[6];
+				entry.maskPosition = QPoint(fields[7].toInt(), fields[8].toInt());
+			}
+			Entries[getKey(fields[0], rect.size())] = entry;
+		}
+	}
+	qInfo() << QStringLiteral("Icon atlas index loaded: %1 images.").arg(Entries.size());
+}
+
+// Must be called with the mutex locked.
+QImage *IconAtlas::getPage (int page) {
+	QImage *image = Pages.object(page);
+	if (image)
+		return image;
+	
+	const QString path = QString(PagePath).arg(page);
+	image = new QImage(path);
+	if (image->isNull()) {
+		qWarning() << QStringLiteral("Unable to load icon atlas page: `%1`.").arg(path);
+		delete image;
+		return nullptr;
+	}
+	Pages.insert(page, image, qMin(image->width() * image->height() * 4, MaxPagesCost));
+	return Pages.object(page);
+}
+
+// The icon is rendered with black instead of the color: add the color weighted by the mask.
+static void tint (QImage &image, const QImage &mask, const QColor &color) {
+	image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+	for (int y = 0; y < image.height(); ++y) {
+		QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+		const QRgb *maskLine = reinterpret_cast<const QRgb *>(mask.constScanLine(y));
+		for (int x = 0; x < image.width(); ++x) {
+			const int weight = qAlpha(maskLine[x]);
+			if (!weight)
+				continue;
+			const int alpha = qAlpha(line[x]);
+			line[x] = qRgba(
+				qMin(alpha, qRed(line[x]) + weight * color.red() / 255),
+				qMin(alpha, qGreen(line[x]) + weight * color.green() / 255),
+				qMin(alpha, qBlue(line[x]) + weight * color.blue() / 255),
+				alpha
+			);
+		}
+	}
+}
+
+QImage IconAtlas::getImage (const QString &id, const QSize &size, const std::function<QColor(const QString &)> &getColor) {
+	QImage image, mask;
+	QString colorName;
+	{
+		QMutexLocker locker(&Mutex);
+		load();
+		auto it = Entries.find(getKey(id, size));
+		if (it == Entries.end())
+			return QImage();
+		const QImage *page = getPage(it->page);
+		const QRect maskRect(it->maskPosition, it->rect.size());
+		if (!page || !page->rect().contains(it->rect) || (!it->colorName.isEmpty() && !page->rect().contains(maskRect)))
+			return QImage();
+		image = page->copy(it->rect);
+		colorName = it->colorName;
+		if (!colorName.isEmpty())
+			mask = page->copy(maskRect);
+	}
+	if (colorName.isEmpty())
+		return image;
+	
+	const QColor color = getColor(colorName);
+	if (!color.isValid())
+		return QImage();
+	tint(image, mask, color);
+	return image;
+}
+
+QSize IconAtlas::getDefaultSize (const QString &id) {
+	QMutexLocker locker(&Mutex);
+	load();
+	return DefaultSizes.value(id);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ICON_ATLAS_H_
+#define ICON_ATLAS_H_
+
+#include <functional>
+
+#include <QColor>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// =============================================================================
+
+// Internal icons pre-rendered at build time (see tools/icon-atlas).
+// Icons are available at the sizes given to the generator and at their default size. Thread-safe.
+// The atlas is split in one page per size: only the pages of the requested sizes are decoded, in a bounded cache.
+// Icons using a theme color are stored with a mask and tinted when fetched.
+class IconAtlas {
+public:
+	// Null image if the icon is not in the atlas at this size, or if its color is unknown.
+	static QImage getImage (const QString &id, const QSize &size, const std::function<QColor(const QString &)> &getColor);
+	// Size of the svg document. Invalid if the icon is not in the atlas.
+	static QSize getDefaultSize (const QString &id);
+	
+private:
+	IconAtlas () = delete;
+	
+	static void load ();
+	static QImage *getPage (int page);
+};
+
+#endif // ICON_ATLAS_H_
@@ -27,6 +27,7 @@
 
 #include "app/App.hpp"
 
+#include "IconAtlas.hpp"
 #include "ImageProvider.hpp"
 #include "components/other/colors/ColorListModel.hpp"
 #include "components/other/colors/ColorModel.hpp"
@@ -249,6 +250,22 @@ QImage ImageProvider::requestImage (const QString &id, QSize *size, const QSize
 	if(!model)
 		return QImage();
 	const QString path = model->getPath();
+	
+	// 0. Use the pre-rendered icon if the image is not overridden.
+	if (path == QStringLiteral(":/assets/images/%1.svg").arg(id)) {
+		const ColorListModel *colors = App::getInstance()->getColorListModel();
+		QImage image = IconAtlas::getImage(id, !requestedSize.isEmpty()
+			? requestedSize
+			: IconAtlas::getDefaultSize(id) * QGuiApplication::primaryScreen()->devicePixelRatio(),
+			[colors](const QString &colorName) {
+				const QVariant colorValue = colors->getQmlData()->value(colorName);
+				return colorValue.isValid() ? QColor(colorValue.value<ColorModel*>()->getColor().rgb()) : QColor();// Alpha is ignored, as in svg rendering.
+			});
+		if (!image.isNull()) {
+			*size = image.size();
+			return image;
+		}
+	}
 	//qDebug() << QStringLiteral("Image `%1` requested with size: (%2, %3).")
 		//		.arg(path).arg(requestedSize.width()).arg(requestedSize.height());
 	
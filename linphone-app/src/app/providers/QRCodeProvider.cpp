@@ -18,6 +18,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QCache>
 #include <QElapsedTimer>
 #include <QFileInfo>
 #include <QPainter>
@@ -27,6 +28,7 @@
 #include <QByteArray>
 #include <QBuffer>
 #include <QImageReader>
+#include <QMutex>
 #include "app/App.hpp"
 
 #include "QRCodeProvider.hpp"
@@ -41,32 +43,80 @@
 
 using namespace std;
 
+namespace {
+	constexpr int CacheSize = 16;
+
+	QMutex Mutex;
+	QCache<QString, QImage> Images(CacheSize);
+}
+
 const QString QRCodeProvider::ProviderId = "qrcode";
 
-QRCodeProvider::QRCodeProvider () : QQuickImageProvider(
-									  QQmlImageProviderBase::Image,
-									  QQmlImageProviderBase::ForceAsynchronousImageLoading
-									  ) {}
+QRCodeRunnable::QRCodeRunnable (const QString &id, const QSize &requestedSize, const shared_ptr<atomic_bool> &canceled) :
+	mId(id), mRequestedSize(requestedSize), mCanceled(canceled) {
+}
+
+void QRCodeRunnable::run () {
+	if (!*mCanceled)
+		emit imageReady(QRCodeProvider::getImage(mId, mRequestedSize));
+}
+
+// -----------------------------------------------------------------------------
+
+QRCodeResponse::QRCodeResponse (const QString &id, const QSize &requestedSize, QThreadPool *pool) :
+	mCanceled(make_shared<atomic_bool>(false)) {
+	QRCodeRunnable *runnable = new QRCodeRunnable(id, requestedSize, mCanceled);
+	// Queued to this response: the connection is removed if the response is deleted before.
+	QObject::connect(runnable, &QRCodeRunnable::imageReady, this, [this](const QImage &image) {
+		if (*mCanceled)
+			return;
+		mImage = image;
+		emit finished();
+	}, Qt::QueuedConnection);
+	pool->start(runnable);
+}
+
+QQuickTextureFactory *QRCodeResponse::textureFactory () const {
+	return QQuickTextureFactory::textureFactoryForImage(mImage);
+}
+
+void QRCodeResponse::cancel () {
+	if (mCanceled->exchange(true))
+		return;
+	emit finished();// Let the engine release the response.
+}
 
 // -----------------------------------------------------------------------------
 
-QImage QRCodeProvider::requestImage (const QString &id, QSize *size, const QSize &requestedSize) {
+QRCodeProvider::QRCodeProvider () {
+	mPool.setMaxThreadCount(1);
+}
+
+QQuickImageResponse *QRCodeProvider::requestImageResponse (const QString &id, const QSize &requestedSize) {
+	return new QRCodeResponse(id, requestedSize, &mPool);
+}
+
+QImage QRCodeProvider::getImage (const QString &id, const QSize &requestedSize) {
 	unsigned int w = requestedSize.width()>0?requestedSize.width() : 100;
 	unsigned int h = requestedSize.height()>0 ? requestedSize.height() : 100;
+	const QString key = QStringLiteral("%1x%2/%3").arg(w).arg(h).arg(id);
+	{
+		QMutexLocker locker(&Mutex);
+		QImage *image = Images.object(key);
+		if (image)
+			return *image;
+	}
 	auto content = linphone::Factory::get()->createQrcode(id.toStdString(), w, h, 0);
 	if( !content)
 		return QImage();
 	QImage image(w, h, QImage::Format_Indexed8);
-    for (int y = 0;y<h; y++)
+    for (unsigned int y = 0;y<h; y++)
     	memcpy(image.scanLine(y), content->getBuffer() + y*w, w);
 	QVector<QRgb> colorTable(256);
     for(int i=0;i<256;i++)
     	colorTable[i] = qRgb(i,i,i);
     image.setColorTable(colorTable);
-	*size = image.size();
+	QMutexLocker locker(&Mutex);
+	Images.insert(key, new QImage(image));
 	return image;
 }
-
-QPixmap QRCodeProvider::requestPixmap (const QString &id, QSize *size, const QSize &requestedSize) {
-	return QPixmap::fromImage(requestImage(id, size, requestedSize));
-}
@@ -21,19 +21,59 @@
 #ifndef QRCODE_PROVIDER_H_
 #define QRCODE_PROVIDER_H_
 
-#include <QQuickImageProvider>
+#include <atomic>
+#include <memory>
+
+#include <QQuickAsyncImageProvider>
+#include <QRunnable>
+#include <QThreadPool>
 
 // =============================================================================
 
-class QRCodeProvider : public QQuickImageProvider {
+// Generate the QR code in the pool. Deleted by the pool after `run()`: it does not depend on the
+// response, which can be deleted by the engine at any time. The image is given back with a queued signal.
+class QRCodeRunnable : public QObject, public QRunnable {
+  Q_OBJECT
+
+public:
+  QRCodeRunnable (const QString &id, const QSize &requestedSize, const std::shared_ptr<std::atomic_bool> &canceled);
+
+  void run () override;
+
+signals:
+  void imageReady (const QImage &image);
+
+private:
+  QString mId;
+  QSize mRequestedSize;
+  std::shared_ptr<std::atomic_bool> mCanceled;
+};
+
+class QRCodeResponse : public QQuickImageResponse {
+public:
+  QRCodeResponse (const QString &id, const QSize &requestedSize, QThreadPool *pool);
+
+  QQuickTextureFactory *textureFactory () const override;
+  void cancel () override;
+
+private:
+  QImage mImage;
+  std::shared_ptr<std::atomic_bool> mCanceled;
+};
+
+class QRCodeProvider : public QQuickAsyncImageProvider {
 public:
   QRCodeProvider ();
 
-  QImage requestImage (const QString &id, QSize *size, const QSize &requestedSize) override;
-  QPixmap requestPixmap (const QString &id, QSize *size, const QSize &requestedSize) override;
+  QQuickImageResponse *requestImageResponse (const QString &id, const QSize &requestedSize) override;
+
+  // Memoized by payload and size.
+  static QImage getImage (const QString &id, const QSize &requestedSize);
 
   static const QString ProviderId;
 
+private:
+  QThreadPool mPool;
 };
 
 #endif // AVATAR_PROVIDER_H_
@@ -18,8 +18,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "app/paths/Paths.hpp"
-#include "utils/Utils.hpp"
+#include "utils/ThumbnailStore.hpp"
 
 #include "ThumbnailProvider.hpp"
 
@@ -30,12 +29,10 @@ const QString ThumbnailProvider::ProviderId = "thumbnail";
 ThumbnailProvider::ThumbnailProvider () : QQuickImageProvider(
   QQmlImageProviderBase::Image,
   QQmlImageProviderBase::ForceAsynchronousImageLoading
-) {
-  mThumbnailsPath = Utils::coreStringToAppString(Paths::getThumbnailsDirPath());
-}
+) {}
 
-QImage ThumbnailProvider::requestImage (const QString &id, QSize *size, const QSize &) {
-  QImage image(mThumbnailsPath + id);
+QImage ThumbnailProvider::requestImage (const QString &id, QSize *size, const QSize &requestedSize) {
+  QImage image = ThumbnailStore::getImage(id, requestedSize);
   *size = image.size();
   return image;
 }
@@ -24,6 +24,8 @@
 #include "assistant/AssistantModel.hpp"
 #include "authentication/AuthenticationNotifier.hpp"
 #include "call/CallModel.hpp"
+#include "call/CallQualityArchive.hpp"
+#include "call/CallStatsModel.hpp"
 #include "calls/CallsListModel.hpp"
 #include "calls/CallsListProxyModel.hpp"
 #include "camera/Camera.hpp"
@@ -54,10 +56,12 @@
 #include "core/CoreManager.hpp"
 #include "file/FileDownloader.hpp"
 #include "file/FileExtractor.hpp"
+#include "file/RemoteConfigFetcher.hpp"
 #include "history/HistoryProxyModel.hpp"
 #include "ldap/LdapModel.hpp"
 #include "ldap/LdapListModel.hpp"
 #include "ldap/LdapProxyModel.hpp"
+#include "level-meter/AudioLevelMeter.hpp"
 #include "notifier/Notifier.hpp"
 #include "participant/ParticipantListModel.hpp"
 #include "participant/ParticipantModel.hpp"
@@ -83,6 +87,8 @@
 #include "timeline/TimelineModel.hpp"
 #include "timeline/TimelineProxyModel.hpp"
 #include "timeline/TimelineListModel.hpp"
+#include "transfer/TransferModel.hpp"
+#include "transfer/TransferScheduler.hpp"
 #include "tunnel/TunnelModel.hpp"
 #include "tunnel/TunnelConfigModel.hpp"
 #include "tunnel/TunnelConfigListModel.hpp"
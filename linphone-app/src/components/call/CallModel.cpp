@@ -26,6 +26,8 @@
 
 #include "app/App.hpp"
 #include "CallListener.hpp"
+#include "CallQualityArchive.hpp"
+#include "CallStatsModel.hpp"
 #include "components/calls/CallsListModel.hpp"
 #include "components/chat-room/ChatRoomInitializer.hpp"
 #include "components/chat-room/ChatRoomListener.hpp"
@@ -61,6 +63,8 @@ CallModel::CallModel (shared_ptr<linphone::Call> call){
 	SettingsModel *settings = coreManager->getSettingsModel();
 	
 	connect(this, &CallModel::callIdChanged, this, &CallModel::chatRoomModelChanged);// When the call Id change, the chat room change.
+	mAudioStatsModel = new CallStatsModel(this);
+	mVideoStatsModel = new CallStatsModel(this);
 	mCall = call;
 	if(mCall)
 		mCall->setData("call-model", *this);
@@ -109,6 +113,7 @@ CallModel::CallModel (shared_ptr<linphone::Call> call){
 
 	if(mCall) {
 		mRemoteAddress = mCall->getRemoteAddress()->clone();
+		mRemoteAddressHandle = SipAddressCache::getHandle(mRemoteAddress);
 		if(mCall->getConference())
 			mConferenceModel = ConferenceModel::create(mCall->getConference());
 		auto conferenceInfo = CoreManager::getInstance()->getCore()->findConferenceInformationFromUri(getConferenceAddress());
@@ -275,11 +280,12 @@ void CallModel::updateStats (const shared_ptr<const linphone::CallStats> &callSt
 			break;
 			
 		case linphone::StreamType::Audio:
-			updateStats(callStats, mAudioStats);
-			updateEncrypionStats(callStats, mEncryptionStats);
+			mAudioCallStats = callStats;
+			mAudioStatsModel->addSample(callStats, mCall ? mCall->getCurrentParams() : nullptr, mCall ? mCall->getCurrentQuality() : -1);
 			break;
 		case linphone::StreamType::Video:
-			updateStats(callStats, mVideoStats);
+			mVideoCallStats = callStats;
+			mVideoStatsModel->addSample(callStats, mCall ? mCall->getCurrentParams() : nullptr, mCall ? mCall->getCurrentQuality() : -1);
 			break;
 	}
 	
@@ -472,6 +478,7 @@ void CallModel::handleCallStateChanged (const shared_ptr<linphone::Call> &call,
 			setCallErrorFromReason(call->getReason());
 			stopAutoAnswerTimer();
 			stopRecording();
+			archiveQuality();
 			mPausedByRemote = false;
 			break;
 			
@@ -996,6 +1003,10 @@ std::shared_ptr<linphone::Address> CallModel::getRemoteAddress()const{
 	return mRemoteAddress;
 }
 
+SipAddressHandle CallModel::getRemoteAddressHandle()const{
+	return mRemoteAddressHandle;
+}
+
 LinphoneEnums::ConferenceLayout CallModel::getConferenceVideoLayout() const{
 	return mConferenceVideoLayout;
 //	return mCall ? LinphoneEnums::fromLinphone(mCall->getParams()->getConferenceVideoLayout()) : LinphoneEnums::ConferenceLayoutGrid;
@@ -1102,16 +1113,44 @@ QString CallModel::getSecuredString (const shared_ptr<const linphone::CallStats>
 
 // -----------------------------------------------------------------------------
 
+// Only calls that had media are archived.
+void CallModel::archiveQuality () {
+	if (mQualityArchived || !mCall || mAudioStatsModel->rowCount() == 0)
+		return;
+	mQualityArchived = true;
+	
+	auto callLog = mCall->getCallLog();
+	QJsonObject record;
+	record["callId"] = Utils::coreStringToAppString(callLog->getCallId());
+	record["peer"] = getPeerAddress();
+	record["outgoing"] = isOutgoing();
+	record["start"] = qint64(callLog->getStartDate()) * 1000;
+	record["duration"] = mCall->getDuration();
+	record["averageQuality"] = mCall->getAverageQuality();
+	record["audio"] = mAudioStatsModel->toJson();
+	if (mVideoStatsModel->rowCount() > 0)
+		record["video"] = mVideoStatsModel->toJson();
+	CoreManager::getInstance()->getCallQualityArchive()->append(record);
+}
+
 QVariantList CallModel::getAudioStats () const {
-	return mAudioStats;
+	return formatStats(mAudioCallStats);
 }
 
 QVariantList CallModel::getVideoStats () const {
-	return mVideoStats;
+	return formatStats(mVideoCallStats);
 }
 
 QVariantList CallModel::getEncryptionStats () const {
-	return mEncryptionStats;
+	return formatEncryptionStats(mAudioCallStats);
+}
+
+CallStatsModel *CallModel::getAudioStatsModel () const {
+	return mAudioStatsModel;
+}
+
+CallStatsModel *CallModel::getVideoStatsModel () const {
+	return mVideoStatsModel;
 }
 
 // -----------------------------------------------------------------------------
@@ -1123,8 +1162,9 @@ static inline QVariantMap createStat (const QString &key, const QString &value)
 	return m;
 }
 
-void CallModel::updateStats (const shared_ptr<const linphone::CallStats> &callStats, QVariantList &statsList) {
-	if(mCall){
+QVariantList CallModel::formatStats (const shared_ptr<const linphone::CallStats> &callStats) const {
+	QVariantList statsList;
+	if(mCall && callStats){
 		shared_ptr<const linphone::CallParams> params = mCall->getCurrentParams();
 		shared_ptr<const linphone::PayloadType> payloadType;
 		
@@ -1136,7 +1176,7 @@ void CallModel::updateStats (const shared_ptr<const linphone::CallStats> &callSt
 				payloadType = params->getUsedVideoPayloadType();
 				break;
 			default:
-				return;
+				return statsList;
 		}
 		
 		QString family;
@@ -1152,8 +1192,6 @@ void CallModel::updateStats (const shared_ptr<const linphone::CallStats> &callSt
 				break;
 		}
 		
-		statsList.clear();
-		
 		statsList << createStat(tr("callStatsCodec"), payloadType
 								? QStringLiteral("%1 / %2kHz").arg(Utils::coreStringToAppString(payloadType->getMimeType())).arg(payloadType->getClockRate() / 1000)
 								: QString(""));
@@ -1196,10 +1234,11 @@ void CallModel::updateStats (const shared_ptr<const linphone::CallStats> &callSt
 				break;
 		}
 	}
+	return statsList;
 }
-void CallModel::updateEncrypionStats (const shared_ptr<const linphone::CallStats> &callStats, QVariantList &statsList) {
-	if( callStats->getType() == linphone::StreamType::Audio) {// just in case
-		statsList.clear();
+QVariantList CallModel::formatEncryptionStats (const shared_ptr<const linphone::CallStats> &callStats) const {
+	QVariantList statsList;
+	if(mCall && callStats && callStats->getType() == linphone::StreamType::Audio) {// just in case
 		if(isSecured()) {
 		//: 'Media encryption' : label in encryption section of call statistics
 			statsList << createStat(tr("callStatsMediaEncryption"), getSecuredString(callStats));
@@ -1217,6 +1256,7 @@ void CallModel::updateEncrypionStats (const shared_ptr<const linphone::CallStats
 			}
 		}
 	}
+	return statsList;
 }
 
 
@@ -27,9 +27,11 @@
 #include "../search/SearchListener.hpp"
 
 #include "utils/LinphoneEnums.hpp"
+#include "utils/SipAddressCache.hpp"
 
 // =============================================================================
 class CallListener;
+class CallStatsModel;
 class ConferenceInfoModel;
 class ConferenceModel;
 class ContactModel;
@@ -79,9 +81,13 @@ class CallModel : public QObject {
 
 	Q_PROPERTY(bool snapshotEnabled READ getSnapshotEnabled NOTIFY snapshotEnabledChanged)	// Grid doesn't enable snapshot
 	
+	// Formatted on read: bind them only while the statistics are displayed.
 	Q_PROPERTY(QVariantList audioStats READ getAudioStats NOTIFY statsUpdated)
 	Q_PROPERTY(QVariantList videoStats READ getVideoStats NOTIFY statsUpdated)
 	Q_PROPERTY(QVariantList encryptionStats READ getEncryptionStats NOTIFY statsUpdated)
+	// Numeric history of the statistics.
+	Q_PROPERTY(CallStatsModel *audioStatsModel READ getAudioStatsModel CONSTANT)
+	Q_PROPERTY(CallStatsModel *videoStatsModel READ getVideoStatsModel CONSTANT)
 	
 	Q_PROPERTY(CallEncryption encryption READ getEncryption NOTIFY securityUpdated)
 	Q_PROPERTY(bool isSecured READ isSecured NOTIFY securityUpdated)
@@ -130,6 +136,8 @@ public:
 	ContactModel *getContactModel() const;
 	ChatRoomModel * getChatRoomModel();
 	ConferenceModel* getConferenceModel();
+	CallStatsModel *getAudioStatsModel () const;
+	CallStatsModel *getVideoStatsModel () const;
 	ConferenceInfoModel* getConferenceInfoModel();
 	QSharedPointer<ConferenceModel> getConferenceSharedModel();
 	
@@ -178,6 +186,7 @@ public:
 	static void prepareTransfert(std::shared_ptr<linphone::Call> call, const QString& transfertAddress);
 	
 	std::shared_ptr<linphone::Address> getRemoteAddress()const;
+	SipAddressHandle getRemoteAddressHandle()const;// Cheap to compare.
 	
 	LinphoneEnums::ConferenceLayout getConferenceVideoLayout() const;
 	void changeConferenceVideoLayout(LinphoneEnums::ConferenceLayout layout);	// Make a call request
@@ -189,6 +198,7 @@ public:
 	std::shared_ptr<CallListener> mCallListener;	// This is passed to linpĥone object and must be in shared_ptr
 	std::shared_ptr<linphone::ChatRoom> mChatRoom;	// Used chat room for the call.
 	std::shared_ptr<linphone::Address> mRemoteAddress;
+	SipAddressHandle mRemoteAddressHandle;
 	std::shared_ptr<linphone::MagicSearch> mMagicSearch;
 	
 public slots:
@@ -288,8 +298,9 @@ public:
 	QVariantList getAudioStats () const;
 	QVariantList getVideoStats () const;
 	QVariantList getEncryptionStats () const;
-	void updateStats (const std::shared_ptr<const linphone::CallStats> &callStats, QVariantList &statsList);
-	void updateEncrypionStats (const std::shared_ptr<const linphone::CallStats> &callStats, QVariantList &statsList);
+	QVariantList formatStats (const std::shared_ptr<const linphone::CallStats> &callStats) const;
+	QVariantList formatEncryptionStats (const std::shared_ptr<const linphone::CallStats> &callStats) const;
+	void archiveQuality ();
 	
 	QString iceStateToString (linphone::IceState state) const;
 	
@@ -321,9 +332,11 @@ private:
 	QString mCallError;
 	QString mCallId;
 	
-	QVariantList mAudioStats;
-	QVariantList mVideoStats;
-	QVariantList mEncryptionStats;
+	std::shared_ptr<const linphone::CallStats> mAudioCallStats;
+	std::shared_ptr<const linphone::CallStats> mVideoCallStats;
+	CallStatsModel *mAudioStatsModel = nullptr;
+	CallStatsModel *mVideoStatsModel = nullptr;
+	bool mQualityArchived = false;
 	std::shared_ptr<SearchListener> mSearch;
 	QString mTransferAddress;
 	QSharedPointer<ConferenceModel> mConferenceModel;
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMap>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#include "app/paths/Paths.hpp"
+#include "utils/Utils.hpp"
+
+#include "CallQualityArchive.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr qint64 MaxArchiveSize = 2 * 1024 * 1024;// In bytes, the backup file is not counted.
+	constexpr float PoorQuality = 3;// Rating from 0 to 5.
+	constexpr int WorstCallsCount = 5;
+}
+
+CallQualityArchive::CallQualityArchive (QObject *parent) : QObject(parent) {
+	mPool.setMaxThreadCount(1);
+}
+
+CallQualityArchive::~CallQualityArchive () {
+	mPool.waitForDone();
+}
+
+QString CallQualityArchive::getFilePath () {
+	return Utils::coreStringToAppString(Paths::getCallQualityArchiveFilePath());
+}
+
+QString CallQualityArchive::getBackupFilePath () {
+	return getFilePath() + ".1";
+}
+
+// -----------------------------------------------------------------------------
+
+void CallQualityArchive::append (const QJsonObject &record) {
+	const QString filePath = getFilePath();
+	QtConcurrent::run(&mPool, [filePath, record]() {
+		if (!write(filePath, QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n'))
+			qWarning() << QStringLiteral("Unable to write call quality record: `%1`.").arg(filePath);
+	});
+}
+
+bool CallQualityArchive::write (const QString &filePath, const QByteArray &line) {
+	QFile file(filePath);
+	if (file.exists() && file.size() + line.size() > MaxArchiveSize) {
+		const QString backupFilePath = getBackupFilePath();
+		QFile::remove(backupFilePath);
+		if (!file.rename(backupFilePath))
+			return false;
+		qInfo() << QStringLiteral("Call quality archive is full, backed up to: `%1`.").arg(backupFilePath);
+		file.setFileName(filePath);
+	}
+	return file.open(QIODevice::WriteOnly | QIODevice::Append) && file.write(line) == line.size();
+}
+
+// -----------------------------------------------------------------------------
+
+QList<QJsonObject> CallQualityArchive::read (qint64 since) {
+	QList<QJsonObject> records;
+	for (const QString &filePath : { getBackupFilePath(), getFilePath() }) {
+		QFile file(filePath);
+		if (!file.open(QIODevice::ReadOnly))
+			continue;
+		while (!file.atEnd()) {
+			const QJsonObject record = QJsonDocument::fromJson(file.readLine()).object();
+			if (!record.isEmpty() && qint64(record["start"].toDouble()) >= since)
+				records << record;
+		}
+	}
+	return records;
+}
+
+static QString formatDuration (int seconds) {
+	return QStringLiteral("%1:%2:%3")
+		.arg(seconds / 3600).arg((seconds % 3600) / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+void CallQualityArchive::printReport (QTextStream &out, int days) {
+	const qint64 since = days > 0 ? QDateTime::currentDateTime().addDays(-days).toMSecsSinceEpoch() : 0;
+	QList<QJsonObject> records = read(since);
+	
+	out << QStringLiteral("Call quality archive: %1\n").arg(getFilePath());
+	out << QStringLiteral("Calls: %1 (%2)\n").arg(records.size())
+		.arg(days > 0 ? QStringLiteral("last %1 day(s)").arg(days) : QStringLiteral("all"));
+	if (records.isEmpty()) {
+		out.flush();
+		return;
+	}
+	
+	int duration = 0, rated = 0, poor = 0, audioCount = 0;
+	double qualitySum = 0, jitterSum = 0, lossRateSum = 0, roundTripDelaySum = 0;
+	QMap<QString, int> codecs, iceStates;
+	for (const QJsonObject &record : records) {
+		duration += record["duration"].toInt();
+		const double quality = record["averageQuality"].toDouble(-1);
+		if (quality >= 0) {
+			++rated;
+			qualitySum += quality;
+			if (quality < PoorQuality)
+				++poor;
+		}
+		for (const char *stream : { "audio", "video" }) {
+			const QJsonObject streamObject = record[stream].toObject();
+			for (const QJsonValue &codec : streamObject["codecs"].toArray())
+				++codecs[codec.toArray().at(1).toString()];
+			for (const QJsonValue &iceState : streamObject["ice"].toArray())
+				++iceStates[iceState.toString()];
+		}
+		const QJsonObject audioSummary = record["audio"].toObject()["summary"].toObject();
+		if (!audioSummary.isEmpty()) {
+			++audioCount;
+			jitterSum += audioSummary["jitter"].toDouble();
+			lossRateSum += audioSummary["lossRate"].toDouble();
+			roundTripDelaySum += audioSummary["roundTripDelay"].toDouble();
+		}
+	}
+	
+	out << QStringLiteral("Total duration: %1\n").arg(formatDuration(duration));
+	if (rated > 0)
+		out << QStringLiteral("Average rating: %1, poor calls (rating < %2): %3 (%4 %)\n")
+			.arg(qualitySum / rated, 0, 'f', 2).arg(double(PoorQuality)).arg(poor).arg(100.0 * poor / rated, 0, 'f', 1);
+	if (audioCount > 0)
+		out << QStringLiteral("Audio: jitter %1 ms, loss rate %2 %, round-trip delay %3 ms (averages)\n")
+			.arg(jitterSum / audioCount, 0, 'f', 1).arg(lossRateSum / audioCount, 0, 'f', 2).arg(roundTripDelaySum / audioCount, 0, 'f', 0);
+	
+	auto printCounts = [&out](const QString &label, const QMap<QString, int> &counts) {
+		QStringList items;
+		for (auto it = counts.cbegin(); it != counts.cend(); ++it)
+			items << QStringLiteral("%1 (%2)").arg(it.key()).arg(it.value());
+		out << label << ": " << items.join(", ") << "\n";
+	};
+	printCounts(QStringLiteral("Codecs"), codecs);
+	printCounts(QStringLiteral("ICE"), iceStates);
+	
+	// Worst calls first, unrated calls are ignored.
+	records.erase(std::remove_if(records.begin(), records.end(), [](const QJsonObject &record) {
+		return record["averageQuality"].toDouble(-1) < 0;
+	}), records.end());
+	std::sort(records.begin(), records.end(), [](const QJsonObject &a, const QJsonObject &b) {
+		return a["averageQuality"].toDouble() < b["averageQuality"].toDouble();
+	});
+	if (!records.isEmpty())
+		out << "Worst calls:\n";
+	for (int i = 0; i < qMin(WorstCallsCount, records.size()); ++i) {
+		const QJsonObject &record = records[i];
+		const QJsonObject audioSummary = record["audio"].toObject()["summary"].toObject();
+		out << QStringLiteral("  %1  %2  %3  rating %4, loss rate %5 %, jitter %6 ms\n")
+			.arg(QDateTime::fromMSecsSinceEpoch(qint64(record["start"].toDouble())).toString(Qt::ISODate))
+			.arg(record["peer"].toString())
+			.arg(formatDuration(record["duration"].toInt()))
+			.arg(record["averageQuality"].toDouble(), 0, 'f', 2)
+			.arg(audioSummary["lossRate"].toDouble(), 0, 'f', 2)
+			.arg(audioSummary["jitter"].toDouble(), 0, 'f', 1);
+	}
+	out.flush();
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CALL_QUALITY_ARCHIVE_H_
+#define CALL_QUALITY_ARCHIVE_H_
+
+#include <QJsonObject>
+#include <QObject>
+#include <QThreadPool>
+
+// =============================================================================
+
+class QTextStream;
+
+// Quality records of the finished calls, one JSON object per line.
+// The archive is bounded: when it is full, it becomes the backup file and a new one is started.
+class CallQualityArchive : public QObject {
+	Q_OBJECT
+	
+public:
+	CallQualityArchive (QObject *parent = Q_NULLPTR);
+	~CallQualityArchive ();
+	
+	// Written in background, in order.
+	void append (const QJsonObject &record);
+	
+	// Summary of the calls of the last `days` days (all calls if `days` <= 0).
+	static void printReport (QTextStream &out, int days);
+	
+	static QString getFilePath ();
+	static QString getBackupFilePath ();
+	
+private:
+	static bool write (const QString &filePath, const QByteArray &line);
+	static QList<QJsonObject> read (qint64 since);
+	
+	QThreadPool mPool;
+};
+
+#endif // CALL_QUALITY_ARCHIVE_H_
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDateTime>
+#include <QJsonArray>
+
+#include "CallStatsModel.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr int MaxSamples = 120;
+}
+
+CallStatsModel::CallStatsModel (QObject *parent) : QAbstractListModel(parent) {
+	mSamples.resize(MaxSamples);
+}
+
+int CallStatsModel::rowCount (const QModelIndex &) const {
+	return mCount;
+}
+
+QHash<int, QByteArray> CallStatsModel::roleNames () const {
+	QHash<int, QByteArray> roles;
+	roles[TimestampRole] = "timestamp";
+	roles[JitterBufferRole] = "jitterBuffer";
+	roles[ReceiverJitterRole] = "receiverJitter";
+	roles[SenderLossRateRole] = "senderLossRate";
+	roles[ReceiverLossRateRole] = "receiverLossRate";
+	roles[RoundTripDelayRole] = "roundTripDelay";
+	roles[UploadBandwidthRole] = "uploadBandwidth";
+	roles[DownloadBandwidthRole] = "downloadBandwidth";
+	roles[EstimatedDownloadBandwidthRole] = "estimatedDownloadBandwidth";
+	roles[SentFramerateRole] = "sentFramerate";
+	roles[ReceivedFramerateRole] = "receivedFramerate";
+	roles[SentWidthRole] = "sentWidth";
+	roles[SentHeightRole] = "sentHeight";
+	roles[ReceivedWidthRole] = "receivedWidth";
+	roles[ReceivedHeightRole] = "receivedHeight";
+	roles[QualityRole] = "quality";
+	return roles;
+}
+
+QVariant CallStatsModel::data (const QModelIndex &index, int role) const {
+	int row = index.row();
+	if (!index.isValid() || row < 0 || row >= mCount)
+		return QVariant();
+	return getValue(getSample(row), role);
+}
+
+QVariantList CallStatsModel::getValues (const QString &roleName) const {
+	const int role = roleNames().key(roleName.toUtf8(), -1);
+	QVariantList values;
+	if (role < 0)
+		return values;
+	values.reserve(mCount);
+	for (int row = 0; row < mCount; ++row)
+		values << getValue(getSample(row), role);
+	return values;
+}
+
+// -----------------------------------------------------------------------------
+
+static QString getIceStateName (linphone::IceState state) {
+	switch (state) {
+		case linphone::IceState::NotActivated: return QStringLiteral("notActivated");
+		case linphone::IceState::Failed: return QStringLiteral("failed");
+		case linphone::IceState::InProgress: return QStringLiteral("inProgress");
+		case linphone::IceState::HostConnection: return QStringLiteral("host");
+		case linphone::IceState::ReflexiveConnection: return QStringLiteral("reflexive");
+		case linphone::IceState::RelayConnection: return QStringLiteral("relay");
+	}
+	return QString();
+}
+
+void CallStatsModel::addSample (const std::shared_ptr<const linphone::CallStats> &callStats, const std::shared_ptr<const linphone::CallParams> &params, float quality) {
+	if (mCount == mSamples.size()) {// Drop the oldest one.
+		beginRemoveRows(QModelIndex(), 0, 0);
+		mFirst = (mFirst + 1) % mSamples.size();
+		--mCount;
+		endRemoveRows();
+	}
+	
+	Sample &sample = mSamples[(mFirst + mCount) % mSamples.size()];
+	sample = Sample();
+	sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+	sample.jitterBuffer = callStats->getJitterBufferSizeMs();
+	sample.receiverJitter = callStats->getReceiverInterarrivalJitter();
+	sample.senderLossRate = callStats->getSenderLossRate();
+	sample.receiverLossRate = callStats->getReceiverLossRate();
+	sample.roundTripDelay = callStats->getRoundTripDelay() * 1000;
+	sample.uploadBandwidth = callStats->getUploadBandwidth();
+	sample.downloadBandwidth = callStats->getDownloadBandwidth();
+	sample.estimatedDownloadBandwidth = callStats->getEstimatedDownloadBandwidth();
+	sample.quality = quality;
+	if (params && callStats->getType() == linphone::StreamType::Video) {
+		sample.sentFramerate = params->getSentFramerate();
+		sample.receivedFramerate = params->getReceivedFramerate();
+		if (auto definition = params->getSentVideoDefinition()) {
+			sample.sentWidth = int(definition->getWidth());
+			sample.sentHeight = int(definition->getHeight());
+		}
+		if (auto definition = params->getReceivedVideoDefinition()) {
+			sample.receivedWidth = int(definition->getWidth());
+			sample.receivedHeight = int(definition->getHeight());
+		}
+	}
+	
+	mIntervals << Interval{
+		sample.timestamp, sample.receiverJitter, sample.senderLossRate, sample.receiverLossRate, sample.roundTripDelay,
+		sample.uploadBandwidth, sample.downloadBandwidth, sample.quality
+	};
+	
+	++mSummary.count;
+	mSummary.jitterSum += sample.receiverJitter;
+	mSummary.jitterMax = qMax(mSummary.jitterMax, sample.receiverJitter);
+	mSummary.lossRateSum += sample.receiverLossRate;
+	mSummary.lossRateMax = qMax(mSummary.lossRateMax, sample.receiverLossRate);
+	mSummary.roundTripDelaySum += sample.roundTripDelay;
+	mSummary.bandwidthSum += sample.downloadBandwidth;
+	if (quality >= 0) {
+		++mSummary.qualityCount;
+		mSummary.qualitySum += quality;
+		mSummary.qualityMin = mSummary.qualityMin < 0 ? quality : qMin(mSummary.qualityMin, quality);
+	}
+	
+	if (params) {
+		auto payloadType = callStats->getType() == linphone::StreamType::Video
+			? params->getUsedVideoPayloadType()
+			: params->getUsedAudioPayloadType();
+		if (payloadType) {
+			const QString codec = QStringLiteral("%1/%2")
+				.arg(QString::fromStdString(payloadType->getMimeType())).arg(payloadType->getClockRate());
+			if (mCodecs.isEmpty() || mCodecs.last().second != codec)
+				mCodecs << qMakePair(sample.timestamp, codec);
+		}
+	}
+	const QString iceState = getIceStateName(callStats->getIceState());
+	if (!mIceStates.contains(iceState))
+		mIceStates << iceState;
+	
+	beginInsertRows(QModelIndex(), mCount, mCount);
+	++mCount;
+	endInsertRows();
+	emit countChanged(mCount);
+}
+
+void CallStatsModel::clear () {
+	beginResetModel();
+	mFirst = 0;
+	mCount = 0;
+	mSummary = Summary();
+	mIntervals.clear();
+	mCodecs.clear();
+	mIceStates.clear();
+	endResetModel();
+	emit countChanged(mCount);
+}
+
+// Samples are arrays to stay compact: see `intervalFields` for their content.
+QJsonObject CallStatsModel::toJson () const {
+	QJsonObject object;
+	
+	QJsonArray codecs;
+	for (const auto &codec : mCodecs)
+		codecs.append(QJsonArray{ codec.first, codec.second });
+	object["codecs"] = codecs;
+	object["ice"] = QJsonArray::fromStringList(mIceStates);
+	
+	if (mSummary.count > 0) {
+		QJsonObject summary;
+		summary["samples"] = mSummary.count;
+		summary["jitter"] = mSummary.jitterSum / mSummary.count;
+		summary["jitterMax"] = mSummary.jitterMax;
+		summary["lossRate"] = mSummary.lossRateSum / mSummary.count;
+		summary["lossRateMax"] = mSummary.lossRateMax;
+		summary["roundTripDelay"] = mSummary.roundTripDelaySum / mSummary.count;
+		summary["downloadBandwidth"] = mSummary.bandwidthSum / mSummary.count;
+		if (mSummary.qualityCount > 0) {
+			summary["quality"] = mSummary.qualitySum / mSummary.qualityCount;
+			summary["qualityMin"] = mSummary.qualityMin;
+		}
+		object["summary"] = summary;
+	}
+	
+	object["intervalFields"] = QJsonArray{
+		"timestamp", "receiverJitter", "senderLossRate", "receiverLossRate", "roundTripDelay",
+		"uploadBandwidth", "downloadBandwidth", "quality"
+	};
+	QJsonArray intervals;
+	for (const Interval &interval : mIntervals)
+		intervals.append(QJsonArray{
+			interval.timestamp, interval.receiverJitter, interval.senderLossRate, interval.receiverLossRate, interval.roundTripDelay,
+			interval.uploadBandwidth, interval.downloadBandwidth, interval.quality
+		});
+	object["intervals"] = intervals;
+	return object;
+}
+
+// -----------------------------------------------------------------------------
+
+const CallStatsModel::Sample &CallStatsModel::getSample (int row) const {
+	return mSamples[(mFirst + row) % mSamples.size()];
+}
+
+QVariant CallStatsModel::getValue (const Sample &sample, int role) {
+	switch (role) {
+		case TimestampRole: return sample.timestamp;
+		case JitterBufferRole: return sample.jitterBuffer;
+		case ReceiverJitterRole: return sample.receiverJitter;
+		case SenderLossRateRole: return sample.senderLossRate;
+		case ReceiverLossRateRole: return sample.receiverLossRate;
+		case RoundTripDelayRole: return sample.roundTripDelay;
+		case UploadBandwidthRole: return sample.uploadBandwidth;
+		case DownloadBandwidthRole: return sample.downloadBandwidth;
+		case EstimatedDownloadBandwidthRole: return sample.estimatedDownloadBandwidth;
+		case SentFramerateRole: return sample.sentFramerate;
+		case ReceivedFramerateRole: return sample.receivedFramerate;
+		case SentWidthRole: return sample.sentWidth;
+		case SentHeightRole: return sample.sentHeight;
+		case ReceivedWidthRole: return sample.receivedWidth;
+		case ReceivedHeightRole: return sample.receivedHeight;
+		case QualityRole: return sample.quality;
+		default: return QVariant();
+	}
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CALL_STATS_MODEL_H_
+#define CALL_STATS_MODEL_H_
+
+#include <QAbstractListModel>
+#include <QJsonObject>
+#include <QVector>
+#include <linphone++/linphone.hh>
+
+// =============================================================================
+
+// Last numeric samples of the statistics of one stream, from the oldest to the newest.
+class CallStatsModel : public QAbstractListModel {
+	Q_OBJECT
+	
+	Q_PROPERTY(int capacity READ getCapacity CONSTANT)
+	Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+	
+public:
+	enum Roles {
+		TimestampRole = Qt::UserRole,// In ms since epoch.
+		JitterBufferRole,// In ms.
+		ReceiverJitterRole,// In ms.
+		SenderLossRateRole,// In %.
+		ReceiverLossRateRole,// In %.
+		RoundTripDelayRole,// In ms.
+		UploadBandwidthRole,// In kbits/s.
+		DownloadBandwidthRole,// In kbits/s.
+		EstimatedDownloadBandwidthRole,// In kbits/s.
+		SentFramerateRole,
+		ReceivedFramerateRole,
+		SentWidthRole,
+		SentHeightRole,
+		ReceivedWidthRole,
+		ReceivedHeightRole,
+		QualityRole// Rating of the call, from 0 to 5.
+	};
+	
+	struct Sample {
+		qint64 timestamp = 0;
+		float jitterBuffer = 0;
+		float receiverJitter = 0;
+		float senderLossRate = 0;
+		float receiverLossRate = 0;
+		float roundTripDelay = 0;
+		float uploadBandwidth = 0;
+		float downloadBandwidth = 0;
+		float estimatedDownloadBandwidth = 0;
+		float sentFramerate = 0;
+		float receivedFramerate = 0;
+		int sentWidth = 0;
+		int sentHeight = 0;
+		int receivedWidth = 0;
+		int receivedHeight = 0;
+		float quality = -1;
+	};
+	
+	CallStatsModel (QObject *parent = Q_NULLPTR);
+	
+	int rowCount (const QModelIndex &index = QModelIndex()) const override;
+	
+	QHash<int, QByteArray> roleNames () const override;
+	QVariant data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+	
+	// Values of one role, for charts.
+	Q_INVOKABLE QVariantList getValues (const QString &roleName) const;
+	
+	void addSample (const std::shared_ptr<const linphone::CallStats> &callStats, const std::shared_ptr<const linphone::CallParams> &params, float quality = -1);
+	void clear ();
+	
+	// Codec switches, ICE states, averages and samples since the start of the call.
+	QJsonObject toJson () const;
+	
+	int getCapacity () const {
+		return mSamples.size();
+	}
+	
+signals:
+	void countChanged (int count);
+	
+private:
+	const Sample &getSample (int row) const;
+	static QVariant getValue (const Sample &sample, int role);
+	
+	// Over all the samples, not only the buffered ones.
+	struct Summary {
+		int count = 0;
+		double jitterSum = 0;
+		float jitterMax = 0;
+		double lossRateSum = 0;
+		float lossRateMax = 0;
+		double roundTripDelaySum = 0;
+		double bandwidthSum = 0;
+		int qualityCount = 0;
+		double qualitySum = 0;
+		float qualityMin = -1;
+	};
+	
+	// Archived fields of a sample (see `intervalFields`).
+	struct Interval {
+		qint64 timestamp;
+		float receiverJitter;
+		float senderLossRate;
+		float receiverLossRate;
+		float roundTripDelay;
+		float uploadBandwidth;
+		float downloadBandwidth;
+		float quality;
+	};
+	
+	QVector<Sample> mSamples;// Fixed size ring buffer.
+	int mFirst = 0;
+	int mCount = 0;
+	
+	Summary mSummary;
+	QVector<Interval> mIntervals;// All the samples of the call, not only the buffered ones.
+	QVector<QPair<qint64, QString>> mCodecs;// Timestamp of each codec switch.
+	QStringList mIceStates;
+};
+
+#endif // CALL_STATS_MODEL_H_
@@ -72,9 +72,9 @@ CallsListModel::CallsListModel (QObject *parent) : ProxyListModel(parent) {
 }
 
 CallModel *CallsListModel::findCallModelFromPeerAddress (const QString &peerAddress) const {
-	std::shared_ptr<linphone::Address> address = Utils::interpretUrl(peerAddress);
+	SipAddressHandle address = SipAddressCache::getHandle(Utils::interpretUrl(peerAddress));
 	auto it = find_if(mList.begin(), mList.end(), [address](QSharedPointer<QObject> callModel) {
-			return callModel.objectCast<CallModel>()->getRemoteAddress()->weakEqual(address);
+			return callModel.objectCast<CallModel>()->getRemoteAddressHandle() == address;
 	});
 	return it != mList.end() ? it->objectCast<CallModel>().get() : nullptr;
 }
@@ -70,10 +70,10 @@ void ChatMessageModel::connectTo(ChatMessageListener * listener){
 
 ChatMessageModel::AppDataManager::AppDataManager(const QString& appdata){
 	if(!appdata.isEmpty()){
-		for(QString pair : appdata.split(';')){
-			QStringList fields = pair.split(':');
-			if(fields.size() > 1)
-				mData[fields[1]] = fields[0];
+		for(const QStringRef& pair : appdata.splitRef(';')){
+			int separator = pair.indexOf(':');// ID:Path. Path can contain ':'.
+			if(separator >= 0)
+				mData[pair.mid(separator + 1).toString()] = pair.left(separator).toString();
 			else
 				qWarning() << "Bad or too old appdata. It need a compatibility parsing : " << appdata;
 		}
@@ -254,18 +254,13 @@ void ChatMessageModel::resendMessage (){
 void ChatMessageModel::deleteEvent(){
 	if (mChatMessage && mChatMessage->getFileTransferInformation()) {// Remove thumbnail
 		mChatMessage->cancelFileTransfer();
-		QString appdata = QString::fromStdString(mChatMessage->getAppdata());
-		QStringList fields = appdata.split(':');
-		
-		if(fields[0].size() > 0) {
-			QString thumbnailPath = QString::fromStdString(Paths::getThumbnailsDirPath()) + fields[0];
-			if (!QFile::remove(thumbnailPath))
-				qWarning() << QStringLiteral("Unable to remove `%1`.").arg(thumbnailPath);
-		}
+		// Thumbnails can be shared with other messages: they are evicted by the store.
 		mChatMessage->setAppdata("");// Remove completely Thumbnail from the message
 	}
-	if(mChatMessage)
+	if(mChatMessage){
+		ContentListModel::removeCompressedCopies(mChatMessage);
 		mChatMessage->getChatRoom()->deleteMessage(mChatMessage);
+	}
 }
 
 
@@ -320,6 +315,8 @@ void ChatMessageModel::onEphemeralMessageDeleted(const std::shared_ptr<linphone:
 	//emit remove(mSelf.lock());
 	if(!isOutgoing())
 		mContentListModel->removeDownloadedFiles();
+	else
+		ContentListModel::removeCompressedCopies(mChatMessage);
 	emit remove(this);
 }
 //-------------------------------------------------------------------------------------------------------
@@ -62,6 +62,7 @@
 #include "components/recorder/RecorderModel.hpp"
 #include "components/timeline/TimelineModel.hpp"
 #include "components/timeline/TimelineListModel.hpp"
+#include "components/transfer/TransferScheduler.hpp"
 #include "components/core/event-count-notifier/AbstractEventCountNotifier.hpp"
 #include "utils/QExifImageHeader.hpp"
 #include "utils/Utils.hpp"
@@ -266,6 +267,7 @@ void ChatRoomModel::removeAllEntries () {
 	bool standardChatEnabled = CoreManager::getInstance()->getSettingsModel()->getStandardChatEnabled();
 	beginResetModel();
 	mList.clear();
+	ContentListModel::removeCompressedCopies(mChatRoom);
 	mChatRoom->deleteHistory();
 	if( isOneToOne() && // Remove calls only if chat room is one-one and not secure (if available)
 		( !standardChatEnabled || !isSecure())
@@ -621,6 +623,7 @@ void ChatRoomModel::deleteChatRoom(){
 	qInfo() << "Deleting ChatRoom : " << getSubject() << ",  address=" << getFullPeerAddress();
 	if(mChatRoom){
 		mChatRoom->removeListener(mChatRoomListener);
+		ContentListModel::removeCompressedCopies(mChatRoom);
 		CoreManager::getInstance()->getCore()->deleteChatRoom(mChatRoom);
 	}
 	emit chatRoomDeleted();
@@ -661,6 +664,12 @@ void ChatRoomModel::updateParticipants(const QVariantList& participants){
 // -----------------------------------------------------------------------------
 
 void ChatRoomModel::sendMessage (const QString &message) {
+	auto contentListModel = CoreManager::getInstance()->getChatModel()->getContentListModel();
+	if (contentListModel->getPreparingCount() > 0) {// Wait for the images being compressed: they are sent with the message.
+		mPendingMessages << message;
+		QObject::connect(contentListModel.get(), &ContentListModel::preparingChanged, this, &ChatRoomModel::sendPendingMessages, Qt::UniqueConnection);
+		return;
+	}
 	std::list<shared_ptr<linphone::ChatMessage> > _messages;
 	bool isBasicChatRoom = isBasic();
 	if(mReplyModel && mReplyModel->getChatMessage()) {
@@ -689,8 +698,7 @@ void ChatRoomModel::sendMessage (const QString &message) {
 	bool sent = false;
 	for(auto itMessage = _messages.begin() ; itMessage != _messages.end() ; ++itMessage) {
 		if((*itMessage)->getContents().size() > 0){// Have something to send
-			(*itMessage)->send();
-			emit messageSent((*itMessage));
+			send(*itMessage);
 			sent = true;
 		}
 	}
@@ -702,6 +710,17 @@ void ChatRoomModel::sendMessage (const QString &message) {
 	}
 }
 
+void ChatRoomModel::sendPendingMessages () {
+	auto contentListModel = CoreManager::getInstance()->getChatModel()->getContentListModel();
+	if (contentListModel->getPreparingCount() > 0)
+		return;
+	QObject::disconnect(contentListModel.get(), &ContentListModel::preparingChanged, this, &ChatRoomModel::sendPendingMessages);
+	const QStringList messages = mPendingMessages;
+	mPendingMessages.clear();
+	for (const QString &message : messages)// Attachments go with the first one.
+		sendMessage(message);
+}
+
 void ChatRoomModel::forwardMessage(ChatMessageModel * model){
 	if(model){
 		shared_ptr<linphone::ChatMessage> _message;
@@ -712,10 +731,18 @@ void ChatRoomModel::forwardMessage(ChatMessageModel * model){
 			if(content)
 				_message->addContent(content);
 		}
-		_message->send();
-		emit messageSent(_message);
+		send(_message);
 	}
 }
+
+// Messages are sent and stored at once. Their file uploads are followed by the transfer scheduler to delay other transfers.
+void ChatRoomModel::send (const std::shared_ptr<linphone::ChatMessage> &message) {
+	message->send();
+	emit messageSent(message);
+	auto contents = message->getContents();
+	if (std::any_of(contents.cbegin(), contents.cend(), [](const std::shared_ptr<linphone::Content> &content) { return content->isFile(); }))
+		CoreManager::getInstance()->getTransferScheduler()->upload(message);
+}
 // -----------------------------------------------------------------------------
 
 void ChatRoomModel::compose () {
@@ -1214,13 +1241,11 @@ void ChatRoomModel::handlePresenceStatusReceived(std::shared_ptr<linphone::Frien
 //----------------------------------------------------------
 
 void ChatRoomModel::onIsComposingReceived(const std::shared_ptr<linphone::ChatRoom> & chatRoom, const std::shared_ptr<const linphone::Address> & remoteAddress, bool isComposing){
-	auto it = mComposers.begin();
-	while(it != mComposers.end() && !it.key()->weakEqual(remoteAddress))
-		++it;
-	if(it != mComposers.end())
-		mComposers.erase(it);
+	SipAddressHandle composer = SipAddressCache::getHandle(remoteAddress);
 	if(isComposing)
-		mComposers[remoteAddress] = Utils::getDisplayName(remoteAddress);
+		mComposers[composer] = Utils::getDisplayName(remoteAddress);
+	else
+		mComposers.remove(composer);
 	emit isRemoteComposingChanged();
 }
 
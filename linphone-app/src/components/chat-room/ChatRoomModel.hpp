@@ -25,6 +25,8 @@
 #include "app/proxyModel/ProxyListModel.hpp"
 #include <QDateTime>
 
+#include "utils/SipAddressCache.hpp"
+
 // =============================================================================
 // Fetch all N messages of a ChatRoom.
 // =============================================================================
@@ -290,6 +292,8 @@ signals:
 private:
 
 	void connectTo(ChatRoomListener * listener);
+	void send (const std::shared_ptr<linphone::ChatMessage> &message);
+	void sendPendingMessages ();
 	
 	void handleCallStateChanged (const std::shared_ptr<linphone::Call> &call, linphone::Call::State state);
 	void handleCallCreated(const std::shared_ptr<linphone::Call> &call);// Count an event call
@@ -299,11 +303,12 @@ private:
 	std::shared_ptr<ChatRoomListener> mChatRoomListener;	// This need to be a shared_ptr because of adding it to linphone
 	std::shared_ptr<CoreHandlers> mCoreHandlers;					// This need to be a shared_ptr because of adding it to linphone
 	
-	QMap<std::shared_ptr<const linphone::Address>, QString> mComposers;	// Store all addresses that are composing with its username
+	QMap<SipAddressHandle, QString> mComposers;	// Store all addresses that are composing with its username
 	
 	QSharedPointer<ParticipantListModel> mParticipantListModel;
 	QSharedPointer<ChatMessageModel> mReplyModel;
 	QSharedPointer<ChatNoticeModel> mUnreadMessageNotice;
+	QStringList mPendingMessages;// Sent when the attached images are compressed.
 	int mBindingCalls = 0;
 	
 	QWeakPointer<ChatRoomModel> mSelf;
@@ -48,7 +48,7 @@ ChatRoomProxyModel::ChatRoomProxyModel (QObject *parent) : QSortFilterProxyModel
 		handleIsActiveChanged(App::getInstance()->getMainWindow());
 	});
 	
-	QQuickWindow *callsWindow = app->getCallsWindow();
+	QQuickWindow *callsWindow = app->getCallsWindow(false);
 	if (callsWindow)
 		QObject::connect(callsWindow, &QWindow::activeChanged, this, [this, callsWindow]() {
 			handleIsActiveChanged(callsWindow);
@@ -343,7 +343,7 @@ void ChatRoomProxyModel::setChatRoomModel (ChatRoomModel *chatRoomModel){
 static inline QWindow *getParentWindow (QObject *object) {
 	App *app = App::getInstance();
 	const QWindow *mainWindow = app->getMainWindow();
-	const QWindow *callsWindow = app->getCallsWindow();
+	const QWindow *callsWindow = app->getCallsWindow(false);
 	for (QObject *parent = object->parent(); parent; parent = parent->parent())
 		if (parent == mainWindow || parent == callsWindow)
 			return static_cast<QWindow *>(parent);
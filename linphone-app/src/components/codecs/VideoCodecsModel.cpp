@@ -26,6 +26,7 @@
 #include "components/core/CoreManager.hpp"
 #include "components/file/FileDownloader.hpp"
 #include "components/file/FileExtractor.hpp"
+#include "components/settings/SettingsModel.hpp"
 #include "utils/Utils.hpp"
 #include "utils/Constants.hpp"
 
@@ -47,7 +48,8 @@ static bool downloadUpdatableCodec (
   const QString &codecsFolder,
   const QString &mime,
   const QString &downloadUrl,
-  const QString &installName
+  const QString &installName,
+  const QString &checksum
 ) {
   QString versionFilePath = codecsFolder + mime + ".txt";
   QFile versionFile(versionFilePath);
@@ -65,20 +67,15 @@ static bool downloadUpdatableCodec (
   FileDownloader *fileDownloader = new FileDownloader(parent);
   fileDownloader->setUrl(QUrl(downloadUrl));
   fileDownloader->setDownloadFolder(codecsFolder);
+  fileDownloader->setChecksum(checksum);
+  fileDownloader->setSegmentCount(Constants::PluginDownloadSegmentCount);
 
+  // Extracted while downloading.
   FileExtractor *fileExtractor = new FileExtractor(fileDownloader);
+  fileExtractor->setDownloader(fileDownloader);
   fileExtractor->setExtractFolder(codecsFolder);
   fileExtractor->setExtractName(installName + ".in");
 
-  QObject::connect(fileDownloader, &FileDownloader::downloadFinished, [fileExtractor](const QString &filePath) {
-    fileExtractor->setFile(filePath);
-    fileExtractor->extract();
-  });
-
-  QObject::connect(fileDownloader, &FileDownloader::downloadFailed, [fileDownloader]() {
-    fileDownloader->deleteLater();
-  });
-
   QObject::connect(fileExtractor, &FileExtractor::extractFinished, [fileDownloader, fileExtractor, versionFilePath, downloadUrl]() {
     QFile versionFile(versionFilePath);
     if (!versionFile.open(QIODevice::WriteOnly)) {
@@ -95,11 +92,17 @@ static bool downloadUpdatableCodec (
     fileDownloader->deleteLater();
   });
 
-  QObject::connect(fileExtractor, &FileExtractor::extractFailed, [fileDownloader]() {
-    fileDownloader->remove();
+  // Keep the partial download to resume it later, only remove what was extracted.
+  // A complete download that cannot be extracted is useless.
+  QObject::connect(fileExtractor, &FileExtractor::extractFailed, [fileDownloader, fileExtractor]() {
+    fileExtractor->remove();
+    const QString downloadedFile = fileDownloader->getDestinationFileName();
+    if (!downloadedFile.isEmpty())
+      QFile::remove(downloadedFile);
     fileDownloader->deleteLater();
   });
 
+  fileExtractor->extract();
   fileDownloader->download();
 
   return true;
@@ -126,11 +129,15 @@ void VideoCodecsModel::updateCodecs () {
   #endif // if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
 }
 
-void VideoCodecsModel::downloadUpdatableCodecs (QObject *parent) {
+void VideoCodecsModel::downloadUpdatableCodecs (QObject *parent, const shared_ptr<linphone::Config> &config) {
   #if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
-    downloadUpdatableCodec(parent, getCodecsFolder(), "H264", Constants::PluginUrlH264, Constants::H264InstallName);
+    const QString h264Checksum = config
+      ? Utils::coreStringToAppString(config->getString(SettingsModel::UiSection, "h264_plugin_checksum", ""))
+      : QString();
+    downloadUpdatableCodec(parent, getCodecsFolder(), "H264", Constants::PluginUrlH264, Constants::H264InstallName, h264Checksum);
   #else
     Q_UNUSED(parent);
+    Q_UNUSED(config);
   #endif // if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
 }
 
@@ -25,6 +25,10 @@
 
 // =============================================================================
 
+namespace linphone {
+  class Config;
+}
+
 class VideoCodecsModel : public AbstractCodecsModel {
   Q_OBJECT;
 
@@ -32,7 +36,8 @@ public:
   VideoCodecsModel (QObject *parent = Q_NULLPTR);
 
   static void updateCodecs ();
-  static void downloadUpdatableCodecs (QObject *parent);
+  // The expected SHA-256 of a codec can be set in the `ui` section of the config (`h264_plugin_checksum`).
+  static void downloadUpdatableCodecs (QObject *parent, const std::shared_ptr<linphone::Config> &config);
 
 private:
   void updateCodecs (std::list<std::shared_ptr<linphone::PayloadType>> &codecs) override;
@@ -33,6 +33,7 @@ class ContactModel : public QObject {
   // Grant access to `mLinphoneFriend`.
   friend class ContactsListModel;
   friend class ContactsListProxyModel;
+  friend class PresenceSubscriptionManager;
   friend class SipAddressesProxyModel;
   friend class SipAddressesSorter;
 
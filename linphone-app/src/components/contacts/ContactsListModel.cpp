@@ -24,8 +24,10 @@
 #include "components/contact/ContactModel.hpp"
 #include "components/contact/VcardModel.hpp"
 #include "components/core/CoreManager.hpp"
+#include "utils/Utils.hpp"
 
 #include "ContactsListModel.hpp"
+#include "PresenceSubscriptionManager.hpp"
 
 // =============================================================================
 
@@ -47,6 +49,8 @@ ContactsListModel::ContactsListModel (QObject *parent) : ProxyListModel(parent)
 		}
 	}
 	
+	mPresenceSubscriptionManager = new PresenceSubscriptionManager(this, mLinphoneFriends);
+	
 	// Init contacts with linphone friends list.
 	QQmlEngine *engine = App::getInstance()->getEngine();
 	for (const auto &linphoneFriend : mLinphoneFriends->getFriends()) {
@@ -58,6 +62,7 @@ ContactsListModel::ContactsListModel (QObject *parent) : ProxyListModel(parent)
 		
 		addContact(contact);
 	}
+	mPresenceSubscriptionManager->init();
 }
 
 ContactsListModel::~ContactsListModel(){
@@ -85,6 +90,7 @@ bool ContactsListModel::removeRows (int row, int count, const QModelIndex &paren
 		}
 		
 		mLinphoneFriends->removeFriend(contact->mLinphoneFriend);
+		mPresenceSubscriptionManager->removeContact(contact);
 		
 		emit contactRemoved(contact);
 	}
@@ -110,6 +116,10 @@ QSharedPointer<ContactModel> ContactsListModel::findContactModelFromUsername (co
 	return it != mList.end() ? it->objectCast<ContactModel>() : nullptr;
 }
 
+ContactModel *ContactsListModel::getContactModelFromSipAddress (const QString &sipAddress) const {
+	return findContactModelFromSipAddress(Utils::cleanSipAddress(sipAddress)).get();
+}
+
 // -----------------------------------------------------------------------------
 
 ContactModel *ContactsListModel::addContact (VcardModel *vcardModel) {
@@ -130,10 +140,8 @@ ContactModel *ContactsListModel::addContact (VcardModel *vcardModel) {
 	
 	qInfo() << QStringLiteral("Add contact from vcard:") << contact.get() << vcardModel;
 	
-	// Make sure new subscribe is issued.
-	mLinphoneFriends->updateSubscriptions();
-	
-	addContact(contact);
+	// Pinned: make sure new subscribe is issued.
+	addContact(contact, true);
 	emit layoutChanged();
 	
 	emit contactAdded(contact);
@@ -145,6 +153,10 @@ void ContactsListModel::removeContact (ContactModel *contact){
 	remove(contact);
 }
 
+void ContactsListModel::setContactVisible (ContactModel *contact, bool visible) {
+	mPresenceSubscriptionManager->setVisible(contact, visible);
+}
+
 // -----------------------------------------------------------------------------
 
 void ContactsListModel::cleanAvatars () {
@@ -160,7 +172,7 @@ void ContactsListModel::cleanAvatars () {
 
 // -----------------------------------------------------------------------------
 
-void ContactsListModel::addContact (QSharedPointer<ContactModel> contact) {
+void ContactsListModel::addContact (QSharedPointer<ContactModel> contact, bool pinned) {
 	QObject::connect(contact.get(), &ContactModel::contactUpdated, this, [this, contact]() {
 		emit contactUpdated(contact);
 	});
@@ -176,4 +188,5 @@ void ContactsListModel::addContact (QSharedPointer<ContactModel> contact) {
 	for(auto address : contact->getVcardModel()->getSipAddresses()){
 		mOptimizedSearch[address.toString()] = contact;
 	}
+	mPresenceSubscriptionManager->addContact(contact, pinned);
 }
@@ -32,6 +32,7 @@ namespace linphone {
 }
 
 class ContactModel;
+class PresenceSubscriptionManager;
 class VcardModel;
 
 class ContactsListModel : public ProxyListModel {
@@ -47,12 +48,16 @@ public:
 	
 	QSharedPointer<ContactModel> findContactModelFromSipAddress (const QString &sipAddress) const;
 	QSharedPointer<ContactModel> findContactModelFromUsername (const QString &username) const;
+	Q_INVOKABLE ContactModel *getContactModelFromSipAddress (const QString &sipAddress) const;// Null if no contact.
 	
 	Q_INVOKABLE ContactModel *addContact (VcardModel *vcardModel);
 	Q_INVOKABLE void removeContact (ContactModel *contact);
 	
 	Q_INVOKABLE void cleanAvatars ();
 	
+	// To be called by views when a contact is shown/hidden: it drives presence subscriptions.
+	Q_INVOKABLE void setContactVisible (ContactModel *contact, bool visible);
+	
 signals:
 	void contactAdded (QSharedPointer<ContactModel>);
 	void contactRemoved (QSharedPointer<ContactModel>);
@@ -62,10 +67,11 @@ signals:
 	void sipAddressRemoved (QSharedPointer<ContactModel>, const QString &sipAddress);
 	
 private:
-	void addContact (QSharedPointer<ContactModel> contact);
+	void addContact (QSharedPointer<ContactModel> contact, bool pinned = false);
 	
 	QMap<QString, QSharedPointer<ContactModel>>	mOptimizedSearch;
 	std::shared_ptr<linphone::FriendList> mLinphoneFriends;
+	PresenceSubscriptionManager *mPresenceSubscriptionManager = nullptr;
 };
 
 #endif // CONTACTS_LIST_MODEL_H_
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+#include "components/contact/ContactModel.hpp"
+#include "components/core/CoreHandlers.hpp"
+#include "components/core/CoreManager.hpp"
+#include "components/settings/SettingsModel.hpp"
+#include "utils/Utils.hpp"
+
+#include "ContactsListModel.hpp"
+#include "PresenceSubscriptionManager.hpp"
+
+// =============================================================================
+
+using namespace std;
+
+namespace {
+	constexpr int PinnedContactsCount = 20;
+	constexpr int PollBatchSize = 10;
+	constexpr int PollInterval = 60000;
+	// Coalesce scrolling and bursts of events into one update.
+	constexpr int UpdateDelay = 500;
+}
+
+PresenceSubscriptionManager::PresenceSubscriptionManager (ContactsListModel *contactsListModel, shared_ptr<linphone::FriendList> friendList) :
+	QObject(contactsListModel), mContactsListModel(contactsListModel), mFriendList(friendList) {
+	mUpdateTimer = new QTimer(this);
+	mUpdateTimer->setSingleShot(true);
+	mUpdateTimer->setInterval(UpdateDelay);
+	QObject::connect(mUpdateTimer, &QTimer::timeout, this, &PresenceSubscriptionManager::update);
+	
+	mPollTimer = new QTimer(this);
+	mPollTimer->setInterval(PollInterval);
+	QObject::connect(mPollTimer, &QTimer::timeout, this, &PresenceSubscriptionManager::poll);
+	mPollTimer->start();
+	
+	CoreHandlers *coreHandlers = CoreManager::getInstance()->getHandlers().get();
+	QObject::connect(coreHandlers, &CoreHandlers::messagesReceived, this, &PresenceSubscriptionManager::handleMessagesReceived);
+	QObject::connect(coreHandlers, &CoreHandlers::callLogUpdated, this, &PresenceSubscriptionManager::handleCallLogUpdated);
+	QObject::connect(CoreManager::getInstance()->getSettingsModel(), &SettingsModel::maxPresenceSubscriptionsChanged, this, &PresenceSubscriptionManager::scheduleUpdate);
+}
+
+// Friends are loaded with their subscriptions enabled: disable the extra ones now,
+// before the friend list subscribes on registration.
+void PresenceSubscriptionManager::init () {
+	initPinnedContacts();
+	mUpdateTimer->stop();
+	update();
+}
+
+// -----------------------------------------------------------------------------
+
+void PresenceSubscriptionManager::addContact (QSharedPointer<ContactModel> contact, bool pinned) {
+	mContacts << contact;
+	if (pinned)
+		pin(contact.get());
+	scheduleUpdate();
+}
+
+void PresenceSubscriptionManager::removeContact (QSharedPointer<ContactModel> contact) {
+	ContactModel *contactModel = contact.get();
+	mContacts.removeAll(contact);
+	mPinned.removeAll(contactModel);
+	mVisible.remove(contactModel);
+	mPolled.removeAll(contactModel);
+	scheduleUpdate();
+}
+
+void PresenceSubscriptionManager::setVisible (ContactModel *contact, bool visible) {
+	if (!contact)
+		return;
+	auto it = mVisible.find(contact);
+	if (visible) {
+		if (it == mVisible.end())
+			mVisible.insert(contact, 1);
+		else
+			++(*it);
+	} else if (it != mVisible.end() && --(*it) <= 0)
+		mVisible.erase(it);
+	scheduleUpdate();
+}
+
+// -----------------------------------------------------------------------------
+
+void PresenceSubscriptionManager::initPinnedContacts () {
+	shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
+	
+	list<shared_ptr<linphone::ChatRoom>> chatRooms = core->getChatRooms();
+	chatRooms.sort([](const shared_ptr<linphone::ChatRoom> &a, const shared_ptr<linphone::ChatRoom> &b) {
+		return a->getLastUpdateTime() > b->getLastUpdateTime();
+	});
+	QStringList recentAddresses;
+	for (const auto &chatRoom : chatRooms) {
+		if (recentAddresses.size() >= PinnedContactsCount)
+			break;
+		recentAddresses << Utils::coreStringToAppString(chatRoom->getPeerAddress()->asStringUriOnly());
+	}
+	int callCount = 0;
+	for (const auto &callLog : core->getCallLogs()) {// Most recent first.
+		if (++callCount > PinnedContactsCount)
+			break;
+		recentAddresses << Utils::coreStringToAppString(callLog->getRemoteAddress()->asStringUriOnly());
+	}
+	// Pin the oldest first: `pin()` moves the last one to the front.
+	for (auto it = recentAddresses.crbegin(); it != recentAddresses.crend(); ++it)
+		pin(*it);
+}
+
+void PresenceSubscriptionManager::pin (const QString &sipAddress) {
+	QSharedPointer<ContactModel> contact = mContactsListModel->findContactModelFromSipAddress(Utils::cleanSipAddress(sipAddress));
+	if (contact)
+		pin(contact.get());
+}
+
+void PresenceSubscriptionManager::pin (ContactModel *contact) {
+	mPinned.removeAll(contact);
+	mPinned.prepend(contact);
+	if (mPinned.size() > PinnedContactsCount)
+		mPinned.resize(PinnedContactsCount);
+}
+
+void PresenceSubscriptionManager::handleMessagesReceived (const list<shared_ptr<linphone::ChatMessage>> &messages) {
+	for (const auto &message : messages)
+		pin(Utils::coreStringToAppString(message->getFromAddress()->asStringUriOnly()));
+	scheduleUpdate();
+}
+
+void PresenceSubscriptionManager::handleCallLogUpdated (const shared_ptr<linphone::CallLog> &callLog) {
+	pin(Utils::coreStringToAppString(callLog->getRemoteAddress()->asStringUriOnly()));
+	scheduleUpdate();
+}
+
+// -----------------------------------------------------------------------------
+
+bool PresenceSubscriptionManager::useResourceList () const {
+	return !!mFriendList->getRlsAddress();
+}
+
+// Replace the previous batch by the next contacts that are not already subscribed for another reason.
+void PresenceSubscriptionManager::poll () {
+	mPolled.clear();
+	if (mContacts.isEmpty() || useResourceList())
+		return;
+	
+	for (int checked = 0; checked < mContacts.size() && mPolled.size() < PollBatchSize; ++checked) {
+		mPollIndex = (mPollIndex + 1) % mContacts.size();
+		ContactModel *contact = mContacts[mPollIndex].get();
+		if (!mPinned.contains(contact) && !mVisible.contains(contact))
+			mPolled << contact;
+	}
+	scheduleUpdate();
+}
+
+void PresenceSubscriptionManager::scheduleUpdate () {
+	if (!mUpdateTimer->isActive())
+		mUpdateTimer->start();
+}
+
+void PresenceSubscriptionManager::update () {
+	const bool resourceList = useResourceList();
+	QSet<ContactModel *> subscribed;
+	if (!resourceList) {
+		int budget = CoreManager::getInstance()->getSettingsModel()->getMaxPresenceSubscriptions();
+		auto take = [&subscribed, &budget](ContactModel *contact) {
+			if (budget > 0 && !subscribed.contains(contact)) {
+				subscribed << contact;
+				--budget;
+			}
+		};
+		for (ContactModel *contact : mPinned)
+			take(contact);
+		for (auto it = mVisible.cbegin(); it != mVisible.cend(); ++it)
+			take(it.key());
+		for (ContactModel *contact : mPolled)
+			take(contact);
+	}
+	
+	bool changed = false;
+	for (const auto &contact : mContacts) {
+		const bool enabled = resourceList || subscribed.contains(contact.get());
+		shared_ptr<linphone::Friend> linphoneFriend = contact->mLinphoneFriend;
+		if (linphoneFriend->subscribesEnabled() != enabled) {
+			linphoneFriend->edit();
+			linphoneFriend->enableSubscribes(enabled);
+			linphoneFriend->done();
+			changed = true;
+		}
+	}
+	if (changed) {
+		qInfo() << QStringLiteral("Update presence subscriptions: %1 subscribed on %2 contacts.")
+				   .arg(resourceList ? mContacts.size() : subscribed.size()).arg(mContacts.size());
+		mFriendList->updateSubscriptions();
+	}
+}
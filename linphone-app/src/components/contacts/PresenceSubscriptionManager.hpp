@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRESENCE_SUBSCRIPTION_MANAGER_H_
+#define PRESENCE_SUBSCRIPTION_MANAGER_H_
+
+#include <memory>
+
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+// =============================================================================
+
+namespace linphone {
+	class CallLog;
+	class ChatMessage;
+	class FriendList;
+}
+
+class ContactModel;
+class ContactsListModel;
+class QTimer;
+
+// Decide which friends are subscribed to presence. By priority:
+//  1. Contacts of recent conversations (chats and calls).
+//  2. Contacts displayed by the GUI.
+//  3. A rotating batch of the other contacts, subscribed for one poll interval.
+// The total is bounded by `SettingsModel::getMaxPresenceSubscriptions()`.
+// When a resource list server is used, the whole list is a single subscription and all friends are kept.
+class PresenceSubscriptionManager : public QObject {
+	Q_OBJECT
+	
+public:
+	PresenceSubscriptionManager (ContactsListModel *contactsListModel, std::shared_ptr<linphone::FriendList> friendList);
+	
+	// To call once the initial contacts are added: subscriptions are limited before the first subscribe.
+	void init ();
+	
+	void addContact (QSharedPointer<ContactModel> contact, bool pinned = false);
+	void removeContact (QSharedPointer<ContactModel> contact);
+	
+	void setVisible (ContactModel *contact, bool visible);
+	
+private:
+	void initPinnedContacts ();
+	void pin (const QString &sipAddress);
+	void pin (ContactModel *contact);
+	
+	void handleMessagesReceived (const std::list<std::shared_ptr<linphone::ChatMessage>> &messages);
+	void handleCallLogUpdated (const std::shared_ptr<linphone::CallLog> &callLog);
+	
+	bool useResourceList () const;
+	
+	void poll ();
+	void scheduleUpdate ();
+	void update ();
+	
+	ContactsListModel *mContactsListModel = nullptr;
+	std::shared_ptr<linphone::FriendList> mFriendList;
+	
+	QVector<QSharedPointer<ContactModel>> mContacts;
+	QVector<ContactModel *> mPinned;// Most recent first.
+	QHash<ContactModel *, int> mVisible;// Count of views showing the contact.
+	QVector<ContactModel *> mPolled;
+	int mPollIndex = 0;
+	
+	QTimer *mUpdateTimer = nullptr;
+	QTimer *mPollTimer = nullptr;
+};
+
+#endif // PRESENCE_SUBSCRIPTION_MANAGER_H_
@@ -19,12 +19,17 @@
  */
 
 #include <QQmlApplicationEngine>
+#include <QUuid>
+#include <QtConcurrent>
 
 #include "app/App.hpp"
+#include "app/paths/Paths.hpp"
 
 #include "ContentListModel.hpp"
 #include "ContentModel.hpp"
+#include "components/settings/SettingsModel.hpp"
 #include "utils/Constants.hpp"
+#include "utils/ImageCompressor.hpp"
 #include "utils/Utils.hpp"
 
 #include "components/Components.hpp"
@@ -43,6 +48,10 @@ ContentListModel::ContentListModel (ChatMessageModel * message, QObject* parent)
 	}
 }
 
+ContentListModel::~ContentListModel () {
+	cancelPreparingFiles();
+}
+
 int ContentListModel::count(){
 	return mList.count();
 }
@@ -55,6 +64,17 @@ QSharedPointer<ContentModel> ContentListModel::add(std::shared_ptr<linphone::Con
 }
 
 void ContentListModel::addFile(const QString& path){
+	if (!QFile::exists(path))
+		return;
+	
+	SettingsModel *settingsModel = CoreManager::getInstance()->getSettingsModel();
+	if (settingsModel->getImageCompressionEnabled() && ImageCompressor::isCompressible(path, settingsModel->getImageCompressionMaxDimension()))
+		compressImage(path);
+	else
+		addFileContent(path, QFileInfo(path).fileName());
+}
+
+void ContentListModel::addFileContent(const QString& path, const QString& name){
 	QFile file(path);
 	if (!file.exists())
 		return;
@@ -76,7 +96,7 @@ void ContentListModel::addFile(const QString& path){
 		content->setSubtype(Utils::appStringToCoreString(mimeType[1]));
 	}
 	content->setSize(size_t(fileSize)); 
-	content->setName(QFileInfo(file).fileName().toStdString());
+	content->setName(name.toStdString());
 	content->setFilePath(Utils::appStringToCoreString(path));
 	
 	auto modelAdded = add(content);
@@ -84,22 +104,113 @@ void ContentListModel::addFile(const QString& path){
 		modelAdded->createThumbnail(true);	// Was not created because linphone::Content is not considered as a file (yet)
 }
 
+// The compressed copy keeps the name of the original file.
+// The original is sent if the compression fails or doesn't make the file smaller.
+void ContentListModel::compressImage(const QString& path){
+	SettingsModel *settingsModel = CoreManager::getInstance()->getSettingsModel();
+	const int maxDimension = settingsModel->getImageCompressionMaxDimension();
+	const int quality = settingsModel->getImageCompressionQuality();
+	const QString name = QFileInfo(path).fileName();
+	const QString destination = QStringLiteral("%1%2-%3.jpg")
+		.arg(Utils::coreStringToAppString(Paths::getOutgoingImagesDirPath()))
+		.arg(QUuid::createUuid().toString(QUuid::WithoutBraces))
+		.arg(QFileInfo(path).completeBaseName());
+	const int id = ++mPreparingId;
+	const int generation = mGeneration;
+	mPreparingFiles[id] = PreparingFile{ 0.0, destination };
+	emit preparingChanged();
+	
+	// The worker doesn't reference the model: it can be canceled without waiting for it.
+	QFutureInterface<bool> job;
+	job.setProgressRange(0, 100);
+	job.reportStarted();
+	QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+	QObject::connect(watcher, &QFutureWatcher<bool>::progressValueChanged, this, [this, id](int progress) {
+		if (mPreparingFiles.contains(id)) {
+			mPreparingFiles[id].progress = progress / 100.0;
+			emit preparingChanged();
+		}
+	});
+	QObject::connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, id, generation, path, destination, name]() {
+		watcher->deleteLater();
+		if (generation != mGeneration || watcher->isCanceled()) {// Cleared meanwhile.
+			QFile::remove(destination);
+			return;
+		}
+		bool compressed = watcher->result();
+		if (compressed && QFileInfo(destination).size() >= QFileInfo(path).size()) {
+			QFile::remove(destination);
+			compressed = false;
+		}
+		addFileContent(compressed ? destination : path, name);
+		mPreparingFiles.remove(id);// After adding the content: pending messages are sent on this change.
+		emit preparingChanged();
+	});
+	watcher->setFuture(job.future());
+	QtConcurrent::run([job, path, destination, maxDimension, quality]() mutable {
+		const bool compressed = !job.isCanceled() && ImageCompressor::compress(path, destination, maxDimension, quality, [&job](double progress) {
+			job.setProgressValue(int(progress * 100));
+		});
+		if (job.isCanceled())
+			QFile::remove(destination);
+		else
+			job.reportResult(compressed);
+		job.reportFinished();
+	});
+}
+
+// Pending compressions are dropped, their copies are removed by the model or by the canceled workers.
+void ContentListModel::cancelPreparingFiles(){
+	for (QFutureWatcher<bool> *watcher : findChildren<QFutureWatcher<bool> *>())
+		watcher->cancel();
+	for (const PreparingFile &file : mPreparingFiles)
+		QFile::remove(file.destination);
+}
+
 void ContentListModel::remove(ContentModel * model){
 	int count = 0;
 	for(auto it = mList.begin() ; it != mList.end() ; ++count, ++it) {
 		if( it->get() == model) {
 			model->removeThumbnail();
+			if(isCompressedCopy(model->getFilePath()))
+				QFile::remove(model->getFilePath());// Compressed copy that will not be sent.
 			removeRow(count, QModelIndex());
 			return;
 		}
 	}
 }
 
+bool ContentListModel::isCompressedCopy(const QString& path){
+	return !path.isEmpty() && QFileInfo(path).absolutePath() == QFileInfo(Utils::coreStringToAppString(Paths::getOutgoingImagesDirPath())).absolutePath();
+}
+
+void ContentListModel::removeCompressedCopies(const std::shared_ptr<linphone::ChatMessage>& message){
+	if(!message || !message->isOutgoing())
+		return;
+	for(auto content : message->getContents()){
+		QString path = Utils::coreStringToAppString(content->getFilePath());
+		if(isCompressedCopy(path))
+			QFile::remove(path);
+	}
+}
+
+void ContentListModel::removeCompressedCopies(const std::shared_ptr<linphone::ChatRoom>& chatRoom){
+	if(chatRoom)
+		for(auto message : chatRoom->getHistory(0))
+			removeCompressedCopies(message);
+}
+
 void ContentListModel::clear(){
 // Delete thumbnails
 	for(auto contentModel : mList){
 		contentModel.objectCast<ContentModel>()->removeThumbnail();
 	}
+	if(!mPreparingFiles.isEmpty()){
+		++mGeneration;
+		cancelPreparingFiles();
+		mPreparingFiles.clear();
+		emit preparingChanged();
+	}
 	resetData();
 }
 
@@ -174,4 +285,17 @@ void ContentListModel::updateAllTransferData(){
 void ContentListModel::downloaded(){
 	for(auto content : mList)
 		content.objectCast<ContentModel>()->createThumbnail();
+}
+
+int ContentListModel::getPreparingCount() const{
+	return mPreparingFiles.size();
+}
+
+double ContentListModel::getPreparingProgress() const{
+	if(mPreparingFiles.isEmpty())
+		return 0.0;
+	double progress = 0.0;
+	for(const PreparingFile &file : mPreparingFiles)
+		progress += file.progress;
+	return progress / mPreparingFiles.size();
 }
\ No newline at end of file
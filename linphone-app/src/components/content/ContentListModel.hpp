@@ -26,6 +26,7 @@
 // =============================================================================
 #include <QObject>
 #include <QDateTime>
+#include <QHash>
 #include <QString>
 
 #include "app/proxyModel/ProxyListModel.hpp"
@@ -36,8 +37,13 @@ class ChatMessageModel;
 class ContentListModel : public ProxyListModel {
 	Q_OBJECT
 	
+	// Files that are being prepared before being added (images compression).
+	Q_PROPERTY(int preparingCount READ getPreparingCount NOTIFY preparingChanged)
+	Q_PROPERTY(double preparingProgress READ getPreparingProgress NOTIFY preparingChanged)
+	
 public:
 	ContentListModel (ChatMessageModel * message, QObject * parent = nullptr);
+	~ContentListModel ();
 	
 	int count();
 	
@@ -55,14 +61,34 @@ public:
 	void updateAllTransferData();
 	void downloaded();	// Contents have been downloaded, update all contents
 	
+	int getPreparingCount() const;
+	double getPreparingProgress() const;
+	
+	// Compressed copies of sent images are the files of the outgoing messages: they are removed with these messages.
+	static bool isCompressedCopy(const QString& path);
+	static void removeCompressedCopies(const std::shared_ptr<linphone::ChatMessage>& message);
+	static void removeCompressedCopies(const std::shared_ptr<linphone::ChatRoom>& chatRoom);// Whole history.
+	
 signals:
 	void updateTransferDataRequested();
 	void contentsChanged();
+	void preparingChanged();
 	
 private:
+	void addFileContent(const QString& path, const QString& name);
+	void compressImage(const QString& path);
+	void cancelPreparingFiles();
+	
+	struct PreparingFile {
+		double progress;
+		QString destination;// Compressed copy.
+	};
 	
 	ChatMessageModel * mParent;
 	
+	QHash<int, PreparingFile> mPreparingFiles;// By job id.
+	int mPreparingId = 0;
+	int mGeneration = 0;// Incremented when the list is cleared: pending jobs are dropped.
 };
 
 Q_DECLARE_METATYPE(std::shared_ptr<ContentListModel>)
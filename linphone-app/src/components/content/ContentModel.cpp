@@ -22,17 +22,22 @@
 
 #include <QQmlApplicationEngine>
 #include <QDesktopServices>
+#include <QFutureWatcher>
 #include <QImageReader>
 #include <QMessageBox>
+#include <QtConcurrent>
 
 #include "app/App.hpp"
 #include "app/paths/Paths.hpp"
 #include "app/providers/ThumbnailProvider.hpp"
 
 #include "components/chat-events/ChatMessageModel.hpp"
+#include "components/core/CoreManager.hpp"
+#include "components/transfer/TransferScheduler.hpp"
 
-#include "utils/QExifImageHeader.hpp"
+#include "utils/ThumbnailStore.hpp"
 #include "utils/Utils.hpp"
+#include "utils/WaveformStore.hpp"
 #include "utils/Constants.hpp"
 #include "components/Components.hpp"
 
@@ -94,6 +99,16 @@ ConferenceInfoModel * ContentModel::getConferenceInfoModel(){
 	return mConferenceInfoModel.get();
 }
 
+QVariantList ContentModel::getWaveform(){
+	mWaveformRequested = true;
+	if(mWaveform.isEmpty())
+		requestWaveform();
+	QVariantList waveform;
+	for(float value : mWaveform)
+		waveform << value;
+	return waveform;
+}
+
 void ContentModel::setFileOffset(quint64 fileOffset){
 	if( mFileOffset != fileOffset) {
 		mFileOffset = fileOffset;
@@ -110,6 +125,8 @@ void ContentModel::setWasDownloaded(bool wasDownloaded){
 	if( mWasDownloaded != wasDownloaded) {
 		mWasDownloaded = wasDownloaded;
 		emit wasDownloadedChanged();
+		if(mWasDownloaded && mWaveformRequested && mWaveform.isEmpty())
+			requestWaveform();
 	}
 }
 
@@ -150,78 +167,67 @@ int ContentModel::getFileDuration() const {
 	return mContent->getFileDuration();
 }
 
+// The file is read in background: the waveform is cached on disk after the first extraction.
+void ContentModel::requestWaveform(){
+	if(mWaveformRunning || !isVoiceRecording())
+		return;
+	QString path = getFilePath();
+	if(path.isEmpty() || !QFileInfo(path).isFile())// Not downloaded yet.
+		return;
+	mWaveformRunning = true;
+	QFutureWatcher<QVector<float>> *watcher = new QFutureWatcher<QVector<float>>(this);
+	QObject::connect(watcher, &QFutureWatcher<QVector<float>>::finished, this, [this, watcher]() {
+		watcher->deleteLater();
+		mWaveformRunning = false;
+		mWaveform = watcher->result();
+		if(!mWaveform.isEmpty())
+			emit waveformChanged();
+	});
+	watcher->setFuture(WaveformStore::requestWaveform(path));
+}
+
 // Create a thumbnail from the first content that have a file and store it in Appdata
+// The file is read and hashed in background: the thumbnail is set when ready.
 void ContentModel::createThumbnail (const bool& force) {
 	if(force || isFile() || isFileEncrypted() || isFileTransfer()){
-		QString id;
 		QString path = getFilePath();
+		if( path == "")
+			return;
+		setWasDownloaded(QFileInfo(path).isFile());
 		
-		auto appdata = ChatMessageModel::AppDataManager(mChatMessageModel ? QString::fromStdString(mChatMessageModel->getChatMessage()->getAppdata()) : "");
-		
-		if(!appdata.mData.contains(path) 
-				|| !QFileInfo(QString::fromStdString(Paths::getThumbnailsDirPath())+appdata.mData[path]).isFile()){
-			// File don't exist. Create the thumbnail
-			
-			QImage image(path);
-			if( image.isNull()){// Try to determine format from headers
-				QImageReader reader(path);
-				reader.setDecideFormatFromContent(true);
-				QByteArray format = reader.format();
-				if(!format.isEmpty())
-					image = QImage(path, format);
-			}
-			if (!image.isNull()){
-				int rotation = 0;
-				QExifImageHeader exifImageHeader;
-				if (exifImageHeader.loadFromJpeg(path))
-					rotation = int(exifImageHeader.value(QExifImageHeader::ImageTag::Orientation).toShort());
-				QImage thumbnail = image.scaled(
-							Constants::ThumbnailImageFileWidth, Constants::ThumbnailImageFileHeight,
-							Qt::KeepAspectRatio, Qt::SmoothTransformation
-							);
-				
-				if (rotation != 0) {
-					QTransform transform;
-					if (rotation == 3 || rotation == 4)
-						transform.rotate(180);
-					else if (rotation == 5 || rotation == 6)
-						transform.rotate(90);
-					else if (rotation == 7 || rotation == 8)
-						transform.rotate(-90);
-					thumbnail = thumbnail.transformed(transform);
-					if (rotation == 2 || rotation == 4 || rotation == 5 || rotation == 7)
-						thumbnail = thumbnail.mirrored(true, false);
-				}
-				QString uuid = QUuid::createUuid().toString();
-				id = QStringLiteral("%1.jpg").arg(uuid.mid(1, uuid.length() - 2));
-				
-				if (!thumbnail.save(QString::fromStdString(Paths::getThumbnailsDirPath()) + id , "jpg", 100)) {
-					qWarning() << QStringLiteral("Unable to create thumbnail of: `%1`.").arg(path);
-				}else{
-					appdata.mData[path] = id;
-					mAppData.mData[path] = id;
-					if(mChatMessageModel)
-						mChatMessageModel->getChatMessage()->setAppdata(appdata.toString().toStdString());
-				}
-			}
-		}
-		
-		if( path != ""){
-			setWasDownloaded( !path.isEmpty() && QFileInfo(path).isFile());
-			if(appdata.mData.contains(path) && !appdata.mData[path].isEmpty())
-				setThumbnail(QStringLiteral("image://%1/%2").arg(ThumbnailProvider::ProviderId).arg(appdata.mData[path]));
+		auto appdata = mChatMessageModel ? ChatMessageModel::AppDataManager(QString::fromStdString(mChatMessageModel->getChatMessage()->getAppdata())) : mAppData;
+		if(appdata.mData.contains(path) && ThumbnailStore::contains(appdata.mData[path])){
+			setThumbnail(QStringLiteral("image://%1/%2").arg(ThumbnailProvider::ProviderId).arg(appdata.mData[path]));
+			return;
 		}
+		if(!mWasDownloaded || mThumbnailRequestedPath == path)// Already created or not an image.
+			return;
+		mThumbnailRequestedPath = path;
+		QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>(this);
+		QObject::connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, path]() {
+			watcher->deleteLater();
+			QString id = watcher->result();
+			if(id.isEmpty())
+				return;
+			mAppData.mData[path] = id;
+			if(mChatMessageModel){
+				auto appdata = ChatMessageModel::AppDataManager(QString::fromStdString(mChatMessageModel->getChatMessage()->getAppdata()));
+				appdata.mData[path] = id;
+				mChatMessageModel->getChatMessage()->setAppdata(appdata.toString().toStdString());
+			}
+			if(path == getFilePath())
+				setThumbnail(QStringLiteral("image://%1/%2").arg(ThumbnailProvider::ProviderId).arg(id));
+		});
+		watcher->setFuture(QtConcurrent::run([path]() {
+			return ThumbnailStore::getThumbnail(path);
+		}));
 	}
 }
 
+// Thumbnails are shared by contents with the same file: they are not deleted here but evicted by the store.
 void ContentModel::removeThumbnail(){
-	for(QMap<QString, QString>::iterator itData = mAppData.mData.begin() ; itData != mAppData.mData.end() ; ++itData){
-		QString thumbnailPath = QString::fromStdString(Paths::getThumbnailsDirPath()) +itData.value();
-		if( QFileInfo(thumbnailPath).isFile()){
-			QFile(thumbnailPath).remove();
-		}
-	}
 	mAppData.mData.clear();
+	mThumbnailRequestedPath.clear();
 }
 
 void ContentModel::removeDownloadedFile(){
@@ -261,13 +267,19 @@ void ContentModel::downloadFile(){
 	if( !mContent->isFileTransfer()){
 		QMessageBox::warning(nullptr, "Download File", "This file was already downloaded and is no more on the server. Your peer have to resend it if you want to get it");
 	}else
-	{
-		if (!mChatMessageModel->getChatMessage()->downloadContent(mContent))
-			qWarning() << QStringLiteral("Unable to download file of entry %1.").arg(filename);
-	}
+		CoreManager::getInstance()->getTransferScheduler()->download(mChatMessageModel->getChatMessage(), mContent, TransferModel::VisiblePriority);
+}
+
+// Queued downloads of contents that are not shown anymore are paused during calls.
+void ContentModel::setVisible(bool visible){
+	if(mChatMessageModel && mChatMessageModel->getChatMessage())
+		CoreManager::getInstance()->getTransferScheduler()->setPriority(mChatMessageModel->getChatMessage(), mContent, visible ? TransferModel::VisiblePriority : TransferModel::BackgroundPriority);
 }
+
 void ContentModel::cancelDownloadFile(){
 	if(mChatMessageModel && mChatMessageModel->getChatMessage()) {
+		if(CoreManager::getInstance()->getTransferScheduler()->cancel(mChatMessageModel->getChatMessage()) && !mChatMessageModel->isOutgoing())
+			return;
 		if(mChatMessageModel->isOutgoing() ){
 			mChatMessageModel->deleteEvent();// Uploading is cancelling : Delete event to have clean history.
 			emit mChatMessageModel->remove(mChatMessageModel);
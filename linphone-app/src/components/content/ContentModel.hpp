@@ -28,6 +28,8 @@
 #include <QDateTime>
 #include <QString>
 #include <QSharedPointer>
+#include <QVariantList>
+#include <QVector>
 
 #include "components/chat-events/ChatMessageModel.hpp"
 class ChatMessageModel;
@@ -49,6 +51,7 @@ public:
 	Q_PROPERTY(ChatMessageModel * chatMessageModel READ getChatMessageModel CONSTANT)
 	Q_PROPERTY(ConferenceInfoModel * conferenceInfoModel READ getConferenceInfoModel CONSTANT)
 	Q_PROPERTY(QString text READ getUtf8Text CONSTANT)
+	Q_PROPERTY(QVariantList waveform READ getWaveform NOTIFY waveformChanged)// Voice recordings. Empty until extracted.
 	
 	std::shared_ptr<linphone::Content> getContent()const;
 	ChatMessageModel * getChatMessageModel()const;
@@ -59,6 +62,7 @@ public:
 	QString getFilePath() const;
 	QString getUtf8Text() const;
 	ConferenceInfoModel * getConferenceInfoModel();//Create a conference Info if not set
+	QVariantList getWaveform();// Request the waveform if not set
 	
 	void setFileOffset(quint64 fileOffset);
 	void setThumbnail(const QString& data);
@@ -80,6 +84,7 @@ public:
 	void removeDownloadedFile();
 	
 	Q_INVOKABLE void downloadFile();
+	Q_INVOKABLE void setVisible(bool visible);
 	Q_INVOKABLE void cancelDownloadFile();
 	Q_INVOKABLE void openFile (bool showDirectory = false);
 	
@@ -96,12 +101,19 @@ signals:
 	void thumbnailChanged();
 	void fileOffsetChanged();
 	void wasDownloadedChanged();
+	void waveformChanged();
 	
 private:
+	void requestWaveform();
+	
 	std::shared_ptr<linphone::Content> mContent;
 	ChatMessageModel* mChatMessageModel;
 	ChatMessageModel::AppDataManager mAppData;	// Used if there is no Chat Message model set.
 	QSharedPointer<ConferenceInfoModel> mConferenceInfoModel;
+	QString mThumbnailRequestedPath;
+	QVector<float> mWaveform;
+	bool mWaveformRequested = false;
+	bool mWaveformRunning = false;
 };
 Q_DECLARE_METATYPE(QSharedPointer<ContentModel>)
 
@@ -42,18 +42,38 @@ ChatMessageModel * ContentProxyModel::getChatMessageModel() const{
 
 void ContentProxyModel::setChatMessageModel(ChatMessageModel * message){
 	if(message){
-		setSourceModel(message->getContents().get());
+		setContents(message->getContents().get());
 		sort(0);
 	}
 	emit chatMessageModelChanged();
 }
 
 void ContentProxyModel::setContentListModel(ContentListModel * model){
-	setSourceModel(model);
+	setContents(model);
 	sort(0);
 	emit chatMessageModelChanged();
 }
 
+void ContentProxyModel::setContents(ContentListModel * model){
+	ContentListModel * previousModel = qobject_cast<ContentListModel*>(sourceModel());
+	if(previousModel)
+		disconnect(previousModel, &ContentListModel::preparingChanged, this, &ContentProxyModel::preparingChanged);
+	setSourceModel(model);
+	if(model)
+		connect(model, &ContentListModel::preparingChanged, this, &ContentProxyModel::preparingChanged);
+	emit preparingChanged();
+}
+
+int ContentProxyModel::getPreparingCount() const{
+	ContentListModel * model = qobject_cast<ContentListModel*>(sourceModel());
+	return model ? model->getPreparingCount() : 0;
+}
+
+double ContentProxyModel::getPreparingProgress() const{
+	ContentListModel * model = qobject_cast<ContentListModel*>(sourceModel());
+	return model ? model->getPreparingProgress() : 0.0;
+}
+
 void ContentProxyModel::addFile(const QString& path){
 	ContentListModel* model = qobject_cast<ContentListModel*>(sourceModel());
 	model->addFile(path);
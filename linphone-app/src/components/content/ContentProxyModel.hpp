@@ -39,8 +39,12 @@ class ContentProxyModel : public QSortFilterProxyModel {
 public:
 	ContentProxyModel (QObject *parent = nullptr);	
 	Q_PROPERTY(ChatMessageModel * chatMessageModel READ getChatMessageModel WRITE setChatMessageModel NOTIFY chatMessageModelChanged)
+	Q_PROPERTY(int preparingCount READ getPreparingCount NOTIFY preparingChanged)
+	Q_PROPERTY(double preparingProgress READ getPreparingProgress NOTIFY preparingChanged)
 	
 	ChatMessageModel * getChatMessageModel() const;
+	int getPreparingCount() const;
+	double getPreparingProgress() const;
 	
 	void setChatMessageModel(ChatMessageModel * message);
 	Q_INVOKABLE void setContentListModel(ContentListModel * model);
@@ -50,8 +54,11 @@ public:
 	
 signals:
 	void chatMessageModelChanged();
+	void preparingChanged();
 	
 protected:
+	void setContents(ContentListModel * model);
+	
 	virtual bool filterAcceptsRow (int sourceRow, const QModelIndex &sourceParent) const override;
 	virtual bool lessThan (const QModelIndex &left, const QModelIndex &right) const override;
 	
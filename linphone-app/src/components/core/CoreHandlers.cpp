@@ -18,6 +18,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QtDebug>
 #include <QThread>
@@ -213,10 +214,12 @@ void CoreHandlers::onMessageReceived (
 }
 
 void CoreHandlers::onMessagesReceived (
-		const shared_ptr<linphone::Core> &core,
+		const shared_ptr<linphone::Core> &,
 		const shared_ptr<linphone::ChatRoom> &chatRoom,
 		const std::list<shared_ptr<linphone::ChatMessage>> &messages
 		) {
+	QElapsedTimer receivedTimer;
+	receivedTimer.start();
 	std::list<shared_ptr<linphone::ChatMessage>> messagesToSignal;
 	std::list<shared_ptr<linphone::ChatMessage>> messagesToNotify;
 	CoreManager *coreManager = CoreManager::getInstance();
@@ -255,7 +258,7 @@ void CoreHandlers::onMessagesReceived (
 	if( messagesToSignal.size() > 0)
 		emit messagesReceived(messagesToSignal);
 	if( messagesToNotify.size() > 0)
-		app->getNotifier()->notifyReceivedMessages(messagesToNotify);
+		app->getNotifier()->notifyReceivedMessages(messagesToNotify, receivedTimer);
 	else if( notNotifyReasons.size() > 0)
 		qInfo() << "Notification received but was not selected to popup. Reasons : \n" << notNotifyReasons.join("\n");
 	// 3. Notify with sound.
@@ -264,7 +267,7 @@ void CoreHandlers::onMessagesReceived (
 			return;
 	
 		if ( !app->hasFocus() || !CoreManager::getInstance()->getTimelineListModel()->getChatRoomModel(chatRoom, false) )
-			core->playLocal(Utils::appStringToCoreString(settingsModel->getChatNotificationSoundPath()));
+			app->getNotifier()->playReceivedMessageSound();
 	}
 }
 
@@ -28,6 +28,8 @@
 #include "config.h"
 
 #include "app/paths/Paths.hpp"
+#include "app/profiler/StartupProfiler.hpp"
+#include "components/call/CallQualityArchive.hpp"
 #include "components/calls/CallsListModel.hpp"
 #include "components/chat/ChatModel.hpp"
 #include "components/chat-room/ChatRoomModel.hpp"
@@ -37,13 +39,17 @@
 #include "components/history/HistoryModel.hpp"
 #include "components/ldap/LdapListModel.hpp"
 #include "components/recorder/RecorderManager.hpp"
+#include "components/search/SearchResultCache.hpp"
 #include "components/settings/AccountSettingsModel.hpp"
 #include "components/settings/SettingsModel.hpp"
 #include "components/sip-addresses/SipAddressesModel.hpp"
 #include "components/timeline/TimelineListModel.hpp"
+#include "components/transfer/TransferScheduler.hpp"
 
 #include "utils/Utils.hpp"
 #include "utils/Constants.hpp"
+#include "utils/SipAddressCache.hpp"
+#include "utils/ThumbnailStore.hpp"
 
 #if defined(Q_OS_MACOS)
 #include "event-count-notifier/EventCountNotifierMacOs.hpp"
@@ -91,14 +97,19 @@ CoreManager::~CoreManager(){
 // -----------------------------------------------------------------------------
 
 void CoreManager::initCoreManager(){
+	StartupProfiler::Stage stage("core: models");
 	qInfo() << "Init CoreManager";
 	mAccountSettingsModel = new AccountSettingsModel(this);
+	QObject::connect(mAccountSettingsModel, &AccountSettingsModel::accountsChanged, this, &SipAddressCache::clearInterpretedUrls);
+	QObject::connect(mAccountSettingsModel, &AccountSettingsModel::defaultAccountChanged, this, &SipAddressCache::clearInterpretedUrls);
 	mSettingsModel = new SettingsModel(this);
 	mCallsListModel = new CallsListModel(this);
 	mChatModel = new ChatModel(this);
+	mTransferScheduler = new TransferScheduler(this);
 	mContactsListModel = new ContactsListModel(this);
-	mContactsImporterListModel = new ContactsImporterListModel(this);
-	mLdapListModel = new LdapListModel(this);
+	QObject::connect(mContactsListModel, &ContactsListModel::contactAdded, this, &SearchResultCache::clear);
+	QObject::connect(mContactsListModel, &ContactsListModel::contactRemoved, this, &SearchResultCache::clear);
+	QObject::connect(mContactsListModel, &ContactsListModel::contactUpdated, this, &SearchResultCache::clear);
 	mSipAddressesModel = new SipAddressesModel(this);
 	mEventCountNotifier = new EventCountNotifier(this);
 	mTimelineListModel = new TimelineListModel(this);
@@ -120,6 +131,23 @@ CoreManager *CoreManager::getInstance (){
 }
 
 
+ContactsImporterListModel *CoreManager::getContactsImporterListModel () {
+	if (!mContactsImporterListModel)
+		mContactsImporterListModel = new ContactsImporterListModel(this);
+	return mContactsImporterListModel;
+}
+
+LdapListModel *CoreManager::getLdapListModel () {
+	if (!mLdapListModel)
+		mLdapListModel = new LdapListModel(this);
+	return mLdapListModel;
+}
+
+void CoreManager::loadDeferredModels () {
+	getContactsImporterListModel();
+	getLdapListModel();
+}
+
 HistoryModel* CoreManager::getHistoryModel(){
 	if(!mHistoryModel){
 		mHistoryModel = new HistoryModel(this);
@@ -128,6 +156,12 @@ HistoryModel* CoreManager::getHistoryModel(){
 	return mHistoryModel;
 }
 
+CallQualityArchive *CoreManager::getCallQualityArchive () {
+	if (!mCallQualityArchive)
+		mCallQualityArchive = new CallQualityArchive(this);
+	return mCallQualityArchive;
+}
+
 RecorderManager* CoreManager::getRecorderManager(){
 	if(!mRecorderManager){
 		mRecorderManager = new RecorderManager(this);
@@ -145,12 +179,17 @@ void CoreManager::init (QObject *parent, const QString &configPath) {
 
 void CoreManager::uninit () {
 	if (mInstance) {
+		if (mInstance->mSipAddressesModel)
+			mInstance->mSipAddressesModel->saveSnapshot();
 		mInstance->stopIterate();
 		auto core = mInstance->mCore;
 		mInstance->lockVideoRender();// Stop do iterations. We have to protect GUI.
 		mInstance->unlockVideoRender();
 		delete mInstance;	// This will also remove stored Linphone objects.
 		mInstance = nullptr;
+		SipAddressCache::clearInterpretedUrls();
+		SearchResultCache::clear();
+		ThumbnailStore::save();
 		core->stop();
 		if( core->getGlobalState() != linphone::GlobalState::Off)
 			qWarning() << "Core is not off after stopping it. It may result to have multiple core instance.";
@@ -250,6 +289,7 @@ void CoreManager::setResourcesPaths () {
 // -----------------------------------------------------------------------------
 
 void CoreManager::createLinphoneCore (const QString &configPath) {
+	StartupProfiler::Stage stage("core: creation");
 	qInfo() << QStringLiteral("Launch async core creation.");
 	
 	// Migration of configuration and database files from GTK version of Linphone.
@@ -33,6 +33,7 @@ class QTimer;
 
 class AbstractEventCountNotifier;
 class AccountSettingsModel;
+class CallQualityArchive;
 class CallsListModel;
 class ChatModel;
 class ChatRoomModel;
@@ -47,6 +48,7 @@ class SettingsModel;
 class SipAddressesModel;
 class VcardModel;
 class TimelineListModel;
+class TransferScheduler;
 
 
 class CoreManager : public QObject {
@@ -73,6 +75,7 @@ public:
 	
 	HistoryModel* getHistoryModel();
 	RecorderManager* getRecorderManager();
+	CallQualityArchive *getCallQualityArchive ();
 	
 	// ---------------------------------------------------------------------------
 	// Video render lock.
@@ -100,10 +103,7 @@ public:
 		return mContactsListModel;
 	}
 	
-	ContactsImporterListModel *getContactsImporterListModel () const {
-		Q_CHECK_PTR(mContactsImporterListModel);
-		return mContactsImporterListModel;
-	}
+	ContactsImporterListModel *getContactsImporterListModel ();
 	
 	TimelineListModel *getTimelineListModel () const {
 		return mTimelineListModel;
@@ -123,9 +123,11 @@ public:
 		Q_CHECK_PTR(mAccountSettingsModel);
 		return mAccountSettingsModel;
 	}
-	LdapListModel *getLdapListModel() const{
-		return mLdapListModel;
-	}
+	LdapListModel *getLdapListModel();
+	
+	// The contacts importer and LDAP models: the main window does not use them. They are built on first use
+	// or after the first frame. Other models are used by the main window and are built with the core manager.
+	void loadDeferredModels ();
 	
 	AbstractEventCountNotifier * getEventCountNotifier();
 	
@@ -133,6 +135,11 @@ public:
 		return mChatModel;
 	}
 	
+	TransferScheduler *getTransferScheduler () const {
+		Q_CHECK_PTR(mTransferScheduler);
+		return mTransferScheduler;
+	}
+	
 	static CoreManager *getInstance ();
 	
 	// ---------------------------------------------------------------------------
@@ -219,6 +226,7 @@ private:
 	ContactsImporterListModel *mContactsImporterListModel = nullptr;
 	TimelineListModel *mTimelineListModel = nullptr;
 	ChatModel *mChatModel = nullptr;
+	TransferScheduler *mTransferScheduler = nullptr;
 	
 	SipAddressesModel *mSipAddressesModel = nullptr;
 	SettingsModel *mSettingsModel = nullptr;
@@ -229,6 +237,7 @@ private:
 	HistoryModel * mHistoryModel = nullptr;
 	LdapListModel *mLdapListModel = nullptr;
 	RecorderManager* mRecorderManager = nullptr;
+	CallQualityArchive *mCallQualityArchive = nullptr;
 	
 	QTimer *mCbsTimer = nullptr;
 	
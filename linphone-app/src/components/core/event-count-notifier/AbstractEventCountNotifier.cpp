@@ -82,7 +82,7 @@ void AbstractEventCountNotifier::internalnotifyEventCount () {
 
 // Get missed call from a chat (useful for showing bubbles on Timelines)
 int AbstractEventCountNotifier::getMissedCallCount(const QString &peerAddress, const QString &localAddress) const{
-	auto it = mMissedCalls.find({ Utils::cleanSipAddress(peerAddress), Utils::cleanSipAddress(localAddress) });
+	auto it = mMissedCalls.find({ SipAddressCache::getCleanHandle(peerAddress), SipAddressCache::getCleanHandle(localAddress) });
 	if (it != mMissedCalls.cend()) 
 		return *it;
 	else
@@ -90,7 +90,7 @@ int AbstractEventCountNotifier::getMissedCallCount(const QString &peerAddress, c
 }
 // Get missed call from a chat (useful for showing bubbles on Timelines)
 int AbstractEventCountNotifier::getMissedCallCountFromLocal(const QString &localAddress) const{
-	QString cleanAddress = Utils::cleanSipAddress(localAddress);
+	SipAddressHandle cleanAddress = SipAddressCache::getCleanHandle(localAddress);
 	int count = 0;
 	for(auto it = mMissedCalls.cbegin() ; it != mMissedCalls.cend() ; ++it){
 		if(it.key().second == cleanAddress)
@@ -128,7 +128,7 @@ void AbstractEventCountNotifier::handleResetAllMissedCalls () {
 
 
 void AbstractEventCountNotifier::handleResetMissedCalls (ChatRoomModel *chatRoomModel) {
-  auto it = mMissedCalls.find({ Utils::cleanSipAddress(chatRoomModel->getPeerAddress()), Utils::cleanSipAddress(chatRoomModel->getLocalAddress()) });
+  auto it = mMissedCalls.find({ SipAddressCache::getCleanHandle(chatRoomModel->getPeerAddress()), SipAddressCache::getCleanHandle(chatRoomModel->getLocalAddress()) });
   if (it != mMissedCalls.cend()) {
     mMissedCalls.erase(it);
     internalnotifyEventCount();
@@ -136,11 +136,11 @@ void AbstractEventCountNotifier::handleResetMissedCalls (ChatRoomModel *chatRoom
 }
 
 void AbstractEventCountNotifier::handleCallMissed (CallModel *callModel) {
-  ++mMissedCalls[{ Utils::cleanSipAddress(callModel->getPeerAddress()), Utils::cleanSipAddress(callModel->getLocalAddress()) }];
+  ++mMissedCalls[{ SipAddressCache::getCleanHandle(callModel->getPeerAddress()), SipAddressCache::getCleanHandle(callModel->getLocalAddress()) }];
   internalnotifyEventCount();
 }
 
 void AbstractEventCountNotifier::handleCallMissed (const QString& localAddress, const QString& peerAddress) {
-  ++mMissedCalls[{ peerAddress, localAddress }];
+  ++mMissedCalls[{ SipAddressCache::getCleanHandle(peerAddress), SipAddressCache::getCleanHandle(localAddress) }];
   internalnotifyEventCount();
 }
@@ -27,6 +27,8 @@
 #include <QObject>
 #include <QPair>
 
+#include "utils/SipAddressCache.hpp"
+
 // =============================================================================
 
 namespace linphone {
@@ -69,7 +71,7 @@ protected:
 	virtual void notifyEventCount (int n) = 0;
 	
 private:
-	using ConferenceId = QPair<QString, QString>;
+	using ConferenceId = QPair<SipAddressHandle, SipAddressHandle>;
 	
 	void internalnotifyEventCount ();
 	
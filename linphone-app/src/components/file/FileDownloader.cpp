@@ -18,7 +18,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <QTest>
+#include <QtConcurrent>
+#include <algorithm>
 #include "app/paths/Paths.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/settings/SettingsModel.hpp"
@@ -61,6 +62,14 @@ static QString getDownloadFilePath (const QString &folder, const QUrl &url, cons
 	return fileName;
 }
 
+// Partial downloads of an url always use the same file: they can be resumed.
+static QString getPartFilePath (const QString &folder, const QUrl &url) {
+	QString fileName = QFileInfo(url.path()).fileName();
+	if (fileName.isEmpty())
+		fileName = cDefaultFileName;
+	return folder + fileName + ".part";
+}
+
 static bool isHttpRedirect (QNetworkReply *reply) {
 	Q_CHECK_PTR(reply);
 	int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
@@ -70,18 +79,97 @@ static bool isHttpRedirect (QNetworkReply *reply) {
 
 // -----------------------------------------------------------------------------
 
+FileDownloader::~FileDownloader () {
+	stopRequests();
+	if (mPartFile.isOpen()) {
+		saveState();
+		mPartFile.close();
+	}
+}
+
 void FileDownloader::download () {
 	if (mDownloading) {
 		qWarning() << "Unable to download file. Already downloading!";
 		return;
 	}
-	setDownloading(true);
 	
+	if (mDownloadFolder.isEmpty()) {
+		if(CoreManager::isInstanciated())
+			mDownloadFolder = CoreManager::getInstance()->getSettingsModel()->getDownloadFolder();
+		else
+			mDownloadFolder =  QDir::cleanPath(Utils::coreStringToAppString(Paths::getDownloadDirPath ()) + QDir::separator());
+		emit downloadFolderChanged(mDownloadFolder);
+	}
+	
+	Q_ASSERT(!mPartFile.isOpen());
+	mStopping = false;
+	mPartFile.setFileName(getPartFilePath(QDir::cleanPath(mDownloadFolder) + QDir::separator(), mUrl));
+	mHash.reset();
+	mStreamedBytes = 0;
+	if (!loadState()) {
+		removePartialFiles();
+		mSegments = { Segment() };
+		mValidator.clear();
+		setTotalBytes(0);
+	} else
+		qInfo() << QStringLiteral("Resume download of %1 from `%2`.").arg(mUrl.toString(), mPartFile.fileName());
+	
+	if (!mPartFile.open(QIODevice::ReadWrite)) {
+		emitOutputError();
+		emit downloadFailed();
+		return;
+	}
+	if (mSegments.size() == 1 && mSegments[0].received > 0) {// Streamed hash: add what was already downloaded.
+		qint64 remaining = mSegments[0].received;
+		while (remaining > 0) {
+			QByteArray data = mPartFile.read(qMin(remaining, qint64(65536)));
+			if (data.isEmpty())
+				break;
+			mHash.addData(data);
+			remaining -= data.size();
+		}
+	}
+	
+	setDownloading(true);
+	updateReadBytes();
+	streamData();
+	for (int i = 0; i < mSegments.size(); ++i)
+		if (!mSegments[i].isFinished())
+			startSegment(i);
+	if (std::all_of(mSegments.cbegin(), mSegments.cend(), [](const Segment &segment) { return segment.isFinished(); }))
+		completeDownload();
+	else {
+		mTimeoutReadBytes = mReadBytes;
+		mTimeout.start();
+	}
+}
+
+bool FileDownloader::remove () {
+	if (!mDownloading)
+		removePartialFiles();
+	return mDestinationFile.exists() && !mDestinationFile.isOpen() && mDestinationFile.remove();
+}
+
+void FileDownloader::emitOutputError () {
+	qWarning() << QStringLiteral("Could not write into `%1` (%2).")
+				  .arg(mPartFile.fileName()).arg(mPartFile.errorString());
+}
+
+// -----------------------------------------------------------------------------
+
+void FileDownloader::startSegment (int index) {
+	Segment &segment = mSegments[index];
 	QNetworkRequest request(mUrl);
 	request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
-	mNetworkReply = mManager.get(request);
+	const qint64 offset = segment.start + segment.received;
+	if (offset > 0 || segment.end >= 0) {
+		request.setRawHeader("Range", "bytes=" + QByteArray::number(offset) + "-" + (segment.end >= 0 ? QByteArray::number(segment.end) : QByteArray()));
+		if (!mValidator.isEmpty())
+			request.setRawHeader("If-Range", mValidator);
+	}
+	segment.reply = mManager.get(request);
 	
-	QNetworkReply *data = mNetworkReply.data();
+	QNetworkReply *data = segment.reply.data();
 	
 	QObject::connect(data, &QNetworkReply::readyRead, this, &FileDownloader::handleReadyData);
 	QObject::connect(data, &QNetworkReply::finished, this, &FileDownloader::handleDownloadFinished);
@@ -90,78 +178,340 @@ void FileDownloader::download () {
 #else
 	QObject::connect(data, QNonConstOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::error), this, &FileDownloader::handleError);
 #endif
-	QObject::connect(data, &QNetworkReply::downloadProgress, this, &FileDownloader::handleDownloadProgress);
 	
 #if QT_CONFIG(ssl)
 	QObject::connect(data, &QNetworkReply::sslErrors, this, &FileDownloader::handleSslErrors);
 #endif
+}
+
+FileDownloader::Segment *FileDownloader::getSegment (QNetworkReply *reply) {
+	for (Segment &segment : mSegments)
+		if (reply && segment.reply == reply)
+			return &segment;
+	return nullptr;
+}
+
+// Check the status of the first response of a request. The download may be restarted or split.
+void FileDownloader::handleResponse (Segment &segment) {
+	QNetworkReply *reply = segment.reply;
+	if (reply->property("checked").toBool())
+		return;
+	reply->setProperty("checked", true);
 	
-	if (mDownloadFolder.isEmpty()) {
-		if(CoreManager::isInstanciated())
-			mDownloadFolder = CoreManager::getInstance()->getSettingsModel()->getDownloadFolder();
-		else
-			mDownloadFolder =  QDir::cleanPath(Utils::coreStringToAppString(Paths::getDownloadDirPath ()) + QDir::separator());
-		emit downloadFolderChanged(mDownloadFolder);
+	const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+	QByteArray validator = reply->rawHeader("ETag");
+	if (validator.isEmpty() || validator.startsWith("W/"))// Weak ETags cannot be used with If-Range.
+		validator = reply->rawHeader("Last-Modified");
+	
+	if (statusCode == 206) {
+		const QByteArray contentRange = reply->rawHeader("Content-Range");// bytes <first>-<last>/<total>
+		const qint64 total = contentRange.mid(contentRange.lastIndexOf('/') + 1).toLongLong();
+		if (total > 0)
+			setTotalBytes(total);
+		if (mValidator.isEmpty())
+			mValidator = validator;
+		return;
 	}
 	
-	Q_ASSERT(!mDestinationFile.isOpen());
-	mDestinationFile.setFileName(getDownloadFilePath(QDir::cleanPath(mDownloadFolder) + QDir::separator(), mUrl, mOverwriteFile));
-	if (!mDestinationFile.open(QIODevice::WriteOnly))
-		emitOutputError();
-	else {
-		mTimeoutReadBytes = 0;
-		mTimeout.start();
+	// Full content.
+	mValidator = validator;
+	setTotalBytes(reply->header(QNetworkRequest::ContentLengthHeader).toLongLong());
+	if (segment.start + segment.received > 0) {// Range ignored or file changed on server: restart from scratch.
+		qWarning() << QStringLiteral("Unable to resume download of %1. Restart it.").arg(mUrl.toString());
+		for (Segment &other : mSegments)
+			if (&other != &segment && other.reply) {
+				QNetworkReply *otherReply = other.reply;
+				other.reply = nullptr;
+				otherReply->abort();
+				otherReply->deleteLater();
+			}
+		Segment restarted;
+		restarted.reply = reply;
+		mSegments = { restarted };
+		mPartFile.resize(0);
+		mHash.reset();
+		updateReadBytes();
+		if (mStreamedBytes > 0) {
+			mStreamedBytes = 0;
+			emit dataReset();
+		}
+		return;
 	}
+	
+	if (mSegments.size() == 1 && mSegmentCount > 1 && reply->rawHeader("Accept-Ranges") == "bytes")
+		splitSegments();
 }
 
-bool FileDownloader::remove () {
-	return mDestinationFile.exists() && !mDestinationFile.isOpen() && mDestinationFile.remove();
+// The first request continues up to the end of the first segment. Others are requested in parallel.
+void FileDownloader::splitSegments () {
+	if (mTotalBytes < 2 * MinSegmentSize)
+		return;
+	const int count = int(qMin(qint64(mSegmentCount), mTotalBytes / MinSegmentSize));
+	const qint64 size = mTotalBytes / count;
+	mSegments[0].end = size - 1;
+	for (int i = 1; i < count; ++i) {
+		Segment segment;
+		segment.start = i * size;
+		segment.end = i == count - 1 ? mTotalBytes - 1 : (i + 1) * size - 1;
+		mSegments << segment;
+	}
+	qInfo() << QStringLiteral("Download %1 with %2 segments.").arg(mUrl.toString()).arg(count);
+	for (int i = 1; i < count; ++i)
+		startSegment(i);
 }
 
-void FileDownloader::emitOutputError () {
-	qWarning() << QStringLiteral("Could not write into `%1` (%2).")
-				  .arg(mDestinationFile.fileName()).arg(mDestinationFile.errorString());
-	mNetworkReply->abort();
+void FileDownloader::updateReadBytes () {
+	qint64 readBytes = 0;
+	for (const Segment &segment : mSegments)
+		readBytes += segment.received;
+	setReadBytes(readBytes);
+}
+
+// Segments are sorted: send what follows the streamed bytes until the first gap.
+void FileDownloader::streamData () {
+	if (!isSignalConnected(QMetaMethod::fromSignal(&FileDownloader::dataReceived)))
+		return;
+	for (const Segment &segment : mSegments) {
+		if (segment.start > mStreamedBytes)
+			break;
+		const qint64 end = segment.start + segment.received;
+		if (end <= mStreamedBytes || !mPartFile.seek(mStreamedBytes))
+			continue;
+		while (mStreamedBytes < end) {
+			const QByteArray data = mPartFile.read(qMin(end - mStreamedBytes, qint64(65536)));
+			if (data.isEmpty())
+				return;
+			mStreamedBytes += data.size();
+			emit dataReceived(data);
+		}
+	}
 }
 
-void FileDownloader::cleanDownloadEnd () {
+// -----------------------------------------------------------------------------
+
+static QString getStateFilePath (const QFile &partFile) {
+	return partFile.fileName() + ".state";
+}
+
+bool FileDownloader::loadState () {
+	QFile file(getStateFilePath(mPartFile));
+	if (!file.open(QIODevice::ReadOnly) || !mPartFile.exists())
+		return false;
+	const QJsonObject state = QJsonDocument::fromJson(file.readAll()).object();
+	if (state.value("url").toString() != mUrl.toString())
+		return false;
+	
+	const qint64 partSize = mPartFile.size();
+	QVector<Segment> segments;
+	for (const QJsonValue &value : state.value("segments").toArray()) {
+		const QJsonArray fields = value.toArray();
+		Segment segment;
+		segment.start = fields.at(0).toVariant().toLongLong();
+		segment.end = fields.at(1).toVariant().toLongLong();
+		// Bytes after the end of the part file have not been written.
+		segment.received = qBound(qint64(0), fields.at(2).toVariant().toLongLong(), qMax(qint64(0), partSize - segment.start));
+		segments << segment;
+	}
+	if (segments.isEmpty())
+		return false;
+	mSegments = segments;
+	mValidator = state.value("validator").toString().toLatin1();
+	setTotalBytes(state.value("total").toVariant().toLongLong());
+	return true;
+}
+
+void FileDownloader::saveState () {
+	if (mPartFile.isOpen())
+		mPartFile.flush();
+	QJsonArray segments;
+	for (const Segment &segment : mSegments)
+		segments.append(QJsonArray({ QString::number(segment.start), QString::number(segment.end), QString::number(segment.received) }));
+	QJsonObject state;
+	state["url"] = mUrl.toString();
+	state["validator"] = QString::fromLatin1(mValidator);
+	state["total"] = QString::number(mTotalBytes);
+	state["segments"] = segments;
+	
+	QSaveFile file(getStateFilePath(mPartFile));
+	if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(state).toJson(QJsonDocument::Compact)) == -1 || !file.commit())
+		qWarning() << QStringLiteral("Unable to save download state into `%1`.").arg(file.fileName());
+}
+
+void FileDownloader::removePartialFiles () {
+	if (mPartFile.fileName().isEmpty())
+		return;
+	if (mPartFile.isOpen())
+		mPartFile.close();
+	QFile::remove(mPartFile.fileName());
+	QFile::remove(getStateFilePath(mPartFile));
+}
+
+// -----------------------------------------------------------------------------
+
+void FileDownloader::completeDownload () {
+	mTimeout.stop();
+	mPartFile.close();
+	if (mChecksum.isEmpty())
+		finishDownload(QByteArray());
+	else if (mSegments.size() == 1)
+		finishDownload(mHash.result().toHex());
+	else {// Segments were not received in order: hash the file out of the GUI thread.
+		QFutureWatcher<QByteArray> *watcher = new QFutureWatcher<QByteArray>(this);
+		QObject::connect(watcher, &QFutureWatcher<QByteArray>::finished, this, [this, watcher]() {
+			watcher->deleteLater();
+			finishDownload(watcher->result());
+		});
+		const QString filePath = mPartFile.fileName();
+		watcher->setFuture(QtConcurrent::run([filePath]() {
+			QFile file(filePath);
+			QCryptographicHash hash(QCryptographicHash::Sha256);
+			if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file))
+				return QByteArray();
+			return hash.result().toHex();
+		}));
+	}
+}
+
+void FileDownloader::finishDownload (const QByteArray &checksum) {
+	if (!mChecksum.isEmpty() && checksum != mChecksum.toLower().toLatin1()) {
+		qWarning() << QStringLiteral("Download of %1 failed: bad checksum (%2, expected %3).")
+					  .arg(mUrl.toString()).arg(QString::fromLatin1(checksum)).arg(mChecksum);
+		failDownload(false);
+		return;
+	}
+	
+	const QString stateFilePath = getStateFilePath(mPartFile);
+	mDestinationFile.setFileName(getDownloadFilePath(QDir::cleanPath(mDownloadFolder) + QDir::separator(), mUrl, mOverwriteFile));
+	if (!mPartFile.rename(mDestinationFile.fileName())) {
+		qWarning() << QStringLiteral("Could not move `%1` to `%2` (%3).")
+					  .arg(mPartFile.fileName()).arg(mDestinationFile.fileName()).arg(mPartFile.errorString());
+		failDownload(false);
+		return;
+	}
+	QFile::remove(stateFilePath);
+	mSegments.clear();
+	qInfo() << QStringLiteral("Download of %1 finished to %2").arg(mUrl.toString(), mDestinationFile.fileName());
+	setDownloading(false);
+	emit downloadFinished(mDestinationFile.fileName());
+}
+
+void FileDownloader::failDownload (bool keepPartialFiles) {
 	mTimeout.stop();
-	mNetworkReply->deleteLater();
+	stopRequests();
+	if (keepPartialFiles) {
+		saveState();
+		mPartFile.close();
+	} else
+		removePartialFiles();
+	mSegments.clear();
 	setDownloading(false);
+	emit downloadFailed();
+}
+
+void FileDownloader::stopRequests () {
+	mStopping = true;
+	for (Segment &segment : mSegments)
+		if (segment.reply) {
+			QNetworkReply *reply = segment.reply;
+			segment.reply = nullptr;
+			reply->abort();
+			reply->deleteLater();
+		}
 }
 
+// -----------------------------------------------------------------------------
+
 void FileDownloader::handleReadyData () {
-	QByteArray data = mNetworkReply->readAll();
-	if (mDestinationFile.write(data) == -1)
+	QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+	Segment *segment = getSegment(reply);
+	if (!segment)
+		return;
+	handleResponse(*segment);
+	segment = getSegment(reply);// Segments may have been restarted or split.
+	if (!segment)
+		return;
+	
+	QByteArray data = reply->readAll();
+	if (segment->end >= 0)// Do not overlap the next segment.
+		data.truncate(int(qMin(qint64(data.size()), segment->end - segment->start - segment->received + 1)));
+	if (!mPartFile.seek(segment->start + segment->received) || mPartFile.write(data) == -1) {
 		emitOutputError();
+		failDownload(true);
+		return;
+	}
+	if (mSegments.size() == 1)
+		mHash.addData(data);
+	segment->received += data.size();
+	if (!data.isEmpty())// Retries are only counted while no progress is made.
+		segment->retries = 0;
+	updateReadBytes();
+	streamData();
+	
+	if (segment->isFinished() && reply->isRunning()) {// The first request of a split download.
+		segment->reply = nullptr;
+		reply->abort();
+		reply->deleteLater();
+		if (std::all_of(mSegments.cbegin(), mSegments.cend(), [](const Segment &segment) { return segment.isFinished(); }))
+			completeDownload();
+	}
 }
 
 void FileDownloader::handleDownloadFinished() {
-	if (mNetworkReply->error() != QNetworkReply::NoError)
+	QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+	Segment *segment = getSegment(reply);
+	if (!segment || reply->error() != QNetworkReply::NoError)
 		return;
 	
-	if (isHttpRedirect(mNetworkReply)) {
+	if (isHttpRedirect(reply)) {
 		qWarning() << QStringLiteral("Request was redirected.");
-		mDestinationFile.remove();
-		cleanDownloadEnd();
-		emit downloadFailed();
-	} else {
-		qInfo() << QStringLiteral("Download of %1 finished to %2").arg(mUrl.toString(), mDestinationFile.fileName());
-		mDestinationFile.close();
-		cleanDownloadEnd();
-		emit downloadFinished(mDestinationFile.fileName());
+		failDownload(false);
+		return;
+	}
+	segment->reply = nullptr;
+	reply->deleteLater();
+	// An open-ended segment goes up to the end of the file: it can only be checked against the total size, if known.
+	const qint64 end = segment->start + segment->received;
+	const bool isComplete = segment->end >= 0
+		? segment->isFinished()
+		: (mTotalBytes > 0 ? end == mTotalBytes : segment->received > 0);
+	if (!isComplete || (mTotalBytes > 0 && end > mTotalBytes)) {
+		qWarning() << QStringLiteral("Download of %1 failed: unexpected end of data.").arg(mUrl.toString());
+		failDownload(false);
+		return;
 	}
+	if (segment->end < 0)
+		segment->end = end - 1;
+	if (std::all_of(mSegments.cbegin(), mSegments.cend(), [](const Segment &segment) { return segment.isFinished(); }))
+		completeDownload();
 }
 
 void FileDownloader::handleError (QNetworkReply::NetworkError code) {
+	QNetworkReply *reply = qobject_cast<QNetworkReply *>(sender());
+	Segment *segment = getSegment(reply);
+	if (!segment || mStopping)
+		return;
+	
 	if (code != QNetworkReply::OperationCanceledError)
 		qWarning() << QStringLiteral("Download of %1 failed: %2")
-					  .arg(mUrl.toString()).arg(mNetworkReply->errorString());
-	mDestinationFile.remove();
+					  .arg(mUrl.toString()).arg(reply->errorString());
+	segment->reply = nullptr;
+	reply->deleteLater();
 	
-	cleanDownloadEnd();
-	
-	emit downloadFailed();
+	if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 416) {// Bad range: partial data cannot be used.
+		failDownload(false);
+		return;
+	}
+	saveState();
+	if (segment->retries++ < MaxRetries) {
+		const int index = int(segment - mSegments.data());
+		const int delay = RetryDelay << (segment->retries - 1);
+		qInfo() << QStringLiteral("Retry download of %1 in %2 ms.").arg(mUrl.toString()).arg(delay);
+		QTimer::singleShot(delay, this, [this, index]() {
+			if (mDownloading && index < mSegments.size() && !mSegments[index].reply && !mSegments[index].isFinished())
+				startSegment(index);
+		});
+	} else
+		failDownload(true);
 }
 
 void FileDownloader::handleSslErrors (const QList<QSslError> &sslErrors) {
@@ -173,17 +523,17 @@ void FileDownloader::handleSslErrors (const QList<QSslError> &sslErrors) {
 #endif
 }
 
+// A stalled connection is aborted: it will be retried from where it stopped.
 void FileDownloader::handleTimeout () {
 	if (mReadBytes == mTimeoutReadBytes) {
-		qWarning() << QStringLiteral("Download of %1 failed: timeout.").arg(mUrl.toString());
-		mNetworkReply->abort();
-	} else
+		qWarning() << QStringLiteral("Download of %1 stalled: timeout.").arg(mUrl.toString());
+		for (Segment &segment : mSegments)
+			if (segment.reply)
+				segment.reply->abort();
+	} else {
 		mTimeoutReadBytes = mReadBytes;
-}
-
-void FileDownloader::handleDownloadProgress (qint64 readBytes, qint64 totalBytes) {
-	setReadBytes(readBytes);
-	setTotalBytes(totalBytes);
+		saveState();
+	}
 }
 
 // -----------------------------------------------------------------------------
@@ -232,33 +582,37 @@ void FileDownloader::setOverwriteFile(const bool &overwrite){
 	mOverwriteFile = overwrite;
 }
 
-QString FileDownloader::synchronousDownload(const QUrl &url, const QString &destinationFolder, const bool &overwriteFile){
-	QString filePath;
-	FileDownloader downloader;
-	if(url.isRelative())
-		qWarning() << "FileDownloader: The specified URL is not valid";
-	else{
-		bool isOver = false;
-		bool * pIsOver = &isOver;
-		downloader.setUrl(url);
-		downloader.setOverwriteFile(overwriteFile);
-		downloader.setDownloadFolder(destinationFolder);
-		connect(&downloader, &FileDownloader::downloadFinished, [pIsOver]()mutable{
-			*pIsOver=true;
-		});
-		connect(&downloader, &FileDownloader::downloadFailed, [pIsOver]()mutable{
-			*pIsOver=true;
-		});
-		downloader.download();
-		if(QTest::qWaitFor([&]() {return isOver;}, DefaultTimeout)){
-			filePath = downloader.getDestinationFileName();
-			if(!QFile::exists(filePath)) {
-				filePath = "";
-				qWarning() << "FileDownloader: Cannot download the specified file";
-			}
-		}
+QString FileDownloader::getChecksum () const {
+	return mChecksum;
+}
+
+void FileDownloader::setChecksum (const QString &checksum) {
+	if (mDownloading) {
+		qWarning() << QStringLiteral("Unable to set checksum, a file is downloading.");
+		return;
+	}
+	
+	if (mChecksum != checksum) {
+		mChecksum = checksum;
+		emit checksumChanged(mChecksum);
+	}
+}
+
+int FileDownloader::getSegmentCount () const {
+	return mSegmentCount;
+}
+
+void FileDownloader::setSegmentCount (int segmentCount) {
+	if (mDownloading) {
+		qWarning() << QStringLiteral("Unable to set segment count, a file is downloading.");
+		return;
+	}
+	
+	segmentCount = qMax(1, segmentCount);
+	if (mSegmentCount != segmentCount) {
+		mSegmentCount = segmentCount;
+		emit segmentCountChanged(mSegmentCount);
 	}
-	return filePath;
 }
 
 qint64 FileDownloader::getReadBytes () const {
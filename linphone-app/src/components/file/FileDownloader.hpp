@@ -39,6 +39,10 @@ class FileDownloader : public QObject{
   Q_PROPERTY(qint64 readBytes READ getReadBytes NOTIFY readBytesChanged);
   Q_PROPERTY(qint64 totalBytes READ getTotalBytes NOTIFY totalBytesChanged);
   Q_PROPERTY(bool downloading READ getDownloading NOTIFY downloadingChanged);
+  // Expected SHA-256 of the file, hex encoded. Not checked if empty.
+  Q_PROPERTY(QString checksum READ getChecksum WRITE setChecksum NOTIFY checksumChanged);
+  // Number of parallel byte-range requests if the server supports them.
+  Q_PROPERTY(int segmentCount READ getSegmentCount WRITE setSegmentCount NOTIFY segmentCountChanged);
 
 public:
   FileDownloader (QObject *parent = Q_NULLPTR) : QObject(parent) {
@@ -47,7 +51,7 @@ public:
     QObject::connect(&mTimeout, &QTimer::timeout, this, &FileDownloader::handleTimeout);
   }
 
-  ~FileDownloader () { if (mNetworkReply) mNetworkReply->abort(); }
+  ~FileDownloader ();
 
   Q_INVOKABLE void download ();
   Q_INVOKABLE bool remove();
@@ -61,7 +65,12 @@ public:
   QString getDestinationFileName () const;
 
   void setOverwriteFile(const bool &overwrite);
-  static QString synchronousDownload(const QUrl &url, const QString &destinationFolder, const bool &overwriteFile);// Return the filpath. Empty if nof file could be downloaded
+
+  QString getChecksum () const;
+  void setChecksum (const QString &checksum);
+
+  int getSegmentCount () const;
+  void setSegmentCount (int segmentCount);
 
 signals:
   void urlChanged (const QUrl &url);
@@ -71,8 +80,27 @@ signals:
   void downloadingChanged (bool downloading);
   void downloadFinished (const QString &filePath);
   void downloadFailed();
+  void checksumChanged (const QString &checksum);
+  void segmentCountChanged (int segmentCount);
+
+  // Downloaded data, in file order, as soon as it is contiguous. Only emitted if connected.
+  void dataReceived (const QByteArray &data);
+  // Data received before must be discarded: the download has been restarted.
+  void dataReset ();
 
 private:
+  // A byte range of the file. Partial downloads are kept in a `.part` file and their state
+  // in a `.part.state` file next to it, so a download can be resumed after a failure or a restart.
+  struct Segment {
+    QPointer<QNetworkReply> reply;
+    qint64 start = 0;
+    qint64 end = -1;// Inclusive. -1 if unknown: up to the end of the file.
+    qint64 received = 0;
+    int retries = 0;
+
+    bool isFinished () const { return end >= 0 && start + received > end; }
+  };
+
   qint64 getReadBytes () const;
   void setReadBytes (qint64 readBytes);
 
@@ -84,7 +112,21 @@ private:
 
   void emitOutputError ();
 
-  void cleanDownloadEnd ();
+  void startSegment (int index);
+  Segment *getSegment (QNetworkReply *reply);
+  void handleResponse (Segment &segment);
+  void splitSegments ();
+  void updateReadBytes ();
+  void streamData ();
+
+  bool loadState ();
+  void saveState ();
+  void removePartialFiles ();
+
+  void completeDownload ();
+  void finishDownload (const QByteArray &checksum);
+  void failDownload (bool keepPartialFiles);
+  void stopRequests ();
 
   void handleReadyData ();
   void handleDownloadFinished ();
@@ -92,24 +134,34 @@ private:
   void handleError (QNetworkReply::NetworkError code);
   void handleSslErrors (const QList<QSslError> &errors);
   void handleTimeout ();
-  void handleDownloadProgress (qint64 readBytes, qint64 totalBytes);
 
   QUrl mUrl;
   QString mDownloadFolder;
   QFile mDestinationFile;
+  QFile mPartFile;
+  QString mChecksum;
+  int mSegmentCount = 1;
+
+  QVector<Segment> mSegments;
+  QByteArray mValidator;// ETag or Last-Modified of the downloaded file.
+  bool mStopping = false;
+  qint64 mStreamedBytes = 0;// Sent with `dataReceived`.
+  QCryptographicHash mHash{QCryptographicHash::Sha256};// Streamed if there is only one segment.
 
   qint64 mReadBytes = 0;
   qint64 mTotalBytes = 0;
   bool mDownloading = false;
   bool mOverwriteFile = false;
 
-  QPointer<QNetworkReply> mNetworkReply;
   QNetworkAccessManager mManager;
 
   qint64 mTimeoutReadBytes;
   QTimer mTimeout;
 
   static constexpr int DefaultTimeout = 5000;
+  static constexpr int MaxRetries = 5;
+  static constexpr int RetryDelay = 1000;// Doubled on each retry.
+  static constexpr qint64 MinSegmentSize = 1048576;
 };
 
 #endif // FILE_DOWNLOADER_H_
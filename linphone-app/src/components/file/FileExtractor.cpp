@@ -20,22 +20,137 @@
 
 #include <QDebug>
 #include <QDir>
-#include <QTimer>
-#include <QProcess>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <atomic>
+#include <bzlib.h>
+#include <cstring>
 
 #include "FileExtractor.hpp"
-#include "FileDownloader.hpp"
-#include "app/paths/Paths.hpp"
-#include "utils/Utils.hpp"
-#include "utils/Constants.hpp"
 
 // =============================================================================
 
 using namespace std;
 
-FileExtractor::FileExtractor (QObject *parent) : QObject(parent) {}
+namespace {
+	constexpr int BufferSize = 65536;
+}
+
+// Streaming bzip2 decompression into a temporary file, renamed on commit.
+// Concatenated streams are supported (like `bzip2 -d`), trailing garbage is ignored.
+class Bzip2Decoder {
+public:
+	Bzip2Decoder (const QString &destination) : mOutput(destination), mBuffer(BufferSize, Qt::Uninitialized) {}
+
+	~Bzip2Decoder () {
+		if (mDecoding)
+			BZ2_bzDecompressEnd(&mStream);
+	}
+
+	bool write (const QByteArray &data);
+	bool commit ();
+	bool fail (const QString &error);
+
+	void cancel () {
+		mCanceled = true;
+	}
+
+	QString getError () const {
+		return mError;
+	}
+
+private:
+	QSaveFile mOutput;
+	QByteArray mBuffer;
+	bz_stream mStream;
+	bool mDecoding = false;// Inside a bzip2 stream.
+	bool mStreamEnded = false;// At least one stream has been decoded.
+	bool mTrailingData = false;
+	atomic_bool mCanceled{ false };
+	QString mError;
+};
+
+bool Bzip2Decoder::write (const QByteArray &data) {
+	if (!mError.isEmpty())
+		return false;
+	if (mCanceled)
+		return fail(QStringLiteral("canceled"));
+	if (mTrailingData)
+		return true;
+	if (!mOutput.isOpen() && !mOutput.open(QIODevice::WriteOnly))
+		return fail(mOutput.errorString());
+	
+	char *input = const_cast<char *>(data.constData());
+	unsigned int inputSize = unsigned(data.size());
+	bool pendingOutput = false;
+	while (inputSize > 0 || pendingOutput) {
+		if (!mDecoding) {
+			memset(&mStream, 0, sizeof(mStream));
+			if (BZ2_bzDecompressInit(&mStream, 0, 0) != BZ_OK)
+				return fail(QStringLiteral("unable to init bzip2"));
+			mDecoding = true;
+		}
+		mStream.next_in = input;
+		mStream.avail_in = inputSize;
+		mStream.next_out = mBuffer.data();
+		mStream.avail_out = unsigned(mBuffer.size());
+		const int result = BZ2_bzDecompress(&mStream);
+		input = mStream.next_in;
+		inputSize = mStream.avail_in;
+		
+		if (result == BZ_DATA_ERROR_MAGIC && mStreamEnded && mStream.total_out_lo32 == 0 && mStream.total_out_hi32 == 0) {
+			qWarning() << QStringLiteral("Ignore trailing garbage after bzip2 data in `%1`.").arg(mOutput.fileName());
+			mTrailingData = true;
+			BZ2_bzDecompressEnd(&mStream);
+			mDecoding = false;
+			return true;
+		}
+		if (result != BZ_OK && result != BZ_STREAM_END)
+			return fail(QStringLiteral("bzip2 error %1").arg(result));
+		
+		const qint64 size = mBuffer.size() - qint64(mStream.avail_out);
+		if (size > 0 && mOutput.write(mBuffer.constData(), size) != size)
+			return fail(mOutput.errorString());
+		
+		pendingOutput = result == BZ_OK && mStream.avail_out == 0;
+		if (result == BZ_STREAM_END) {
+			BZ2_bzDecompressEnd(&mStream);
+			mDecoding = false;
+			mStreamEnded = true;
+		}
+	}
+	return true;
+}
+
+bool Bzip2Decoder::commit () {
+	if (!mError.isEmpty())
+		return false;
+	if (mDecoding || !mStreamEnded)
+		return fail(QStringLiteral("unexpected end of data"));
+	if (!mOutput.commit())
+		return fail(mOutput.errorString());
+	return true;
+}
 
-FileExtractor::~FileExtractor () {}
+bool Bzip2Decoder::fail (const QString &error) {
+	if (mError.isEmpty())
+		mError = error;
+	if (mOutput.isOpen())
+		mOutput.cancelWriting();
+	return false;
+}
+
+// -----------------------------------------------------------------------------
+
+FileExtractor::FileExtractor (QObject *parent) : QObject(parent) {
+	mPool.setMaxThreadCount(1);
+}
+
+FileExtractor::~FileExtractor () {
+	if (mDecoder)
+		mDecoder->cancel();
+	mPool.waitForDone();
+}
 
 void FileExtractor::extract () {
 	if (mExtracting) {
@@ -43,67 +158,142 @@ void FileExtractor::extract () {
 		return;
 	}
 	setExtracting(true);
+	QString extractName = mExtractName;
 	QFileInfo fileInfo(mFile);
-	if(!fileInfo.isReadable()){
-		emitExtractFailed(-1);
-		return;
+	if (mDownloader) {
+		if (mDownloader->getDownloading()) {
+			emitExtractFailed(QStringLiteral("the download has already started"));
+			return;
+		}
+		if (extractName.isEmpty())
+			extractName = QFileInfo(mDownloader->getUrl().path()).completeBaseName();
+	} else {
+		if (!fileInfo.isReadable()) {
+			emitExtractFailed(QStringLiteral("file is not readable"));
+			return;
+		}
+		if (extractName.isEmpty())
+			extractName = fileInfo.completeBaseName();
 	}
 	
-	mDestinationFile = QDir::cleanPath(mExtractFolder) + QDir::separator() + (mExtractName.isEmpty() ? fileInfo.completeBaseName() : mExtractName);
-	if(QFile::exists(mDestinationFile) && !QFile::remove(mDestinationFile)){
-		emitOutputError();
-		return;
-	}
-	if( mTimer == nullptr){
-		mTimer = new QTimer(this);
-		QObject::connect(mTimer, &QTimer::timeout, this, &FileExtractor::handleExtraction);
-	}
-#ifdef WIN32
-	// Test the presence of bzip2 in the system
-	QProcess process;
-	process.closeReadChannel(QProcess::StandardOutput);
-	process.closeReadChannel(QProcess::StandardError);
-	process.start("bzip2.exe",QStringList("--help") );
-	//int result = QProcess::execute("bzip2.exe", QStringList("--help"));
-	if( process.error() != QProcess::FailedToStart || QProcess::execute(Utils::coreStringToAppString(Paths::getToolsDirPath())+"\\bzip2.exe", QStringList())!=-2){
-		mTimer->start();
-	}else{// Download bzip2
-		qWarning() << "bzip2 was not found. Downloading it.";
-		QTimer * timer = mTimer;
-		FileDownloader * fileDownloader = new FileDownloader();
-		int downloadStep = 0;
-		fileDownloader->setUrl(QUrl(Constants::LinphoneBZip2_exe));
-		fileDownloader->setDownloadFolder(Utils::coreStringToAppString(Paths::getToolsDirPath()));
-		QObject::connect(fileDownloader, &FileDownloader::totalBytesChanged, this, &FileExtractor::setTotalBytes);
-		QObject::connect(fileDownloader, &FileDownloader::readBytesChanged, this, &FileExtractor::setReadBytes);
-		
-		QObject::connect(fileDownloader, &FileDownloader::downloadFinished, [fileDownloader, timer, downloadStep,this ]()mutable {
-			if( downloadStep++ == 0){
-				fileDownloader->setUrl(QUrl(Constants::LinphoneBZip2_dll));
-				fileDownloader->download();
-			}else {
-				fileDownloader->deleteLater();
-				QObject::disconnect(fileDownloader, &FileDownloader::totalBytesChanged, this, &FileExtractor::setTotalBytes);
-				QObject::disconnect(fileDownloader, &FileDownloader::readBytesChanged, this, &FileExtractor::setReadBytes);
-				timer->start();
-			}
+	mDestinationFile = QDir::cleanPath(mExtractFolder) + QDir::separator() + extractName;
+	mDecoder = make_shared<Bzip2Decoder>(mDestinationFile);
+	setReadBytes(0);
+	if (mDownloader) {
+		setTotalBytes(mDownloader->getTotalBytes());
+		QObject::connect(mDownloader, &FileDownloader::totalBytesChanged, this, &FileExtractor::setTotalBytes);
+		QObject::connect(mDownloader, &FileDownloader::dataReceived, this, &FileExtractor::decodeData);
+		QObject::connect(mDownloader, &FileDownloader::dataReset, this, &FileExtractor::restartDecoding);
+		QObject::connect(mDownloader, &FileDownloader::downloadFinished, this, &FileExtractor::commitData);
+		QObject::connect(mDownloader, &FileDownloader::downloadFailed, this, [this]() {
+			emitExtractFailed(QStringLiteral("download failed"));
 		});
-		
-		QObject::connect(fileDownloader, &FileDownloader::downloadFailed, [fileDownloader, this]() {
-			fileDownloader->deleteLater();
-			emitExtractorFailed();
-		});
-		fileDownloader->download();
+	} else {
+		setTotalBytes(fileInfo.size());
+		decodeFile();
 	}
-#else
-	mTimer->start();
-#endif
 }
 
 bool FileExtractor::remove () {
 	return QFile::exists(mDestinationFile) && QFile::remove(mDestinationFile);
 }
 
+// -----------------------------------------------------------------------------
+
+void FileExtractor::decodeFile () {
+	shared_ptr<Bzip2Decoder> decoder = mDecoder;
+	const QString file = mFile;
+	QtConcurrent::run(&mPool, [this, decoder, file]() {
+		QFile input(file);
+		bool success = input.open(QIODevice::ReadOnly) || decoder->fail(input.errorString());
+		while (success && !input.atEnd()) {
+			const QByteArray data = input.read(BufferSize);
+			success = (!data.isEmpty() || decoder->fail(input.errorString())) && decoder->write(data);
+			const qint64 size = data.size();
+			QMetaObject::invokeMethod(this, [this, decoder, success, size]() {
+				handleDataDecoded(decoder.get(), success, size);
+			}, Qt::QueuedConnection);
+		}
+		success = success && decoder->commit();
+		QMetaObject::invokeMethod(this, [this, decoder, success]() {
+			handleDataCommitted(decoder.get(), success);
+		}, Qt::QueuedConnection);
+	});
+}
+
+void FileExtractor::decodeData (const QByteArray &data) {
+	mPendingData += data;
+	decodeNext();
+}
+
+void FileExtractor::commitData () {
+	mCommitRequested = true;
+	decodeNext();
+}
+
+// Only one task is queued at a time: data received meanwhile is decoded by the next one.
+void FileExtractor::decodeNext () {
+	if (mTaskRunning || !mDecoder)
+		return;
+	shared_ptr<Bzip2Decoder> decoder = mDecoder;
+	if (!mPendingData.isEmpty()) {
+		QByteArray data;
+		data.swap(mPendingData);
+		mTaskRunning = true;
+		QtConcurrent::run(&mPool, [this, decoder, data]() {
+			const bool success = decoder->write(data);
+			const qint64 size = data.size();
+			QMetaObject::invokeMethod(this, [this, decoder, success, size]() {
+				mTaskRunning = false;
+				handleDataDecoded(decoder.get(), success, size);
+				decodeNext();
+			}, Qt::QueuedConnection);
+		});
+	} else if (mCommitRequested) {
+		mCommitRequested = false;
+		mTaskRunning = true;
+		QtConcurrent::run(&mPool, [this, decoder]() {
+			const bool success = decoder->commit();
+			QMetaObject::invokeMethod(this, [this, decoder, success]() {
+				mTaskRunning = false;
+				handleDataCommitted(decoder.get(), success);
+				decodeNext();
+			}, Qt::QueuedConnection);
+		});
+	}
+}
+
+// The running task of the previous decoder is canceled and its result ignored.
+void FileExtractor::restartDecoding () {
+	qInfo() << QStringLiteral("Download restarted: restart extraction into `%1`.").arg(mDestinationFile);
+	mDecoder->cancel();
+	mDecoder = make_shared<Bzip2Decoder>(mDestinationFile);
+	mPendingData.clear();
+	mCommitRequested = false;
+	setReadBytes(0);
+}
+
+void FileExtractor::handleDataDecoded (const Bzip2Decoder *decoder, bool success, qint64 size) {
+	if (decoder != mDecoder.get())
+		return;
+	if (success)
+		setReadBytes(mReadBytes + size);
+	else
+		emitExtractFailed(decoder->getError());
+}
+
+void FileExtractor::handleDataCommitted (const Bzip2Decoder *decoder, bool success) {
+	if (decoder != mDecoder.get())
+		return;
+	if (success) {
+		setReadBytes(mTotalBytes);
+		emitExtractFinished();
+	} else
+		emitExtractFailed(decoder->getError());
+}
+
+// -----------------------------------------------------------------------------
+
 QString FileExtractor::getFile () const {
 	return mFile;
 }
@@ -119,6 +309,21 @@ void FileExtractor::setFile (const QString &file) {
 	}
 }
 
+FileDownloader *FileExtractor::getDownloader () const {
+	return mDownloader;
+}
+
+void FileExtractor::setDownloader (FileDownloader *downloader) {
+	if (mExtracting) {
+		qWarning() << QStringLiteral("Unable to set downloader, a file is extracting.");
+		return;
+	}
+	if (mDownloader != downloader) {
+		mDownloader = downloader;
+		emit downloaderChanged(mDownloader);
+	}
+}
+
 QString FileExtractor::getExtractFolder () const {
 	return mExtractFolder;
 }
@@ -177,24 +382,24 @@ void FileExtractor::setTotalBytes (qint64 totalBytes) {
 	mTotalBytes = totalBytes;
 	emit totalBytesChanged(totalBytes);
 }
+
+// -----------------------------------------------------------------------------
+
 void FileExtractor::clean () {
-	if (mTimer) {
-		mTimer->stop();
-		mTimer->deleteLater();
-		mTimer = nullptr;
+	if (mDownloader)
+		QObject::disconnect(mDownloader, nullptr, this, nullptr);
+	if (mDecoder) {
+		mDecoder->cancel();
+		mDecoder.reset();
 	}
+	mPendingData.clear();
+	mCommitRequested = false;
 	setExtracting(false);
 }
 
-void FileExtractor::emitExtractorFailed () {
-	qWarning() << QStringLiteral("Unable to extract file `%1`. bzip2 is unavailable, please install it.")
-				  .arg(mFile);
-	clean();
-	emit extractFailed();
-}
-void FileExtractor::emitExtractFailed (int error) {
-	qWarning() << QStringLiteral("Unable to extract file with bzip2: `%1` (code: %2).")
-				  .arg(mFile).arg(error);
+void FileExtractor::emitExtractFailed (const QString &error) {
+	qWarning() << QStringLiteral("Unable to extract file `%1` into `%2`: %3.")
+				  .arg(mDownloader ? mDownloader->getUrl().toString() : mFile).arg(mDestinationFile).arg(error);
 	clean();
 	emit extractFailed();
 }
@@ -203,36 +408,3 @@ void FileExtractor::emitExtractFinished () {
 	clean();
 	emit extractFinished();
 }
-
-void FileExtractor::emitOutputError () {
-	qWarning() << QStringLiteral("Could not write into `%1`.")
-				  .arg(mDestinationFile);
-	clean();
-	emit extractFailed();
-}
-
-void FileExtractor::handleExtraction () {
-	QString tempDestination = mDestinationFile+"."+QFileInfo(mFile).suffix();
-	QStringList args;
-	args.push_back("-dq");
-	args.push_back(tempDestination);
-	QFile::copy(mFile, tempDestination);
-#ifdef WIN32
-	int result = QProcess::execute("bzip2.exe", args);
-	if( result == -2)
-		result = QProcess::execute(Utils::coreStringToAppString(Paths::getToolsDirPath())+"\\bzip2.exe", args);
-#else
-	int result = QProcess::execute("bzip2", args);
-#endif
-	if(QFile::exists(tempDestination))
-		QFile::remove(tempDestination);
-	if (result == 0){
-		setReadBytes(getTotalBytes());
-		emitExtractFinished();
-	}else if (result > 0)
-		emitExtractFailed(result);
-	else if(result == -2)
-		emitExtractorFailed();
-	else
-		emitOutputError();
-}
@@ -22,12 +22,18 @@
 #define FILE_EXTRACTOR_H_
 
 #include <QFile>
+#include <QPointer>
+#include <QThreadPool>
+#include <memory>
+
+#include "FileDownloader.hpp"
 
 // =============================================================================
 
-class QTimer;
+class Bzip2Decoder;
 
-// Supports only bzip file.
+// Supports only bzip file. It is decompressed on a worker thread and the destination
+// file is replaced only when the extraction succeeds.
 class FileExtractor : public QObject {
 
   Q_OBJECT;
@@ -35,6 +41,9 @@ class FileExtractor : public QObject {
   // TODO: Add an error property to use in UI.
 
   Q_PROPERTY(QString file READ getFile WRITE setFile NOTIFY fileChanged);
+  // If set, the data of this downloader is extracted while it is received: `file` is not used.
+  // `extract` must be called before starting the download.
+  Q_PROPERTY(FileDownloader *downloader READ getDownloader WRITE setDownloader NOTIFY downloaderChanged);
   Q_PROPERTY(QString extractFolder READ getExtractFolder WRITE setExtractFolder NOTIFY extractFolderChanged);
   Q_PROPERTY(QString extractName READ getExtractName WRITE setExtractName NOTIFY extractNameChanged);
   Q_PROPERTY(bool extracting READ getExtracting NOTIFY extractingChanged);
@@ -50,6 +59,9 @@ public:
   QString getFile () const;
   void setFile (const QString &file);
 
+  FileDownloader *getDownloader () const;
+  void setDownloader (FileDownloader *downloader);
+
   QString getExtractFolder () const;
   void setExtractFolder (const QString &extractFolder);
 
@@ -58,6 +70,7 @@ public:
 
 signals:
   void fileChanged (const QString &file);
+  void downloaderChanged (FileDownloader *downloader);
 
   void extractFolderChanged (const QString &extractFolder);
   void extractNameChanged (const QString &extractName);
@@ -82,13 +95,20 @@ private:
   void clean ();
 
   void emitExtractFinished ();
-  void emitExtractorFailed ();	// Used when bzip2 cannot be used
-  void emitExtractFailed (int error);
-  void emitOutputError ();
+  void emitExtractFailed (const QString &error);
+
+  // Decoding tasks are run in order on mPool.
+  void decodeFile ();
+  void decodeData (const QByteArray &data);
+  void commitData ();
+  void decodeNext ();
+  void restartDecoding ();
 
-  void handleExtraction ();
+  void handleDataDecoded (const Bzip2Decoder *decoder, bool success, qint64 size);
+  void handleDataCommitted (const Bzip2Decoder *decoder, bool success);
 
   QString mFile;
+  QPointer<FileDownloader> mDownloader;
   QString mExtractFolder;
   QString mExtractName;
   QString mDestinationFile;
@@ -97,7 +117,11 @@ private:
   qint64 mReadBytes = 0;
   qint64 mTotalBytes = 0;
 
-  QTimer *mTimer = nullptr;
+  std::shared_ptr<Bzip2Decoder> mDecoder;
+  QByteArray mPendingData;// Received while a task is running.
+  bool mCommitRequested = false;
+  bool mTaskRunning = false;
+  QThreadPool mPool;
 };
 
 #endif // FILE_EXTRACTOR_H_
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include "RemoteConfigFetcher.hpp"
+
+// =============================================================================
+
+namespace {
+  constexpr char DefaultFileName[] = "download";
+  constexpr char ValidatorsSuffix[] = ".validators";
+
+  constexpr char UrlKey[] = "url";
+  constexpr char ETagKey[] = "etag";
+  constexpr char LastModifiedKey[] = "last_modified";
+}
+
+RemoteConfigFetcher::RemoteConfigFetcher (const QUrl &url, const QString &cacheFolder, QObject *parent) : QObject(parent) {
+  mUrl = url;
+  mFilePath = getCacheFilePath(url, cacheFolder);
+  loadValidators();
+
+  mTimeout.setSingleShot(true);
+  mTimeout.setInterval(DefaultTimeout);
+  QObject::connect(&mTimeout, &QTimer::timeout, this, &RemoteConfigFetcher::handleTimeout);
+}
+
+QString RemoteConfigFetcher::getCacheFilePath (const QUrl &url, const QString &cacheFolder) {
+  QString fileName = QFileInfo(url.path()).fileName();
+  if (fileName.isEmpty())
+    fileName = DefaultFileName;
+  return cacheFolder + fileName;
+}
+
+QString RemoteConfigFetcher::getCachedFilePath () const {
+  return QFile::exists(mFilePath) ? mFilePath : QString();
+}
+
+// -----------------------------------------------------------------------------
+
+void RemoteConfigFetcher::fetch () {
+  if (isFetching())
+    return;
+
+  QNetworkRequest request(mUrl);
+  request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+  // Validators are useless without the file they describe.
+  if (QFile::exists(mFilePath)) {
+    if (!mETag.isEmpty())
+      request.setRawHeader("If-None-Match", mETag);
+    if (!mLastModified.isEmpty())
+      request.setRawHeader("If-Modified-Since", mLastModified);
+  }
+
+  qInfo() << QStringLiteral("Fetching remote config: `%1`.").arg(mUrl.toString());
+  mReply = mManager.get(request);
+  QObject::connect(mReply, &QNetworkReply::finished, this, &RemoteConfigFetcher::handleFinished);
+  QObject::connect(mReply, &QNetworkReply::sslErrors, this, &RemoteConfigFetcher::handleSslErrors);
+  mTimeout.start();
+}
+
+bool RemoteConfigFetcher::isFetching () const {
+  return mReply != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+
+void RemoteConfigFetcher::loadValidators () {
+  QFile file(mFilePath + ValidatorsSuffix);
+  if (!file.open(QIODevice::ReadOnly))
+    return;
+
+  const QJsonObject validators = QJsonDocument::fromJson(file.readAll()).object();
+  // The cache may have been filled from another server.
+  if (validators.value(UrlKey).toString() != mUrl.toString())
+    return;
+
+  mETag = validators.value(ETagKey).toString().toLatin1();
+  mLastModified = validators.value(LastModifiedKey).toString().toLatin1();
+}
+
+void RemoteConfigFetcher::saveValidators () const {
+  QJsonObject validators;
+  validators[UrlKey] = mUrl.toString();
+  validators[ETagKey] = QString::fromLatin1(mETag);
+  validators[LastModifiedKey] = QString::fromLatin1(mLastModified);
+
+  QSaveFile file(mFilePath + ValidatorsSuffix);
+  if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(validators).toJson(QJsonDocument::Compact)) < 0 || !file.commit())
+    qWarning() << QStringLiteral("Unable to save remote config validators: `%1`.").arg(file.fileName());
+}
+
+// Return false if the config cannot be cached. `changed` is set if the cached one has been replaced.
+bool RemoteConfigFetcher::storeConfig (const QByteArray &data, bool &changed) {
+  changed = false;
+  QFile cachedFile(mFilePath);
+  if (cachedFile.open(QIODevice::ReadOnly) && cachedFile.size() == data.size() && cachedFile.readAll() == data)
+    return true;
+  cachedFile.close();
+
+  QSaveFile file(mFilePath);
+  if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+    qWarning() << QStringLiteral("Unable to cache remote config: `%1`.").arg(mFilePath);
+    return false;
+  }
+  changed = true;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void RemoteConfigFetcher::handleFinished () {
+  QNetworkReply *reply = mReply;
+  mReply = nullptr;
+  mTimeout.stop();
+  reply->deleteLater();
+
+  const int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if (statusCode == 304) {
+    qInfo() << QStringLiteral("Remote config not modified: `%1`.").arg(mUrl.toString());
+    emit fetchFinished(false);
+    return;
+  }
+
+  if (reply->error() != QNetworkReply::NoError || (mUrl.scheme().startsWith("http") && statusCode != 200)) {
+    qWarning() << QStringLiteral("Unable to fetch remote config (%1): `%2`.").arg(statusCode).arg(reply->errorString());
+    emit fetchFailed();
+    return;
+  }
+
+  const QByteArray data = reply->readAll();
+  if (data.isEmpty()) {
+    qWarning() << QStringLiteral("Remote config is empty, cached one is kept: `%1`.").arg(mUrl.toString());
+    emit fetchFailed();
+    return;
+  }
+
+  bool changed;
+  if (!storeConfig(data, changed)) {
+    emit fetchFailed();
+    return;
+  }
+  mETag = reply->rawHeader("ETag");
+  mLastModified = reply->rawHeader("Last-Modified");
+  saveValidators();
+
+  qInfo() << QStringLiteral("Remote config fetched (changed: %1): `%2`.").arg(changed).arg(mUrl.toString());
+  if (changed)
+    emit configChanged(mFilePath);
+  emit fetchFinished(changed);
+}
+
+void RemoteConfigFetcher::handleSslErrors (const QList<QSslError> &sslErrors) {
+#if QT_CONFIG(ssl)
+  for (const QSslError &error : sslErrors)
+    qWarning() << QStringLiteral("SSL error: %1").arg(error.errorString());
+#else
+  Q_UNUSED(sslErrors);
+#endif
+}
+
+void RemoteConfigFetcher::handleTimeout () {
+  if (mReply) {
+    qWarning() << QStringLiteral("Fetch of remote config timed out: `%1`.").arg(mUrl.toString());
+    mReply->abort();// `finished` is emitted.
+  }
+}
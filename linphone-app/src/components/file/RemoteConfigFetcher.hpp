@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REMOTE_CONFIG_FETCHER_H_
+#define REMOTE_CONFIG_FETCHER_H_
+
+#include <QObject>
+#include <QtNetwork>
+
+// =============================================================================
+
+// Fetch a remote configuration in background. The last good configuration is cached
+// with its validators (ETag, Last-Modified) so that the next fetches are conditional
+// and the application can start from the cache without waiting for the server.
+class RemoteConfigFetcher : public QObject {
+  Q_OBJECT;
+
+public:
+  RemoteConfigFetcher (const QUrl &url, const QString &cacheFolder, QObject *parent = Q_NULLPTR);
+
+  QUrl getUrl () const {
+    return mUrl;
+  }
+
+  // Return the cached configuration. Empty if it has never been fetched.
+  QString getCachedFilePath () const;
+
+  void fetch ();
+  bool isFetching () const;
+
+  static QString getCacheFilePath (const QUrl &url, const QString &cacheFolder);
+
+signals:
+  // Emitted only if the fetched configuration differs from the cached one.
+  void configChanged (const QString &filePath);
+  void fetchFinished (bool changed);
+  void fetchFailed ();
+
+private:
+  void loadValidators ();
+  void saveValidators () const;
+
+  bool storeConfig (const QByteArray &data, bool &changed);
+
+  void handleFinished ();
+  void handleSslErrors (const QList<QSslError> &errors);
+  void handleTimeout ();
+
+  QUrl mUrl;
+  QString mFilePath;
+
+  QByteArray mETag;
+  QByteArray mLastModified;
+
+  QNetworkAccessManager mManager;
+  QPointer<QNetworkReply> mReply;
+  QTimer mTimeout;
+
+  static constexpr int DefaultTimeout = 15000;
+};
+
+#endif // REMOTE_CONFIG_FETCHER_H_
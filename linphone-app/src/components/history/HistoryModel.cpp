@@ -47,32 +47,6 @@
 
 using namespace std;
 
-static inline void fillCallStartEntry (QVariantMap &dest, const shared_ptr<linphone::CallLog> &callLog) {
-	dest["type"] = HistoryModel::CallEntry;
-	dest["timestamp"] = QDateTime::fromMSecsSinceEpoch(callLog->getStartDate() * 1000);
-	dest["isOutgoing"] = callLog->getDir() == linphone::Call::Dir::Outgoing;
-	dest["status"] = static_cast<HistoryModel::CallStatus>(callLog->getStatus());
-	dest["isStart"] = true;
-	if(callLog->getConferenceInfo())
-		dest["title"] = QString::fromStdString(callLog->getConferenceInfo()->getSubject());
-	dest["sipAddress"] = Utils::coreStringToAppString(callLog->getRemoteAddress()->asString());
-	dest["callId"] = Utils::coreStringToAppString(callLog->getCallId());
-	dest["wasConference"] = callLog->wasConference();
-}
-
-static inline void fillCallEndEntry (QVariantMap &dest, const shared_ptr<linphone::CallLog> &callLog) {
-	dest["type"] = HistoryModel::CallEntry;
-	dest["timestamp"] = QDateTime::fromMSecsSinceEpoch((callLog->getStartDate() + callLog->getDuration()) * 1000);
-	dest["isOutgoing"] = callLog->getDir() == linphone::Call::Dir::Outgoing;
-	dest["status"] = static_cast<HistoryModel::CallStatus>(callLog->getStatus());
-	dest["isStart"] = false;
-	if(callLog->getConferenceInfo())
-		dest["title"] = QString::fromStdString(callLog->getConferenceInfo()->getSubject());
-	dest["sipAddress"] = Utils::coreStringToAppString(callLog->getRemoteAddress()->asString());
-	dest["callId"] = Utils::coreStringToAppString(callLog->getCallId());
-	dest["wasConference"] = callLog->wasConference();
-}
-
 // -----------------------------------------------------------------------------
 
 HistoryModel::HistoryModel (QObject *parent) :QAbstractListModel(parent){
@@ -97,22 +71,20 @@ QHash<int, QByteArray> HistoryModel::roleNames () const {
 }
 
 int HistoryModel::rowCount (const QModelIndex &) const {
-	return mEntries.count();
+	return mEntries.count() - mFirstLoadedEntry;
 }
 
 QVariant HistoryModel::data (const QModelIndex &index, int role) const {
 	int row = index.row();
 	
-	if (!index.isValid() || row < 0 || row >= mEntries.count())
+	if (!index.isValid() || row < 0 || row >= rowCount())
 		return QVariant();
 	
 	switch (role) {
-	case Roles::HistoryEntry: {
-		auto &data = mEntries[row].first;
-		return QVariant::fromValue(data);
-	}
+	case Roles::HistoryEntry:
+		return QVariant::fromValue(toVariantMap(mEntries[mFirstLoadedEntry + row]));
 	case Roles::SectionDate:
-		return QVariant::fromValue(mEntries[row].first["timestamp"].toDate());
+		return QVariant::fromValue(QDateTime::fromMSecsSinceEpoch(mEntries[mFirstLoadedEntry + row].timestamp).date());
 	}
 	
 	return QVariant();
@@ -125,21 +97,21 @@ bool HistoryModel::removeRow (int row, const QModelIndex &) {
 bool HistoryModel::removeRows (int row, int count, const QModelIndex &parent) {
 	int limit = row + count - 1;
 	
-	if (row < 0 || count < 0 || limit >= mEntries.count())
+	if (row < 0 || count < 0 || limit >= rowCount())
 		return false;
 	
 	beginRemoveRows(parent, row, limit);
 	
 	for (int i = 0; i < count; ++i) {
-		removeEntry(mEntries[row]);
-		mEntries.removeAt(row);
+		removeEntry(mEntries[mFirstLoadedEntry + row]);
+		mEntries.remove(mFirstLoadedEntry + row);
 	}
 	
 	endRemoveRows();
 	
 	if (mEntries.count() == 0)
 		emit allEntriesRemoved();
-	else if (limit == mEntries.count())
+	else if (limit == rowCount())
 		emit lastEntryRemoved();
 	emit CoreManager::getInstance()->callLogsCountChanged();
 	emit focused();// Removing rows is like having focus. Don't wait asynchronous events.
@@ -148,22 +120,43 @@ bool HistoryModel::removeRows (int row, int count, const QModelIndex &parent) {
 
 void HistoryModel::setSipAddresses () {
 	shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
-	mEntries.clear();
 	
 	QElapsedTimer timer;
 	timer.start();
 	
-	// Get calls.
-	for (auto &callLog : core->getCallLogs())
-		insertCall(callLog);
+	QVector<HistoryEntryData> entries;
+	std::list<shared_ptr<linphone::CallLog>> callLogs = core->getCallLogs();
+	entries.reserve(int(callLogs.size()) * 2);
+	for (auto &callLog : callLogs) {
+		entries.append({ callLog, callLog->getStartDate() * 1000, true });
+		if (callLog->getStatus() == linphone::Call::Status::Success)
+			entries.append({ callLog, (callLog->getStartDate() + callLog->getDuration()) * 1000, false });
+	}
+	// Stable: a start entry stays before its end entry.
+	stable_sort(entries.begin(), entries.end(), [](const HistoryEntryData &a, const HistoryEntryData &b) {
+		return a.timestamp < b.timestamp;
+	});
 	
-	qInfo() << QStringLiteral("HistoryModel loaded in %3 milliseconds.").arg(timer.elapsed());
+	beginResetModel();
+	mEntries.swap(entries);
+	mFirstLoadedEntry = qMax(0, mEntries.count() - EntriesChunkSize);
+	endResetModel();
 	
+	qInfo() << QStringLiteral("HistoryModel loaded %1 entries in %2 milliseconds.").arg(mEntries.count()).arg(timer.elapsed());
 }
+
 void HistoryModel::reload(){
-	beginResetModel();
 	setSipAddresses();
-	endResetModel();
+}
+
+int HistoryModel::loadMoreEntries () {
+	int count = qMin(EntriesChunkSize, mFirstLoadedEntry);
+	if (count > 0) {
+		beginInsertRows(QModelIndex(), 0, count - 1);
+		mFirstLoadedEntry -= count;
+		endInsertRows();
+	}
+	return count;
 }
 // -----------------------------------------------------------------------------
 
@@ -183,6 +176,7 @@ void HistoryModel::removeAllEntries () {
 		removeEntry(entry);
 	
 	mEntries.clear();
+	mFirstLoadedEntry = 0;
 	
 	endResetModel();
 	
@@ -194,66 +188,77 @@ void HistoryModel::removeAllEntries () {
 // -----------------------------------------------------------------------------
 
 void HistoryModel::removeEntry (HistoryEntryData &entry) {
-	int type = entry.first["type"].toInt();
-	
-	switch (type) {
-		
-	case HistoryModel::CallEntry: {
-		if (entry.first["status"].toInt() == CallStatusSuccess) {
-			// WARNING: Unable to remove symmetric call here. (start/end)
-			// We are between `beginRemoveRows` and `endRemoveRows`.
-			// A solution is to schedule a `removeEntry` call in the Qt main loop.
-			shared_ptr<void> linphonePtr = entry.second;
-			QTimer::singleShot(0, this, [this, linphonePtr]() {
-				auto it = find_if(mEntries.begin(), mEntries.end(), [linphonePtr](const HistoryEntryData &entry) {
-					return entry.second == linphonePtr;
-				});
-				
-				if (it != mEntries.end())
-					removeEntry(int(distance(mEntries.begin(), it)));
+	if (entry.callLog->getStatus() == linphone::Call::Status::Success) {
+		// WARNING: Unable to remove symmetric call here. (start/end)
+		// We are between `beginRemoveRows` and `endRemoveRows`.
+		// A solution is to schedule a `removeEntry` call in the Qt main loop.
+		shared_ptr<linphone::CallLog> callLog = entry.callLog;
+		QTimer::singleShot(0, this, [this, callLog]() {
+			auto it = find_if(mEntries.begin(), mEntries.end(), [callLog](const HistoryEntryData &entry) {
+				return entry.callLog == callLog;
 			});
-		}
-		
-		CoreManager::getInstance()->getCore()->removeCallLog(static_pointer_cast<linphone::CallLog>(entry.second));
-		break;
-	}
-		
-	default:
-		qWarning() << QStringLiteral("Unknown history entry type: %1.").arg(type);
+			if (it == mEntries.end())
+				return;
+			
+			int index = int(distance(mEntries.begin(), it));
+			if (index < mFirstLoadedEntry) {// Not exposed yet.
+				mEntries.remove(index);
+				--mFirstLoadedEntry;
+			} else
+				removeEntry(index - mFirstLoadedEntry);
+		});
 	}
+	
+	CoreManager::getInstance()->getCore()->removeCallLog(entry.callLog);
 }
 
-void HistoryModel::insertCall (const shared_ptr<linphone::CallLog> &callLog) {
-	linphone::Call::Status status = callLog->getStatus();
-	
-	auto insertEntry = [this](
-	const HistoryEntryData &entry,
-	const QList<HistoryEntryData>::iterator *start = nullptr
-	) {
-		auto it = lower_bound(start ? *start : mEntries.begin(), mEntries.end(), entry, [](const HistoryEntryData &a, const HistoryEntryData &b) {
-			return a.first["timestamp"] < b.first["timestamp"];
-		});
-		
-		int row = int(distance(mEntries.begin(), it));
-		
+// New entries are usually the most recent ones: appended in O(1).
+void HistoryModel::insertEntry (const HistoryEntryData &entry) {
+	if (mEntries.isEmpty() || mEntries.last().timestamp <= entry.timestamp) {
+		int row = rowCount();
 		beginInsertRows(QModelIndex(), row, row);
-		it = mEntries.insert(it, entry);
+		mEntries.append(entry);
 		endInsertRows();
-		emit layoutChanged();
-		
-		return it;
-	};
+		return;
+	}
 	
-	// Add start call.
-	QVariantMap start;
-	fillCallStartEntry(start, callLog);
-	auto it = insertEntry(qMakePair(start, static_pointer_cast<void>(callLog)));
+	auto it = upper_bound(mEntries.begin(), mEntries.end(), entry, [](const HistoryEntryData &a, const HistoryEntryData &b) {
+		return a.timestamp < b.timestamp;
+	});
+	int index = int(distance(mEntries.begin(), it));
 	
-	if (status == linphone::Call::Status::Success) {
-		QVariantMap end;
-		fillCallEndEntry(end, callLog);
-		insertEntry(qMakePair(end, static_pointer_cast<void>(callLog)), &it);
+	if (index < mFirstLoadedEntry) {// Older than the exposed entries.
+		mEntries.insert(index, entry);
+		++mFirstLoadedEntry;
+		return;
 	}
+	
+	int row = index - mFirstLoadedEntry;
+	beginInsertRows(QModelIndex(), row, row);
+	mEntries.insert(index, entry);
+	endInsertRows();
+}
+
+void HistoryModel::insertCall (const shared_ptr<linphone::CallLog> &callLog) {
+	insertEntry({ callLog, callLog->getStartDate() * 1000, true });
+	if (callLog->getStatus() == linphone::Call::Status::Success)
+		insertEntry({ callLog, (callLog->getStartDate() + callLog->getDuration()) * 1000, false });
+}
+
+QVariantMap HistoryModel::toVariantMap (const HistoryEntryData &entry) {
+	const shared_ptr<linphone::CallLog> &callLog = entry.callLog;
+	QVariantMap map;
+	map["type"] = HistoryModel::CallEntry;
+	map["timestamp"] = QDateTime::fromMSecsSinceEpoch(entry.timestamp);
+	map["isOutgoing"] = callLog->getDir() == linphone::Call::Dir::Outgoing;
+	map["status"] = static_cast<HistoryModel::CallStatus>(callLog->getStatus());
+	map["isStart"] = entry.isStart;
+	if(callLog->getConferenceInfo())
+		map["title"] = QString::fromStdString(callLog->getConferenceInfo()->getSubject());
+	map["sipAddress"] = Utils::coreStringToAppString(callLog->getRemoteAddress()->asString());
+	map["callId"] = Utils::coreStringToAppString(callLog->getCallId());
+	map["wasConference"] = callLog->wasConference();
+	return map;
 }
 
 // -----------------------------------------------------------------------------
@@ -74,6 +74,7 @@ public:
 	void resetMessageCount ();
 	
 	Q_INVOKABLE void reload();
+	Q_INVOKABLE int loadMoreEntries ();// Return the number of older entries added at the beginning of the model.
 
 signals:
 	void allEntriesRemoved ();
@@ -83,16 +84,30 @@ signals:
 	void callCountReset();
 
 private:
-	typedef QPair<QVariantMap, std::shared_ptr<void>> HistoryEntryData;
+	// A call log gives a start entry, and an end entry if the call was accepted.
+	// The QML entry is built on demand from the call log.
+	struct HistoryEntryData {
+		std::shared_ptr<linphone::CallLog> callLog;
+		qint64 timestamp;// In milliseconds.
+		bool isStart;
+	};
 	
 	void setSipAddresses ();
 	void removeEntry (HistoryEntryData &entry);
+	void insertEntry (const HistoryEntryData &entry);
 	void insertCall (const std::shared_ptr<linphone::CallLog> &callLog);
 	void handleCallStateChanged (const std::shared_ptr<linphone::Call> &call, linphone::Call::State state);
-
-	mutable QList<HistoryEntryData> mEntries;
+	
+	static QVariantMap toVariantMap (const HistoryEntryData &entry);
+	
+	// All the entries sorted by timestamp. Only the ones from `mFirstLoadedEntry` are exposed,
+	// older entries are exposed by chunks with `loadMoreEntries`.
+	QVector<HistoryEntryData> mEntries;
+	int mFirstLoadedEntry = 0;
 	
 	std::shared_ptr<CoreHandlers> mCoreHandlers;
+	
+	static constexpr int EntriesChunkSize = 200;
 };
 
 #endif // HISTORY_MODEL_H_
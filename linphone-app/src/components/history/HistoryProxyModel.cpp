@@ -71,7 +71,7 @@ HistoryProxyModel::HistoryProxyModel (QObject *parent) : QSortFilterProxyModel(p
 		handleIsActiveChanged(App::getInstance()->getMainWindow());
 	});
 	
-	QQuickWindow *callsWindow = app->getCallsWindow();
+	QQuickWindow *callsWindow = app->getCallsWindow(false);
 	if (callsWindow)
 		QObject::connect(callsWindow, &QWindow::activeChanged, this, [this, callsWindow]() {
 			handleIsActiveChanged(callsWindow);
@@ -99,6 +99,13 @@ void HistoryProxyModel::loadMoreEntries () {
 	int count = rowCount();
 	int parentCount = sourceModel()->rowCount();
 	
+	// All the loaded entries are displayed: fetch older ones.
+	if (count == parentCount) {
+		auto model = CoreManager::getInstance()->getHistoryModel();
+		if (model && model->loadMoreEntries() > 0)
+			parentCount = sourceModel()->rowCount();
+	}
+	
 	if (count < parentCount) {
 		// Do not increase `mMaxDisplayedEntries` if it's not necessary...
 		// Limit qml calls.
@@ -147,7 +154,7 @@ void HistoryProxyModel::resetMessageCount(){
 static inline QWindow *getParentWindow (QObject *object) {
 	App *app = App::getInstance();
 	const QWindow *mainWindow = app->getMainWindow();
-	const QWindow *callsWindow = app->getCallsWindow();
+	const QWindow *callsWindow = app->getCallsWindow(false);
 	for (QObject *parent = object->parent(); parent; parent = parent->parent())
 		if (parent == mainWindow || parent == callsWindow)
 			return static_cast<QWindow *>(parent);
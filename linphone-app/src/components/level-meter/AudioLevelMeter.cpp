@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QMutexLocker>
+#include <QThread>
+#include <QTimer>
+
+#include "AudioLevelMeter.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr int DefaultInterval = 50;// In ms.
+	constexpr float DefaultThreshold = 0.01f;
+}
+
+AudioLevelMeter::AudioLevelMeter (QObject *parent) : QObject(parent) {
+	mInterval = DefaultInterval;
+	mThreshold = DefaultThreshold;
+}
+
+AudioLevelMeter::~AudioLevelMeter () {
+	if (mThread) {
+		mThread->quit();
+		mThread->wait();
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+void AudioLevelMeter::setSource (const Source &source, SourceThread thread) {
+	setMeteringSource(thread == MeteringThread ? source : nullptr);
+	setGuiSource(thread == GuiThread ? source : nullptr);
+	
+	if (!source)
+		setLevels(0, 0);
+	if (mRunning != bool(source)) {
+		mRunning = bool(source);
+		emit runningChanged(mRunning);
+	}
+}
+
+void AudioLevelMeter::setMeteringSource (const Source &source) {
+	{
+		QMutexLocker locker(&mSourceMutex);
+		mSource = source;
+	}
+	
+	if (source && !mThread) {
+		mThread = new QThread(this);
+		mThread->setObjectName("AudioLevelMeter");
+		mTimer = new QTimer();
+		mTimer->setInterval(mInterval);
+		mTimer->moveToThread(mThread);
+		QObject::connect(mTimer, &QTimer::timeout, mTimer, [this]() {
+			measure();
+		});
+		QObject::connect(mThread, &QThread::finished, mTimer, &QObject::deleteLater);
+		mThread->start();
+	}
+	
+	if (mTimer) {
+		const bool running = bool(source);
+		QMetaObject::invokeMethod(mTimer, [this, running]() {
+			mLastLevel = mLastPeak = 0;
+			if (running)
+				mTimer->start();
+			else
+				mTimer->stop();
+		}, Qt::QueuedConnection);
+	}
+}
+
+void AudioLevelMeter::setGuiSource (const Source &source) {
+	mGuiSource = source;
+	if (source && !mGuiTimer) {
+		mGuiTimer = new QTimer(this);
+		mGuiTimer->setInterval(mInterval);
+		QObject::connect(mGuiTimer, &QTimer::timeout, this, &AudioLevelMeter::measureOnGui);
+	}
+	if (mGuiTimer) {
+		if (source)
+			mGuiTimer->start();
+		else
+			mGuiTimer->stop();
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+void AudioLevelMeter::setInterval (int interval) {
+	if (interval <= 0 || mInterval == interval)
+		return;
+	mInterval = interval;
+	if (mGuiTimer)
+		mGuiTimer->setInterval(interval);
+	if (mTimer)
+		QMetaObject::invokeMethod(mTimer, [this, interval]() {
+			mTimer->setInterval(interval);
+		}, Qt::QueuedConnection);
+	emit intervalChanged(interval);
+}
+
+float AudioLevelMeter::getThreshold () const {
+	QMutexLocker locker(&mSourceMutex);
+	return mThreshold;
+}
+
+void AudioLevelMeter::setThreshold (float threshold) {
+	{
+		QMutexLocker locker(&mSourceMutex);
+		if (mThreshold == threshold)
+			return;
+		mThreshold = threshold;
+	}
+	emit thresholdChanged(threshold);
+}
+
+// -----------------------------------------------------------------------------
+
+// Metering thread.
+void AudioLevelMeter::measure () {
+	float level = 0, peak = 0, threshold;
+	{
+		QMutexLocker locker(&mSourceMutex);
+		if (!mSource || !mSource(level, peak))
+			return;
+		threshold = mThreshold;
+	}
+	
+	if (!hasChanged(level, peak, mLastLevel, mLastPeak, threshold))
+		return;
+	mLastLevel = level;
+	mLastPeak = peak;
+	QMetaObject::invokeMethod(this, [this, level, peak]() {
+		if (mRunning)// Else measured before the end of the source.
+			setLevels(level, peak);
+	}, Qt::QueuedConnection);
+}
+
+void AudioLevelMeter::measureOnGui () {
+	float level = 0, peak = 0;
+	if (mGuiSource && mGuiSource(level, peak) && hasChanged(level, peak, mLevel, mPeak, getThreshold()))
+		setLevels(level, peak);
+}
+
+// Silence is always pushed: the meter must not stay on the last level.
+bool AudioLevelMeter::hasChanged (float level, float peak, float lastLevel, float lastPeak, float threshold) {
+	const bool isSilent = qFuzzyIsNull(level) && qFuzzyIsNull(peak);
+	return qAbs(level - lastLevel) >= threshold || qAbs(peak - lastPeak) >= threshold
+		|| (isSilent && (lastLevel > 0 || lastPeak > 0));
+}
+
+void AudioLevelMeter::setLevels (float level, float peak) {
+	if (mLevel == level && mPeak == peak)
+		return;
+	mLevel = level;
+	mPeak = peak;
+	emit levelChanged(level, peak);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AUDIO_LEVEL_METER_H_
+#define AUDIO_LEVEL_METER_H_
+
+#include <functional>
+
+#include <QMutex>
+#include <QObject>
+
+// =============================================================================
+
+class QThread;
+class QTimer;
+
+// Levels are measured on a dedicated thread and pushed to the GUI thread
+// only when they change by more than the threshold.
+// Linphone objects are not thread-safe: their sources are measured on the GUI thread.
+class AudioLevelMeter : public QObject {
+	Q_OBJECT
+	
+	Q_PROPERTY(float level READ getLevel NOTIFY levelChanged)
+	Q_PROPERTY(float peak READ getPeak NOTIFY levelChanged)
+	Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+	
+	Q_PROPERTY(int interval READ getInterval WRITE setInterval NOTIFY intervalChanged)
+	Q_PROPERTY(float threshold READ getThreshold WRITE setThreshold NOTIFY thresholdChanged)
+	
+public:
+	// Called on the thread given to `setSource`. Linear levels: return false if there is nothing to measure.
+	typedef std::function<bool(float &level, float &peak)> Source;
+	
+	enum SourceThread {
+		MeteringThread,
+		GuiThread
+	};
+	
+	AudioLevelMeter (QObject *parent = Q_NULLPTR);
+	~AudioLevelMeter ();
+	
+	// The previous source is not called anymore when it returns. A null source stops the meter.
+	void setSource (const Source &source, SourceThread thread = MeteringThread);
+	
+	float getLevel () const {
+		return mLevel;
+	}
+	
+	float getPeak () const {
+		return mPeak;
+	}
+	
+	bool isRunning () const {
+		return mRunning;
+	}
+	
+	int getInterval () const {
+		return mInterval;
+	}
+	
+	void setInterval (int interval);
+	
+	float getThreshold () const;
+	void setThreshold (float threshold);
+	
+signals:
+	void levelChanged (float level, float peak);
+	void runningChanged (bool running);
+	void intervalChanged (int interval);
+	void thresholdChanged (float threshold);
+	
+private:
+	void setMeteringSource (const Source &source);
+	void setGuiSource (const Source &source);
+	
+	void measure ();
+	void measureOnGui ();
+	void setLevels (float level, float peak);
+	
+	static bool hasChanged (float level, float peak, float lastLevel, float lastPeak, float threshold);
+	
+	// Metering thread. Created with the first source.
+	QThread *mThread = nullptr;
+	QTimer *mTimer = nullptr;
+	float mLastLevel = 0;
+	float mLastPeak = 0;
+	
+	mutable QMutex mSourceMutex;// Protects the source and the threshold.
+	Source mSource;
+	float mThreshold;
+	
+	// GUI thread.
+	QTimer *mGuiTimer = nullptr;
+	Source mGuiSource;
+	float mLevel = 0;
+	float mPeak = 0;
+	bool mRunning = false;
+	int mInterval;
+};
+
+#endif // AUDIO_LEVEL_METER_H_
@@ -19,7 +19,6 @@
  */
 
 #include <QQmlApplicationEngine>
-#include <QQmlComponent>
 #include <QQuickWindow>
 #include <QQuickItem>
 #include <QQuickView>
@@ -27,7 +26,9 @@
 #include <QTimer>
 
 #include "app/App.hpp"
+#include "app/component-cache/ComponentCache.hpp"
 #include "components/call/CallModel.hpp"
+#include "components/core/CoreHandlers.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/timeline/TimelineModel.hpp"
 #include "components/timeline/TimelineListModel.hpp"
@@ -57,12 +58,23 @@ namespace {
 	
 	constexpr char NotificationPropertyTimer[] = "__timer";
 	
+	constexpr char NotificationPropertyWrapper[] = "__internalWrapper";
+	
+	constexpr char NotificationPropertyType[] = "__notificationType";
+	
 	// ---------------------------------------------------------------------------
 	// Arbitrary hardcoded values.
 	// ---------------------------------------------------------------------------
 	
 	constexpr int NotificationSpacing = 10;
 	constexpr int MaxNotificationsNumber = 5;
+	
+	constexpr int MaxPooledViews = 2;// By type and screen.
+	constexpr int PrewarmDelay = 3000;// Let the main window be displayed first.
+	
+	constexpr int CoalescingDelay = 1500;
+	constexpr int MaxCoalescingDelay = 5000;// Busy rooms are still updated.
+	constexpr int MessageSoundMinInterval = 3000;
 }
 
 // =============================================================================
@@ -88,34 +100,98 @@ const QHash<int, Notifier::Notification> Notifier::Notifications = {
 	{ Notifier::RecordingCompleted, { Notifier::RecordingCompleted, "NotificationRecordingCompleted.qml", 10 } }
 };
 
+// Notifications that come by bursts or that must be displayed quickly.
+const QList<int> Notifier::PooledNotifications = {
+	Notifier::ReceivedMessage,
+	Notifier::ReceivedFileMessage,
+	Notifier::ReceivedCall
+};
+
 
 
 // -----------------------------------------------------------------------------
 
 Notifier::Notifier (QObject *parent) : QObject(parent) {
-	const int nComponents = Notifications.size();
-	mComponents = new QQmlComponent *[nComponents];
-	
-	QQmlEngine *engine = App::getInstance()->getEngine();
-	for (const auto &key : Notifications.keys()) {
-		QQmlComponent *component = new QQmlComponent(engine, QUrl(NotificationsPath + Notifier::Notifications[key].filename));
-		if (Q_UNLIKELY(component->isError())) {
-			qWarning() << QStringLiteral("Errors found in `Notification` component %1:").arg(key) << component->errors();
-			abort();
-		}
-		mComponents[key] = component;
-	}
+	// Compiled in background: pooled notifications first.
+	ComponentCache *componentCache = App::getInstance()->getComponentCache();
+	for (int type : PooledNotifications)
+		componentCache->preload(getNotificationUrl(type));
+	for (const auto &key : Notifications.keys())
+		componentCache->preload(getNotificationUrl(key));
 	
 	mMutex = new QMutex();
+	
+	QTimer::singleShot(PrewarmDelay, this, &Notifier::prewarmViews);
+	
+	mCoalescingClock.start();
+	mCoalescingTimer.setSingleShot(true);
+	QObject::connect(&mCoalescingTimer, &QTimer::timeout, this, &Notifier::flushMessagesDigests);
 }
 
 Notifier::~Notifier () {
 	delete mMutex;
+	closeMessageSound();
 	
-	const int nComponents = Notifications.size();
-	for (int i = 0; i < nComponents; ++i)
-		mComponents[i]->deleteLater();
-	delete[] mComponents;
+	for (const auto &views : mNotificationViews)
+		qDeleteAll(views);
+}
+
+// -----------------------------------------------------------------------------
+
+QString Notifier::getNotificationUrl (int type) {
+	return QString(NotificationsPath) + Notifications[type].filename;
+}
+
+QQuickView *Notifier::createView (NotificationType type, QScreen *screen) {
+	// Use QQuickView to create a visual root object that is independant from current application Window, bound to the screen.
+	QQuickView *view = App::getInstance()->getComponentCache()->createView(getNotificationUrl(type), screen);
+	if (view->status() == QQuickView::Error) {	// Debug handler : show screens descriptions on Error
+		QScreen * primaryScreen = QGuiApplication::primaryScreen();
+		qInfo() << "Primary screen : " << primaryScreen->geometry() << primaryScreen->availableGeometry() <<  primaryScreen->virtualGeometry() <<  primaryScreen->availableVirtualGeometry();
+		QList<QScreen *> allScreens = QGuiApplication::screens();
+		for(int i = 0 ; i < allScreens.size() ; ++i){
+			QScreen *screen = allScreens[i];
+			qInfo() << QString("Screen [")+QString::number(i)+"] (hdpi, Geometry, Available, Virtual, AvailableGeometry) :" 
+					<< screen->devicePixelRatio() << screen->geometry() << screen->availableGeometry() << screen->virtualGeometry() << screen->availableVirtualGeometry();
+		}
+	}
+	view->setProperty("flags", QVariant(Qt::BypassWindowManagerHint | Qt::WindowStaysOnBottomHint | Qt::CustomizeWindowHint | Qt::X11BypassWindowManagerHint));	// Set the visual ghost window
+	view->setProperty(NotificationPropertyType, type);
+	return view;
+}
+
+QQuickView *Notifier::takeView (NotificationType type, QScreen *screen) {
+	QQuickView *view = App::getInstance()->getComponentCache()->takeView(getNotificationUrl(type), screen);
+	return view ? view : createView(type, screen);
+}
+
+// Return false if the view cannot be reused: it must be deleted.
+bool Notifier::recycleView (QQuickView *view) {
+	const int type = view->property(NotificationPropertyType).toInt();
+	if (!PooledNotifications.contains(type))
+		return false;
+	
+	QQuickItem *wrapperItem = view->findChild<QQuickItem *>(NotificationPropertyWrapper);
+	QQuickWindow *subWindow = view->findChild<QQuickWindow *>(NotificationPropertyWindow);
+	QMetaObject::invokeMethod(wrapperItem, "close", Qt::DirectConnection);
+	subWindow->hide();
+	// Release references on models.
+	::setProperty(*wrapperItem, NotificationPropertyData, QVariantMap());
+	
+	return App::getInstance()->getComponentCache()->recycleView(getNotificationUrl(type), view, MaxPooledViews);
+}
+
+void Notifier::prewarmViews () {
+	ComponentCache *componentCache = App::getInstance()->getComponentCache();
+	for (QScreen *screen : QGuiApplication::screens())
+		for (int type : PooledNotifications) {
+			const QString url = getNotificationUrl(type);
+			if (componentCache->getPooledViewsCount(url, screen) == 0) {
+				QQuickView *view = createView(NotificationType(type), screen);
+				if (!componentCache->recycleView(url, view, MaxPooledViews))
+					view->deleteLater();
+			}
+		}
 }
 
 // -----------------------------------------------------------------------------
@@ -132,6 +208,7 @@ QObject *Notifier::createNotification (Notifier::NotificationType type, QVariant
 	QList<QScreen *> allScreens = QGuiApplication::screens();
 	if(allScreens.size() > 0){	// Ensure to have a screen to avoid errors
 		QQuickItem * previousWrapper = nullptr;
+		QList<QQuickView *> views;
 		++mInstancesNumber;
 		bool showAsTool = false;
 #ifdef Q_OS_MACOS
@@ -143,31 +220,16 @@ QObject *Notifier::createNotification (Notifier::NotificationType type, QVariant
 		}
 #endif
 		for(int i = 0 ; i < allScreens.size() ; ++i){
-			QQuickView *view = new QQuickView(App::getInstance()->getEngine(), nullptr);	// Use QQuickView to create a visual root object that is independant from current application Window
 			QScreen *screen = allScreens[i];
-			QObject::connect(view, &QQuickView::statusChanged, [allScreens](QQuickView::Status status){	// Debug handler : show screens descriptions on Error
-				if( status == QQuickView::Error){
-					QScreen * primaryScreen = QGuiApplication::primaryScreen();
-					qInfo() << "Primary screen : " << primaryScreen->geometry() << primaryScreen->availableGeometry() <<  primaryScreen->virtualGeometry() <<  primaryScreen->availableVirtualGeometry();
-					for(int i = 0 ; i < allScreens.size() ; ++i){
-						QScreen *screen = allScreens[i];
-						qInfo() << QString("Screen [")+QString::number(i)+"] (hdpi, Geometry, Available, Virtual, AvailableGeometry) :" 
-								<< screen->devicePixelRatio() << screen->geometry() << screen->availableGeometry() << screen->virtualGeometry() << screen->availableVirtualGeometry();
-					}
-				}
-			});
-			view->setScreen(screen);	// Bind the visual root object to the screen
-			view->setProperty("flags", QVariant(Qt::BypassWindowManagerHint | Qt::WindowStaysOnBottomHint | Qt::CustomizeWindowHint | Qt::X11BypassWindowManagerHint));	// Set the visual ghost window
-			view->setSource(QString(NotificationsPath)+Notifier::Notifications[type].filename);
+			QQuickView *view = takeView(type, screen);
+			views << view;
 			
-			QQuickWindow *subWindow = view->findChild<QQuickWindow *>("__internalWindow");
-			QObject::connect(subWindow, &QObject::destroyed, view, &QObject::deleteLater);	// When destroying window, detroy visual root object too
+			QQuickWindow *subWindow = view->findChild<QQuickWindow *>(NotificationPropertyWindow);
 			
 			int * screenHeightOffset = &mScreenHeightOffset[screen->name()];	// Access optimization
 			QRect availableGeometry = screen->availableGeometry();
 			int heightOffset = availableGeometry.y() + (availableGeometry.height() - subWindow->height());//*screen->devicePixelRatio(); when using manual scaler
-			if(showAsTool)
-				subWindow->setProperty("showAsTool",true);
+			subWindow->setProperty("showAsTool",showAsTool);
 			subWindow->setX(availableGeometry.x()+ (availableGeometry.width()-subWindow->property("width").toInt()));//*screen->devicePixelRatio()); when using manual scaler
 			subWindow->setY(heightOffset-(*screenHeightOffset % heightOffset));
 			
@@ -179,7 +241,8 @@ QObject *Notifier::createNotification (Notifier::NotificationType type, QVariant
 			//				//subwindow->setProperty("xScale", (double)screen->availableVirtualGeometry().width()/availableGeometry.width() );
 			//				//subwindow->setProperty("yScale", (double)screen->availableVirtualGeometry().height()/availableGeometry.height());
 			//			}
-			wrapperItem = view->findChild<QQuickItem *>("__internalWrapper");
+			wrapperItem = view->findChild<QQuickItem *>(NotificationPropertyWrapper);
+			wrapperItem->setProperty("__valid", QVariant());// May be a recycled notification.
 			::setProperty(*wrapperItem, NotificationPropertyData,data);
 			view->setGeometry(subWindow->geometry());	// Ensure to have sufficient space to both let painter do job without error, and stay behind popup
 			
@@ -187,12 +250,13 @@ QObject *Notifier::createNotification (Notifier::NotificationType type, QVariant
 				QObject::connect(previousWrapper, SIGNAL(deleteNotification(QVariant)), wrapperItem,SLOT(deleteNotificationSlot()));
 				QObject::connect(wrapperItem, SIGNAL(isOpened()), previousWrapper,SLOT(open()));
 				QObject::connect(wrapperItem, SIGNAL(isClosed()), previousWrapper,SLOT(close()));
-				QObject::connect(wrapperItem, &QObject::destroyed, previousWrapper, &QObject::deleteLater);
 			}
 			previousWrapper = wrapperItem;	// The last one is used as a point of start when deleting and openning
 			
 			view->show();
+			subWindow->show();
 		}
+		mNotificationViews[wrapperItem] = views;
 		qInfo() << QStringLiteral("Create notifications:") << wrapperItem;
 	}
 	
@@ -206,6 +270,7 @@ void Notifier::showNotification (QObject *notification, int timeout) {
 	// Display notification.
 	QMetaObject::invokeMethod(notification, NotificationShowMethodName, Qt::DirectConnection);
 	
+	// The timer lives as long as the notification is displayed.
 	QTimer *timer = new QTimer(notification);
 	timer->setInterval(timeout);
 	timer->setSingleShot(true);
@@ -258,7 +323,66 @@ void Notifier::deleteNotification (QVariant notification) {
 	
 	mMutex->unlock();
 	
-	instance->deleteLater();
+	// Called from the notification itself: wait for it to return.
+	QMetaObject::invokeMethod(this, [this, instance]() {
+		releaseNotification(instance);
+	}, Qt::QueuedConnection);
+}
+
+void Notifier::updateNotification (QObject *notification, const QVariantMap &data) {
+	for (QQuickView *view : mNotificationViews.value(notification))
+		::setProperty(*view->findChild<QQuickItem *>(NotificationPropertyWrapper), NotificationPropertyData, data);
+	// Display it again for a full timeout.
+	notification->property(NotificationPropertyTimer).value<QTimer *>()->start();
+}
+
+void Notifier::releaseNotification (QObject *notification) {
+	QList<QQuickView *> views = mNotificationViews.take(notification);
+	for (auto it = mRoomNotifications.begin(); it != mRoomNotifications.end(); )
+		if (it->notification == notification)
+			it = mRoomNotifications.erase(it);
+		else
+			++it;
+	
+	delete notification->property(NotificationPropertyTimer).value<QTimer *>();
+	notification->setProperty(NotificationPropertyTimer, QVariant());
+	QObject::disconnect(notification, SIGNAL(deleteNotification(QVariant)), this, SLOT(deleteNotification(QVariant)));
+	
+	QQuickItem *previousWrapper = nullptr;
+	for (QQuickView *view : views) {
+		QQuickItem *wrapperItem = view->findChild<QQuickItem *>(NotificationPropertyWrapper);
+		if (previousWrapper) {
+			QObject::disconnect(previousWrapper, SIGNAL(deleteNotification(QVariant)), wrapperItem, SLOT(deleteNotificationSlot()));
+			QObject::disconnect(wrapperItem, SIGNAL(isOpened()), previousWrapper, SLOT(open()));
+			QObject::disconnect(wrapperItem, SIGNAL(isClosed()), previousWrapper, SLOT(close()));
+		}
+		previousWrapper = wrapperItem;
+		
+		if (!recycleView(view))
+			view->deleteLater();
+	}
+}
+
+// A notification is visible when its first frame is swapped.
+void Notifier::measureLatency (QObject *notification, const QElapsedTimer &receivedTimer) {
+	const QList<QQuickView *> views = mNotificationViews.value(notification);
+	if (!receivedTimer.isValid() || views.isEmpty())
+		return;
+	
+	QQuickWindow *subWindow = views.last()->findChild<QQuickWindow *>(NotificationPropertyWindow);
+	QObject *context = new QObject(notification->property(NotificationPropertyTimer).value<QTimer *>());
+	// `frameSwapped` can be emitted from the render thread: the connection is queued on `context`.
+	QObject::connect(subWindow, &QQuickWindow::frameSwapped, context, [this, context, receivedTimer]() mutable {
+		if (context) {
+			context->deleteLater();
+			context = nullptr;
+			const qint64 latency = receivedTimer.elapsed();
+			mLatencySum += latency;
+			++mLatencyCount;
+			qInfo() << QStringLiteral("Message notification displayed in %1 ms (average: %2 ms on %3).")
+				.arg(latency).arg(mLatencySum / mLatencyCount).arg(mLatencyCount);
+		}
+	});
 }
 
 // =============================================================================
@@ -274,35 +398,123 @@ void Notifier::deleteNotification (QVariant notification) {
 // Notification functions.
 // -----------------------------------------------------------------------------
 
-void Notifier::notifyReceivedMessages (const list<shared_ptr<linphone::ChatMessage>> &messages) {
+// The first messages of a quiet room are displayed at once. The next ones are coalesced until the room
+// is quiet for `CoalescingDelay`, or at most for `MaxCoalescingDelay`. Other rooms are not delayed.
+void Notifier::notifyReceivedMessages (const list<shared_ptr<linphone::ChatMessage>> &messages, const QElapsedTimer &receivedTimer) {
+	if (messages.empty())
+		return;
+	
+	shared_ptr<linphone::ChatRoom> chatRoom(messages.front()->getChatRoom());
+	const qint64 now = mCoalescingClock.elapsed();
+	RoomCoalescing &room = mCoalescingRooms[chatRoom.get()];
+	const bool quiet = room.deadline <= now;
+	
+	MessagesDigest &digest = room.pending;
+	if (digest.count == 0)
+		room.firstPendingTime = now;
+	digest.chatRoom = chatRoom;
+	digest.lastMessage = messages.back();
+	digest.count += int(messages.size());
+	room.deadline = qMin(now + CoalescingDelay, room.firstPendingTime + MaxCoalescingDelay);
+	
+	if (quiet) {
+		MessagesDigest pending = digest;
+		digest = MessagesDigest();
+		room.deadline = now + CoalescingDelay;
+		showMessagesDigest(pending, receivedTimer);
+	} else
+		mCoalescedMessages += int(messages.size());
+	scheduleMessagesDigests();
+}
+
+void Notifier::flushMessagesDigests () {
+	const qint64 now = mCoalescingClock.elapsed();
+	QList<MessagesDigest> digests;
+	for (auto it = mCoalescingRooms.begin(); it != mCoalescingRooms.end(); ) {
+		if (it->deadline > now)
+			++it;
+		else if (it->pending.count == 0)// Quiet.
+			it = mCoalescingRooms.erase(it);
+		else {
+			digests << it->pending;
+			it->pending = MessagesDigest();
+			it->deadline = now + CoalescingDelay;// Next messages are coalesced again.
+			++it;
+		}
+	}
+	for (const MessagesDigest &digest : digests)
+		showMessagesDigest(digest, QElapsedTimer());
+	
+	if (!digests.isEmpty()) {
+		qInfo() << QStringLiteral("Message notifications coalesced: %1 messages, %2 popups updated, %3 popups dropped, %4 sounds skipped.")
+			.arg(mCoalescedMessages).arg(mSupersededPopups).arg(mDroppedPopups).arg(mSkippedSounds);
+		mCoalescedMessages = mSupersededPopups = mDroppedPopups = mSkippedSounds = 0;
+	}
+	scheduleMessagesDigests();
+}
+
+// Quiet rooms without pending messages are removed by the next flush.
+void Notifier::scheduleMessagesDigests () {
+	qint64 deadline = -1;
+	for (const RoomCoalescing &room : mCoalescingRooms)
+		if (room.pending.count > 0 && (deadline < 0 || room.deadline < deadline))
+			deadline = room.deadline;
+	if (deadline < 0) {
+		if (!mCoalescingRooms.isEmpty())// Clean up.
+			mCoalescingTimer.start(CoalescingDelay);
+		else
+			mCoalescingTimer.stop();
+	} else
+		mCoalescingTimer.start(int(qMax(qint64(0), deadline - mCoalescingClock.elapsed())));
+}
+
+void Notifier::showMessagesDigest (const MessagesDigest &digest, const QElapsedTimer &receivedTimer) {
+	// A popup of the room is displayed: it is superseded by the digest.
+	RoomNotification *roomNotification = nullptr;
+	auto it = mRoomNotifications.find(digest.chatRoom.get());
+	if (it != mRoomNotifications.end())
+		roomNotification = &it.value();
+	const int count = digest.count + (roomNotification ? roomNotification->count : 0);
+	
 	QVariantMap map;
 	QString txt;
-	if( messages.size() > 0){
-		shared_ptr<linphone::ChatMessage> message = messages.front();
-		
-		if( messages.size() == 1){
-			if(! message->getFileTransferInformation() ){
-				foreach(auto content, message->getContents()){
-					if(content->isText())
-						txt += content->getUtf8Text().c_str();
-				}
-			}else
-				txt = tr("newFileMessage");
+	shared_ptr<linphone::ChatMessage> message = digest.lastMessage;
+	if( count == 1){
+		if(! message->getFileTransferInformation() ){
+			foreach(auto content, message->getContents()){
+				if(content->isText())
+					txt += content->getUtf8Text().c_str();
+			}
 		}else
-		//: 'New messages received!' Notification that warn the user of new messages.
-			txt = tr("newChatRoomMessages");
-		map["message"] = txt;
-		shared_ptr<linphone::ChatRoom> chatRoom(message->getChatRoom());
-		map["timelineModel"].setValue(CoreManager::getInstance()->getTimelineListModel()->getTimeline(chatRoom, true).get());
-		if( messages.size() == 1) {// Display only sender on mono message.
-			map["peerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asStringUriOnly());
-			map["fullPeerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asString());
-		}
-		map["localAddress"] = Utils::coreStringToAppString(message->getToAddress()->asStringUriOnly());
-		map["fullLocalAddress"] = Utils::coreStringToAppString(message->getToAddress()->asString());
-		map["window"].setValue(App::getInstance()->getMainWindow());
-		CREATE_NOTIFICATION(Notifier::ReceivedMessage, map)
+			txt = tr("newFileMessage");
+	}else
+	//: 'New messages received!' Notification that warn the user of new messages.
+		txt = tr("newChatRoomMessages");
+	map["message"] = txt;
+	map["timelineModel"].setValue(CoreManager::getInstance()->getTimelineListModel()->getTimeline(digest.chatRoom, true).get());
+	if( count == 1) {// Display only sender on mono message.
+		map["peerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asStringUriOnly());
+		map["fullPeerAddress"] = Utils::coreStringToAppString(message->getFromAddress()->asString());
 	}
+	map["localAddress"] = Utils::coreStringToAppString(message->getToAddress()->asStringUriOnly());
+	map["fullLocalAddress"] = Utils::coreStringToAppString(message->getToAddress()->asString());
+	map["window"].setValue(App::getInstance()->getMainWindow());
+	
+	if (roomNotification) {
+		updateNotification(roomNotification->notification, map);
+		roomNotification->count = count;
+		++mSupersededPopups;
+		return;
+	}
+	
+	QObject *notification = createNotification(Notifier::ReceivedMessage, map);
+	if (!notification) {
+		++mDroppedPopups;
+		return;
+	}
+	showNotification(notification, Notifications[Notifier::ReceivedMessage].getTimeout() * 1000);
+	mRoomNotifications[digest.chatRoom.get()] = { notification, count };
+	measureLatency(notification, receivedTimer);
 }
 
 void Notifier::notifyReceivedFileMessage (const shared_ptr<linphone::ChatMessage> &message, const shared_ptr<linphone::Content> &content) {
@@ -310,7 +522,7 @@ void Notifier::notifyReceivedFileMessage (const shared_ptr<linphone::ChatMessage
 	shared_ptr<linphone::ChatRoom> chatRoom(message->getChatRoom());
 	map["timelineModel"].setValue(CoreManager::getInstance()->getTimelineListModel()->getTimeline(chatRoom, true).get());
 	map["fileUri"] = Utils::coreStringToAppString(content->getFilePath());
-	if( Utils::getImage(map["fileUri"].toString()).isNull())
+	if( !Utils::isImage(map["fileUri"].toString()))
 		map["imageUri"] = "";
 	else
 		map["imageUri"] = map["fileUri"];
@@ -323,8 +535,9 @@ void Notifier::notifyReceivedCall (const shared_ptr<linphone::Call> &call) {
 	QVariantMap map;
 	map["call"].setValue(callModel);
 	CREATE_NOTIFICATION(Notifier::ReceivedCall, map)
-			
-			QObject::connect(callModel, &CallModel::statusChanged, notification, [this, notification](CallModel::CallStatus status) {
+	
+	// The notification is recycled when it is closed: the timer is used as context.
+	QObject::connect(callModel, &CallModel::statusChanged, notification->property(NotificationPropertyTimer).value<QTimer *>(), [this, notification](CallModel::CallStatus status) {
 		if (status == CallModel::CallStatusEnded || status == CallModel::CallStatusConnected)
 			deleteNotification(QVariant::fromValue(notification));
 	});
@@ -350,5 +563,63 @@ void Notifier::notifyRecordingCompleted (const QString &filePath) {
 	CREATE_NOTIFICATION(Notifier::RecordingCompleted, map)
 }
 
+// -----------------------------------------------------------------------------
+
+void Notifier::playReceivedMessageSound () {
+	if (mMessageSoundTimer.isValid() && mMessageSoundTimer.elapsed() < MessageSoundMinInterval) {
+		++mSkippedSounds;
+		return;
+	}
+	mMessageSoundTimer.start();
+	
+	// The sound card is left to calls: the player is only opened outside of them.
+	CoreManager *coreManager = CoreManager::getInstance();
+	if (coreManager->getCore()->getCallsNb() > 0 || !openMessageSound()) {// Let the core try to play it.
+		coreManager->getCore()->playLocal(Utils::appStringToCoreString(coreManager->getSettingsModel()->getChatNotificationSoundPath()));
+		return;
+	}
+	// The player is paused at the end of the sound: rewind it.
+	mMessageSoundPlayer->pause();
+	mMessageSoundPlayer->seek(0);
+	if (mMessageSoundPlayer->start())
+		qWarning() << QStringLiteral("Unable to play message sound.");
+}
+
+bool Notifier::openMessageSound () {
+	if (mMessageSoundPlayer)
+		return true;
+	
+	// Settings are created with the core manager, after the notifier: connect them on first use.
+	CoreManager *coreManager = CoreManager::getInstance();
+	SettingsModel *settingsModel = coreManager->getSettingsModel();
+	QObject::connect(settingsModel, &SettingsModel::chatNotificationSoundPathChanged, this, &Notifier::closeMessageSound, Qt::UniqueConnection);
+	QObject::connect(settingsModel, &SettingsModel::ringerDeviceChanged, this, &Notifier::closeMessageSound, Qt::UniqueConnection);
+	QObject::connect(coreManager->getHandlers().get(), &CoreHandlers::callStateChanged, this, &Notifier::handleCallStateChanged, Qt::UniqueConnection);
+	
+	const QString soundPath = settingsModel->getChatNotificationSoundPath();
+	shared_ptr<linphone::Player> player = coreManager->getCore()->createLocalPlayer(
+		Utils::appStringToCoreString(settingsModel->getRingerDevice()), "", nullptr
+	);
+	if (!player || player->open(Utils::appStringToCoreString(soundPath))) {
+		qWarning() << QStringLiteral("Unable to load message sound: `%1`.").arg(soundPath);
+		return false;
+	}
+	mMessageSoundPlayer = player;
+	return true;
+}
+
+// The ringer device is needed to ring, the sound card by the call.
+void Notifier::handleCallStateChanged (const shared_ptr<linphone::Call> &, linphone::Call::State state) {
+	if (state == linphone::Call::State::IncomingReceived || state == linphone::Call::State::OutgoingInit)
+		closeMessageSound();
+}
+
+void Notifier::closeMessageSound () {
+	if (mMessageSoundPlayer) {
+		mMessageSoundPlayer->close();
+		mMessageSoundPlayer = nullptr;
+	}
+}
+
 #undef SHOW_NOTIFICATION
 #undef CREATE_NOTIFICATION
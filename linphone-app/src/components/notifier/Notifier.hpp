@@ -23,15 +23,18 @@
 
 #include <memory>
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QHash>
+#include <QTimer>
 
 #include "components/core/CoreManager.hpp"
 #include "components/settings/SettingsModel.hpp"
 // =============================================================================
 
 class QMutex;
-class QQmlComponent;
+class QQuickView;
+class QScreen;
 
 namespace linphone {
 class Call;
@@ -54,13 +57,17 @@ public:
 		RecordingCompleted
 	};
 	
-	void notifyReceivedMessages (const std::list<std::shared_ptr<linphone::ChatMessage>> &messages);
+	// `receivedTimer` is started on reception: the latency until the popup is displayed is logged.
+	void notifyReceivedMessages (const std::list<std::shared_ptr<linphone::ChatMessage>> &messages, const QElapsedTimer &receivedTimer = QElapsedTimer());
 	void notifyReceivedFileMessage (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content);
 	void notifyReceivedCall (const std::shared_ptr<linphone::Call> &call);
 	void notifyNewVersionAvailable (const QString &version, const QString &url);
 	void notifySnapshotWasTaken (const QString &filePath);
 	void notifyRecordingCompleted (const QString &filePath);
 	
+	// Sounds of received messages are rate-limited.
+	void playReceivedMessageSound ();
+	
 public slots:
 	void deleteNotificationOnTimeout(QVariant notification);
 	void deleteNotification (QVariant notification);
@@ -84,16 +91,74 @@ private:
 		int type;
 	};
 	
+	// Messages received in a room are coalesced over a short window into one popup.
+	struct MessagesDigest {
+		std::shared_ptr<linphone::ChatRoom> chatRoom;
+		std::shared_ptr<linphone::ChatMessage> lastMessage;
+		int count = 0;
+	};
+	
+	// Each room has its own window, restarted by each message.
+	struct RoomCoalescing {
+		MessagesDigest pending;
+		qint64 firstPendingTime = 0;
+		qint64 deadline = 0;// The room is quiet after it.
+	};
+	
+	struct RoomNotification {
+		QObject *notification = nullptr;
+		int count = 0;// Messages displayed in the popup.
+	};
+	
+	void showMessagesDigest (const MessagesDigest &digest, const QElapsedTimer &receivedTimer);
+	
+	bool openMessageSound ();
+	void closeMessageSound ();
+	void handleCallStateChanged (const std::shared_ptr<linphone::Call> &call, linphone::Call::State state);
+	void flushMessagesDigests ();
+	void scheduleMessagesDigests ();
+	
 	QObject *createNotification (NotificationType type, QVariantMap data);
+	void updateNotification (QObject *notification, const QVariantMap &data);
 	void showNotification (QObject *notification, int timeout);
+	void releaseNotification (QObject *notification);
+	void measureLatency (QObject *notification, const QElapsedTimer &receivedTimer);
+	
+	// Views are expensive to create: they are created hidden in advance and recycled on close.
+	// The pool is held by the component cache of the app.
+	static QString getNotificationUrl (int type);
+	QQuickView *createView (NotificationType type, QScreen *screen);
+	QQuickView *takeView (NotificationType type, QScreen *screen);
+	bool recycleView (QQuickView *view);
+	void prewarmViews ();
 	
 	QHash<QString,int> mScreenHeightOffset;
 	int mInstancesNumber = 0;
 	
+	QHash<QObject *, QList<QQuickView *>> mNotificationViews;// By displayed notification.
+	
+	int mLatencyCount = 0;
+	qint64 mLatencySum = 0;
+	
+	QHash<const linphone::ChatRoom *, RoomCoalescing> mCoalescingRooms;
+	QHash<const linphone::ChatRoom *, RoomNotification> mRoomNotifications;
+	QElapsedTimer mCoalescingClock;
+	QTimer mCoalescingTimer;// Started for the nearest deadline of the rooms that have pending messages.
+	QElapsedTimer mMessageSoundTimer;
+	// Opened on the first message and kept to not decode the sound each time.
+	// Closed when a call needs the ringer device, or when the sound or the device changes.
+	std::shared_ptr<linphone::Player> mMessageSoundPlayer;
+	
+	// Suppressed events since the last report.
+	int mCoalescedMessages = 0;
+	int mSupersededPopups = 0;
+	int mDroppedPopups = 0;
+	int mSkippedSounds = 0;
+	
 	QMutex *mMutex = nullptr;
-	QQmlComponent **mComponents = nullptr;
 	
 	static const QHash<int, Notification> Notifications;
+	static const QList<int> PooledNotifications;
 };
 
 #endif // NOTIFIER_H_
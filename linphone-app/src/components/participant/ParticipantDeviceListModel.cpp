@@ -19,6 +19,7 @@
  */
 
 #include <QQmlApplicationEngine>
+#include <QSet>
 #include <algorithm>
 
 #include "app/App.hpp"
@@ -33,12 +34,9 @@
 ParticipantDeviceListModel::ParticipantDeviceListModel (std::shared_ptr<linphone::Participant> participant, QObject *parent) : ProxyListModel(parent) {
 	std::list<std::shared_ptr<linphone::ParticipantDevice>> devices = participant->getDevices() ;
 	mCallModel = nullptr;
-	for(auto device : devices){
-		auto deviceModel = ParticipantDeviceModel::create(mCallModel, device, isMe(device));
-		connect(this, &ParticipantDeviceListModel::securityLevelChanged, deviceModel.get(), &ParticipantDeviceModel::onSecurityLevelChanged);
-		connect(deviceModel.get(), &ParticipantDeviceModel::isSpeakingChanged, this, &ParticipantDeviceListModel::onParticipantDeviceSpeaking);
-		mList << deviceModel;
-	}
+	for(auto device : devices)
+		mList << createDeviceModel(device, isMe(device));
+	updateRows();
 	mInitialized = true;
 }
 
@@ -71,82 +69,101 @@ void ParticipantDeviceListModel::initConferenceModel(){
 	}
 }
 
+// Only changes are applied: remaining devices keep their model (and their delegates).
 void ParticipantDeviceListModel::updateDevices(std::shared_ptr<linphone::Participant> participant){
 	std::list<std::shared_ptr<linphone::ParticipantDevice>> devices = participant->getDevices() ;
-	bool meAdded = false;
-	beginResetModel();
+	QSet<const linphone::ParticipantDevice*> currentDevices;
 	qDebug() << "Update devices from participant";
-	mList.clear();
-	for(auto device : devices){
-		bool addMe = isMe(device);
-		auto deviceModel = ParticipantDeviceModel::create(mCallModel, device, addMe);
-		connect(this, &ParticipantDeviceListModel::securityLevelChanged, deviceModel.get(), &ParticipantDeviceModel::onSecurityLevelChanged);
-		connect(deviceModel.get(), &ParticipantDeviceModel::isSpeakingChanged, this, &ParticipantDeviceListModel::onParticipantDeviceSpeaking);
-		mList << deviceModel;
-		if( addMe)
-			meAdded = true;
+	for(auto device : devices)
+		currentDevices << device.get();
+	// Remove obsolete devices by ranges, from the end to keep rows valid.
+	for(int row = mList.size() - 1 ; row >= 0 ; --row){
+		if( !currentDevices.contains(mList[row].objectCast<ParticipantDeviceModel>()->getDevice().get())){
+			int last = row;
+			while(row > 0 && !currentDevices.contains(mList[row - 1].objectCast<ParticipantDeviceModel>()->getDevice().get()))
+				--row;
+			removeRows(row, last - row + 1);
+		}
 	}
-	endResetModel();
-	if( meAdded)
-		emit meChanged();
+	addDevices(devices);
 }
 
 void ParticipantDeviceListModel::updateDevices(const std::list<std::shared_ptr<linphone::ParticipantDevice>>& devices, const bool& isMe){
-	for(auto device : devices){
-		add(device);
-	}
+	addDevices(devices);
 }
 
 bool ParticipantDeviceListModel::add(std::shared_ptr<linphone::ParticipantDevice> deviceToAdd){
-	qDebug() << "Adding device " << deviceToAdd->getAddress()->asString().c_str();
-	for(auto item : mList) {
-		auto deviceModel = item.objectCast<ParticipantDeviceModel>();
-		if(deviceModel->getDevice() == deviceToAdd) {
+	return addDevices({deviceToAdd}) > 0;
+}
+
+// New devices are inserted with one ranged insertion. Return the number of added devices.
+int ParticipantDeviceListModel::addDevices(const std::list<std::shared_ptr<linphone::ParticipantDevice>>& devices){
+	QList<QSharedPointer<ParticipantDeviceModel>> newDevices;
+	QSet<const linphone::ParticipantDevice*> newDevicesSet;
+	bool meAdded = false;
+	for(auto device : devices){
+		qDebug() << "Adding device " << device->getAddress()->asString().c_str();
+		auto deviceModel = get(device);
+		if(deviceModel) {
 			qDebug() << "Device already exist. Send video update event";
 			deviceModel->updateVideoEnabled();
-			return false;
+		}else if( !newDevicesSet.contains(device.get())){
+			bool addMe = isMe(device);
+			newDevices << createDeviceModel(device, addMe);
+			newDevicesSet << device.get();
+			meAdded |= addMe;
 		}
 	}
-	bool addMe = isMe(deviceToAdd);
-	auto deviceModel = ParticipantDeviceModel::create(mCallModel, deviceToAdd, addMe);
-	connect(this, &ParticipantDeviceListModel::securityLevelChanged, deviceModel.get(), &ParticipantDeviceModel::onSecurityLevelChanged);
-	connect(deviceModel.get(), &ParticipantDeviceModel::isSpeakingChanged, this, &ParticipantDeviceListModel::onParticipantDeviceSpeaking);
-	ProxyListModel::add<ParticipantDeviceModel>(deviceModel);
-	qDebug() << "Device added. Count=" << mList.count();
-	if( addMe){
+	if( newDevices.size() > 0){
+		int first = mList.size();
+		ProxyListModel::add<ParticipantDeviceModel>(newDevices);
+		updateRows(first);
+		qDebug() << "Devices added. Count=" << mList.count();
+	}
+	if( meAdded){
 		qDebug() << "Added a me device";
 		emit meChanged();
 	}
-	return true;
+	return newDevices.size();
 }
 
 bool ParticipantDeviceListModel::remove(std::shared_ptr<const linphone::ParticipantDevice> deviceToRemove){
-	int row = 0;
-	for(auto item : mList){
-		auto device = item.objectCast<ParticipantDeviceModel>();
-		if( device->getDevice() == deviceToRemove){
-			device->updateVideoEnabled();
-			mActiveSpeakers.removeAll(device.get());
-			removeRow(row);
-			return true;
-		}else
-			++row;
+	int row;
+	auto device = get(deviceToRemove, &row);
+	if( device){
+		device->updateVideoEnabled();
+		return removeRow(row);
 	}
 	return false;
 }
 
-QSharedPointer<ParticipantDeviceModel> ParticipantDeviceListModel::get(std::shared_ptr<const linphone::ParticipantDevice> deviceToGet, int * index){
-	int row = 0;
-	for(auto item : mList){
-		auto device = item.objectCast<ParticipantDeviceModel>();
-		if( device->getDevice() == deviceToGet){
-			if(index)
-				*index = row;
-			return device;
-		}else
-			++row;
+bool ParticipantDeviceListModel::removeRows (int row, int count, const QModelIndex &parent) {
+	if (row < 0 || count < 0 || row + count > mList.count())
+		return false;
+	for(int i = row ; i < row + count ; ++i){
+		auto device = mList[i].objectCast<ParticipantDeviceModel>();
+		mRows.remove(device->getDevice().get());
+		removeActiveSpeaker(device.get());
 	}
-	return nullptr;
+	bool removed = ProxyListModel::removeRows(row, count, parent);
+	updateRows(row);
+	return removed;
+}
+
+void ParticipantDeviceListModel::clearData(){
+	mRows.clear();
+	mActiveSpeakers.clear();
+	mActiveSpeakerPositions.clear();
+	ProxyListModel::clearData();
+}
+
+QSharedPointer<ParticipantDeviceModel> ParticipantDeviceListModel::get(std::shared_ptr<const linphone::ParticipantDevice> deviceToGet, int * index){
+	auto it = mRows.find(deviceToGet.get());
+	if( it == mRows.end())
+		return nullptr;
+	if(index)
+		*index = *it;
+	return mList[*it].objectCast<ParticipantDeviceModel>();
 }
 
 QSharedPointer<ParticipantDeviceModel> ParticipantDeviceListModel::getMe(int * index)const{
@@ -170,7 +187,27 @@ ParticipantDeviceModel* ParticipantDeviceListModel::getLastActiveSpeaking() cons
 		else
 			return mList.back().objectCast<ParticipantDeviceModel>().get();
 	}else
-		return mActiveSpeakers.first();
+		return mActiveSpeakers.front();
+}
+
+QSharedPointer<ParticipantDeviceModel> ParticipantDeviceListModel::createDeviceModel(std::shared_ptr<linphone::ParticipantDevice> device, const bool& isMe){
+	auto deviceModel = ParticipantDeviceModel::create(mCallModel, device, isMe);
+	connect(this, &ParticipantDeviceListModel::securityLevelChanged, deviceModel.get(), &ParticipantDeviceModel::onSecurityLevelChanged);
+	connect(deviceModel.get(), &ParticipantDeviceModel::isSpeakingChanged, this, &ParticipantDeviceListModel::onParticipantDeviceSpeaking);
+	return deviceModel;
+}
+
+void ParticipantDeviceListModel::updateRows(int from){
+	for(int row = from ; row < mList.size() ; ++row)
+		mRows[mList[row].objectCast<ParticipantDeviceModel>()->getDevice().get()] = row;
+}
+
+void ParticipantDeviceListModel::removeActiveSpeaker(ParticipantDeviceModel * device){
+	auto it = mActiveSpeakerPositions.find(device);
+	if( it != mActiveSpeakerPositions.end()){
+		mActiveSpeakers.erase(*it);
+		mActiveSpeakerPositions.erase(it);
+	}
 }
 
 bool ParticipantDeviceListModel::isMe(std::shared_ptr<linphone::ParticipantDevice> deviceToCheck)const{
@@ -210,8 +247,7 @@ void ParticipantDeviceListModel::onParticipantAdded(const std::shared_ptr<const
 	if(devices.size() == 0)
 		qDebug() << "Participant has no device. It will not be added : " << participant->getAddress()->asString().c_str();
 	else
-		for(auto device : devices)
-			add(device);
+		addDevices(devices);
 }
 
 void ParticipantDeviceListModel::onParticipantRemoved(const std::shared_ptr<const linphone::Participant> & participant){
@@ -261,14 +297,15 @@ void ParticipantDeviceListModel::onParticipantDeviceMediaCapabilityChanged(const
 	auto device = get(participantDevice);
 	if(device)
 		device->updateVideoEnabled();
-	else
+	else{
 		onParticipantDeviceAdded(participantDevice);
-		
-	device = get(participantDevice);
-	if( device && device->isMe()){	// Capability change for me. Update all videos.
+		device = get(participantDevice);
+	}
+	if( device && device->isMe()){	// Capability change for me. Update other videos: me devices are always enabled.
 		for(auto item : mList) {
-			auto device = item.objectCast<ParticipantDeviceModel>();
-			device->updateVideoEnabled();
+			auto otherDevice = item.objectCast<ParticipantDeviceModel>();
+			if( !otherDevice->isMe())
+				otherDevice->updateVideoEnabled();
 		}
 	}
 }
@@ -289,13 +326,15 @@ void ParticipantDeviceListModel::onParticipantDeviceIsSpeakingChanged(const std:
 
 void ParticipantDeviceListModel::onParticipantDeviceSpeaking(){
 	auto deviceModel = qobject_cast<ParticipantDeviceModel*>(sender());
-	bool changed = false;
 	// Me should not be in the list.
 	if( !deviceModel->isMe() && (mActiveSpeakers.size() == 0 || deviceModel->getIsSpeaking())) {// Ensure to have at least one last active speaker
-		changed = mActiveSpeakers.removeAll(deviceModel) > 0;
-		mActiveSpeakers.push_front(deviceModel);
-		changed = true;
-	}
-	if(changed)
+		auto it = mActiveSpeakerPositions.find(deviceModel);
+		if( it == mActiveSpeakerPositions.end())
+			mActiveSpeakerPositions[deviceModel] = mActiveSpeakers.insert(mActiveSpeakers.begin(), deviceModel);
+		else if( *it != mActiveSpeakers.begin())
+			mActiveSpeakers.splice(mActiveSpeakers.begin(), mActiveSpeakers, *it);// Iterators stay valid.
+		else// Already the last active speaker.
+			return;
 		emit participantSpeaking(deviceModel);
+	}
 }
@@ -26,7 +26,9 @@
 // =============================================================================
 #include <QObject>
 #include <QDateTime>
+#include <QHash>
 #include <QString>
+#include <list>
 #include "app/proxyModel/ProxyListModel.hpp"
 #include "components/call/CallModel.hpp"
 
@@ -45,6 +47,7 @@ public:
 	
 	bool add(std::shared_ptr<linphone::ParticipantDevice> deviceToAdd);
 	bool remove(std::shared_ptr<const linphone::ParticipantDevice> deviceToAdd);
+	virtual bool removeRows (int row, int count, const QModelIndex &parent = QModelIndex()) override;
 	QSharedPointer<ParticipantDeviceModel> get(std::shared_ptr<const linphone::ParticipantDevice> deviceToGet, int * index = nullptr);
 	QSharedPointer<ParticipantDeviceModel> getMe(int * index = nullptr)const;
 	ParticipantDeviceModel* getLastActiveSpeaking() const;
@@ -72,8 +75,16 @@ signals:
 	void meChanged();
 	
 private:
+	int addDevices(const std::list<std::shared_ptr<linphone::ParticipantDevice>>& devices);
+	QSharedPointer<ParticipantDeviceModel> createDeviceModel(std::shared_ptr<linphone::ParticipantDevice> device, const bool& isMe);
+	void updateRows(int from = 0);
+	void removeActiveSpeaker(ParticipantDeviceModel * device);
+	virtual void clearData() override;
+	
 	CallModel * mCallModel = nullptr;
-	QList<ParticipantDeviceModel*> mActiveSpeakers;// First item is last speaker
+	QHash<const linphone::ParticipantDevice*, int> mRows;// Device => row in mList
+	std::list<ParticipantDeviceModel*> mActiveSpeakers;// First item is last speaker
+	QHash<ParticipantDeviceModel*, std::list<ParticipantDeviceModel*>::iterator> mActiveSpeakerPositions;
 	bool mInitialized = false;
 	
 };
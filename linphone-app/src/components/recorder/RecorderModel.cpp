@@ -24,8 +24,10 @@
 #include "app/App.hpp"
 #include "app/paths/Paths.hpp"
 #include "components/core/CoreManager.hpp"
+#include "components/level-meter/AudioLevelMeter.hpp"
 #include "components/settings/SettingsModel.hpp"
 #include "utils/Utils.hpp"
+#include "utils/WaveformStore.hpp"
 
 #include "RecorderModel.hpp"
 
@@ -34,6 +36,7 @@
 RecorderModel::RecorderModel ( std::shared_ptr<linphone::Recorder> recorder, QObject * parent) : QObject(parent) {
 	App::getInstance()->getEngine()->setObjectOwnership(this, QQmlEngine::CppOwnership);// Avoid QML to destroy it when passing by Q_INVOKABLE
 	mRecorder= recorder;
+	mCaptureLevelMeter = new AudioLevelMeter(this);
 }
 
 RecorderModel::~RecorderModel(){
@@ -56,6 +59,10 @@ float RecorderModel::getCaptureVolume()const{
 	return mRecorder->getCaptureVolume();
 }
 
+AudioLevelMeter *RecorderModel::getCaptureLevelMeter() const{
+	return mCaptureLevelMeter;
+}
+
 LinphoneEnums::RecorderState RecorderModel::getState() const{
 	return LinphoneEnums::fromLinphone(mRecorder->getState());
 }
@@ -81,20 +88,31 @@ void RecorderModel::start(){
 		qWarning() << QStringLiteral("Unable to open safe file path for: %1.").arg(filename);
 	else if( mRecorder->start() < 0)
 		qWarning() << QStringLiteral("Unable to start recording to : %1.").arg(filename);
+	else {
+		std::shared_ptr<linphone::Recorder> recorder = mRecorder;
+		mCaptureLevelMeter->setSource([recorder](float &level, float &peak) {
+			level = peak = recorder->getCaptureVolume();// No peak from the recorder.
+			return true;
+		}, AudioLevelMeter::GuiThread);
+	}
 	emit stateChanged();
 	emit fileChanged();
 }
 
 void RecorderModel::pause(){
+	mCaptureLevelMeter->setSource(nullptr);
 	mRecorder->pause();
 	emit stateChanged();
 }
 
 void RecorderModel::stop(){
+	mCaptureLevelMeter->setSource(nullptr);
 	if(mRecorder->getState() == linphone::RecorderState::Running)	// Remove these tests when the SDK do them.
 		mRecorder->pause();
-	if(mRecorder->getState() == linphone::RecorderState::Paused)
+	if(mRecorder->getState() == linphone::RecorderState::Paused) {
 		mRecorder->close();
+		WaveformStore::requestWaveform(getFile());// Ready when the recording is sent.
+	}
 	emit stateChanged();
 }
 
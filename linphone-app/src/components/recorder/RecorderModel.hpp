@@ -25,6 +25,7 @@
 
 // =============================================================================
 
+class AudioLevelMeter;
 
 class RecorderModel : public QObject {
 	Q_OBJECT
@@ -36,11 +37,13 @@ public:
 	
 	Q_PROPERTY(LinphoneEnums::RecorderState state READ getState NOTIFY stateChanged)
 	Q_PROPERTY(QString file READ getFile NOTIFY fileChanged)
+	Q_PROPERTY(AudioLevelMeter *captureLevelMeter READ getCaptureLevelMeter CONSTANT)// Running while recording.
 	
 	std::shared_ptr<linphone::Recorder> getRecorder();
 	
 	Q_INVOKABLE int getDuration()const;
 	Q_INVOKABLE float getCaptureVolume()const;
+	AudioLevelMeter *getCaptureLevelMeter() const;
 	LinphoneEnums::RecorderState getState() const;
 	Q_INVOKABLE QString getFile()const;
 	
@@ -54,6 +57,7 @@ signals:
 	
 private:
 	std::shared_ptr<linphone::Recorder> mRecorder;
+	AudioLevelMeter *mCaptureLevelMeter = nullptr;
 };
 Q_DECLARE_METATYPE(std::shared_ptr<RecorderModel>)
 Q_DECLARE_METATYPE(RecorderModel*)
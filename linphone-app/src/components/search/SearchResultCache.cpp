@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <linphone++/linphone.hh>
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
+
+#include "components/core/CoreManager.hpp"
+#include "utils/Utils.hpp"
+
+#include "SearchResultCache.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr int CacheSize = 64;
+	constexpr qint64 EntryLifetime = 30000;// In ms.
+	
+	struct Entry {
+		SearchResultCache::Results results;
+		bool truncated = false;
+		qint64 timestamp = 0;
+	};
+	
+	QMutex Mutex;
+	QCache<QString, Entry> Entries(CacheSize);
+}
+
+// Enabled LDAP servers are part of the key: editing the LDAP configuration invalidates previous results.
+static QString getLdapKey () {
+	QString key;
+	for (const auto &ldap : CoreManager::getInstance()->getCore()->getLdapList()) {
+		auto params = ldap->getParams();
+		if (!params->getEnabled())
+			continue;
+		key += Utils::coreStringToAppString(params->getServer()) + '|'
+			+ Utils::coreStringToAppString(params->getBaseObject()) + '|'
+			+ Utils::coreStringToAppString(params->getFilter()) + '|'
+			+ QString::number(params->getMaxResults()) + ';';
+	}
+	return key;
+}
+
+static QString normalize (const QString &filter) {
+	return filter.trimmed().toLower();
+}
+
+static QString getKey (const QString &ldapKey, const QString &filter) {
+	return ldapKey + '\n' + filter;
+}
+
+bool SearchResultCache::find (const QString &filter, Results &results) {
+	const QString ldapKey = getLdapKey();
+	const QString normalizedFilter = normalize(filter);
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	
+	QMutexLocker locker(&Mutex);
+	for (int length = normalizedFilter.length(); length >= 0; --length) {
+		const QString key = getKey(ldapKey, normalizedFilter.left(length));
+		Entry *entry = Entries.object(key);
+		if (!entry)
+			continue;
+		if (now - entry->timestamp > EntryLifetime) {
+			Entries.remove(key);
+			continue;
+		}
+		if (length == normalizedFilter.length()) {
+			results = entry->results;
+			return true;
+		}
+		// A truncated prefix result may miss entries matching the longer filter.
+		if (entry->truncated)
+			return false;
+		results.clear();
+		for (const auto &result : entry->results)
+			if (matches(result, normalizedFilter))
+				results << result;
+		return true;
+	}
+	return false;
+}
+
+void SearchResultCache::insert (const QString &filter, const Results &results, bool truncated) {
+	const QString ldapKey = getLdapKey();
+	
+	Entry *entry = new Entry();
+	entry->results = results;
+	entry->truncated = truncated;
+	entry->timestamp = QDateTime::currentMSecsSinceEpoch();
+	
+	QMutexLocker locker(&Mutex);
+	Entries.insert(getKey(ldapKey, normalize(filter)), entry);
+}
+
+void SearchResultCache::clear () {
+	QMutexLocker locker(&Mutex);
+	Entries.clear();
+}
+
+bool SearchResultCache::isTruncated (
+	const std::shared_ptr<const linphone::MagicSearch> &magicSearch,
+	const std::list<std::shared_ptr<linphone::SearchResult>> &results
+) {
+	if (magicSearch->getLimitedSearch() && int(results.size()) >= magicSearch->getSearchLimit())
+		return true;
+	
+	// Results don't tell which LDAP server they come from: any server may have reached its own limit.
+	int maxResults = 0;
+	for (const auto &ldap : CoreManager::getInstance()->getCore()->getLdapList()) {
+		auto params = ldap->getParams();
+		if (params->getEnabled() && params->getMaxResults() > 0 && (maxResults == 0 || params->getMaxResults() < maxResults))
+			maxResults = params->getMaxResults();
+	}
+	if (maxResults == 0)
+		return false;
+	int ldapResults = 0;
+	for (const auto &result : results)
+		if (result->getSourceFlags() & int(linphone::MagicSearchSource::LdapServers))
+			++ldapResults;
+	return ldapResults >= maxResults;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SearchResultCache::matches (const std::shared_ptr<linphone::SearchResult> &result, const QString &filter) {
+	if (filter.isEmpty())
+		return true;
+	auto address = result->getAddress();
+	if (address && Utils::coreStringToAppString(address->asString()).toLower().contains(filter))
+		return true;
+	if (Utils::coreStringToAppString(result->getPhoneNumber()).toLower().contains(filter))
+		return true;
+	auto linphoneFriend = result->getFriend();
+	if (linphoneFriend) {
+		if (Utils::coreStringToAppString(linphoneFriend->getName()).toLower().contains(filter))
+			return true;
+		for (const auto &friendAddress : linphoneFriend->getAddresses())
+			if (Utils::coreStringToAppString(friendAddress->asString()).toLower().contains(filter))
+				return true;
+		for (const auto &phoneNumber : linphoneFriend->getPhoneNumbers())
+			if (Utils::coreStringToAppString(phoneNumber).toLower().contains(filter))
+				return true;
+	}
+	return false;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCH_RESULT_CACHE_H_
+#define SEARCH_RESULT_CACHE_H_
+
+#include <list>
+#include <memory>
+
+#include <QList>
+#include <QString>
+
+// =============================================================================
+
+namespace linphone {
+	class MagicSearch;
+	class SearchResult;
+}
+
+// Short-lived cache of magic search results (local friends + LDAP servers), shared by all search models.
+// Entries are keyed by the normalized filter and the current LDAP configuration. A query that narrows a
+// cached one (same prefix) is answered locally as long as the cached result may not have been truncated
+// by the magic search limit or the LDAP servers' max results.
+class SearchResultCache {
+public:
+	using Results = QList<std::shared_ptr<linphone::SearchResult>>;
+	
+	static bool find (const QString &filter, Results &results);
+	static void insert (const QString &filter, const Results &results, bool truncated);
+	
+	// To be called on the raw results of the search, before any filtering.
+	static bool isTruncated (
+		const std::shared_ptr<const linphone::MagicSearch> &magicSearch,
+		const std::list<std::shared_ptr<linphone::SearchResult>> &results
+	);
+	
+	static void clear ();
+	
+private:
+	SearchResultCache () = delete;
+	
+	static bool matches (const std::shared_ptr<linphone::SearchResult> &result, const QString &filter);
+};
+
+#endif // SEARCH_RESULT_CACHE_H_
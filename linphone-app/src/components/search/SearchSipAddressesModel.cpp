@@ -44,6 +44,10 @@
 
 using namespace std;
 
+namespace {
+	constexpr int PageSize = 50;
+}
+
 // -----------------------------------------------------------------------------
 
 SearchSipAddressesModel::SearchSipAddressesModel (QObject *parent) : ProxyListModel(parent) {
@@ -62,22 +66,58 @@ SearchSipAddressesModel::~SearchSipAddressesModel(){
 // -----------------------------------------------------------------------------
 
 void SearchSipAddressesModel::setFilter(const QString& filter){
-	mMagicSearch->getContactsListAsync(filter.toStdString(),"", (int)linphone::MagicSearchSource::All, linphone::MagicSearchAggregation::None);
-	//searchReceived(mMagicSearch->getContactListFromFilter(Utils::appStringToCoreString(filter),""));	// Just to show how to use sync method
+	mFilter = filter;
+	SearchResultCache::Results results;
+	if (SearchResultCache::find(filter, results))
+		setResults(results);
+	else if (!mSearching)
+		search(filter);
 }
 
-void SearchSipAddressesModel::searchReceived(std::list<std::shared_ptr<linphone::SearchResult>> results){
+bool SearchSipAddressesModel::canFetchMore (const QModelIndex &parent) const {
+	return !parent.isValid() && !mPendingResults.isEmpty();
+}
+
+void SearchSipAddressesModel::fetchMore (const QModelIndex &parent) {
+	if (parent.isValid() || mPendingResults.isEmpty())
+		return;
 	QList<QSharedPointer<QObject> > addresses;
-	for(auto it = results.begin() ; it != results.end() ; ++it){
-		auto linphoneFriend = (*it)->getFriend();
-		auto address = (*it)->getAddress();
-		if( linphoneFriend || address)
-			addresses << QSharedPointer<SearchResultModel>::create(linphoneFriend,address );
+	while (addresses.size() < PageSize && !mPendingResults.isEmpty()) {
+		auto result = mPendingResults.takeFirst();
+		addresses << QSharedPointer<SearchResultModel>::create(result->getFriend(), result->getAddress());
 	}
+	beginInsertRows(QModelIndex(), mList.size(), mList.size() + addresses.size() - 1);
+	mList << addresses;
+	endInsertRows();
+}
+
+void SearchSipAddressesModel::search (const QString &filter) {
+	mSearching = true;
+	mSearchingFilter = filter;
+	mMagicSearch->getContactsListAsync(filter.toStdString(),"", (int)linphone::MagicSearchSource::All, linphone::MagicSearchAggregation::None);
+	//searchReceived(mMagicSearch->getContactListFromFilter(Utils::appStringToCoreString(filter),""));	// Just to show how to use sync method
+}
+
+void SearchSipAddressesModel::setResults (const SearchResultCache::Results &results) {
 	beginResetModel();
 	mList.clear();
-	mList = addresses;
-	if(mList.size() > 0 )// remove self
-		mList.pop_back();
+	mPendingResults = results;
 	endResetModel();
+	fetchMore(QModelIndex());
+}
+
+void SearchSipAddressesModel::searchReceived(std::list<std::shared_ptr<linphone::SearchResult>> results){
+	SearchResultCache::Results addresses;
+	for(auto it = results.begin() ; it != results.end() ; ++it){
+		if( (*it)->getFriend() || (*it)->getAddress())
+			addresses << *it;
+	}
+	if(addresses.size() > 0 )// remove self
+		addresses.pop_back();
+	mSearching = false;
+	SearchResultCache::insert(mSearchingFilter, addresses, SearchResultCache::isTruncated(mMagicSearch, results));
+	if (mSearchingFilter == mFilter)
+		setResults(addresses);
+	else// The filter changed during the search.
+		setFilter(mFilter);
 }
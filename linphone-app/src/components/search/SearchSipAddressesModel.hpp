@@ -27,6 +27,7 @@
 #include <linphone++/linphone.hh>
 
 #include "SearchListener.hpp"
+#include "SearchResultCache.hpp"
 #include "app/proxyModel/ProxyListModel.hpp"
 
 // =============================================================================
@@ -42,6 +43,9 @@ public:
 	
 	Q_INVOKABLE void setFilter (const QString &pattern);
 	
+	bool canFetchMore (const QModelIndex &parent) const override;
+	void fetchMore (const QModelIndex &parent) override;
+	
 	// And instance of Magic search
 	std::shared_ptr<linphone::MagicSearch> mMagicSearch;
 	// Callback when searching
@@ -49,6 +53,17 @@ public:
 	
 public slots:
 	void searchReceived(std::list<std::shared_ptr<linphone::SearchResult>> results);
+	
+private:
+	void search (const QString &filter);
+	void setResults (const SearchResultCache::Results &results);
+	
+	QString mFilter;
+	// Only one magic search at a time: the last filter is searched when the running one ends.
+	QString mSearchingFilter;
+	bool mSearching = false;
+	// Results not yet exposed to the view.
+	SearchResultCache::Results mPendingResults;
 };
 
 Q_DECLARE_METATYPE(SearchSipAddressesModel *);
@@ -33,6 +33,7 @@
 #include "app/paths/Paths.hpp"
 
 #include "components/core/CoreManager.hpp"
+#include "components/level-meter/AudioLevelMeter.hpp"
 #include "components/tunnel/TunnelModel.hpp"
 #include "include/LinphoneApp/PluginNetworkHelper.hpp"
 #include "utils/Utils.hpp"
@@ -52,6 +53,7 @@ const string SettingsModel::ContactsSection("contacts_import");
 SettingsModel::SettingsModel (QObject *parent) : QObject(parent) {
 	CoreManager *coreManager = CoreManager::getInstance();
 	mConfig = coreManager->getCore()->getConfig();
+	mMicLevelMeter = new AudioLevelMeter(this);
 
 	QObject::connect(coreManager->getHandlers().get(), &CoreHandlers::callCreated,
 			 this, &SettingsModel::handleCallCreated);
@@ -76,6 +78,7 @@ SettingsModel::SettingsModel (QObject *parent) : QObject(parent) {
 SettingsModel::~SettingsModel()
 {
 	if(mSimpleCaptureGraph ) {
+		mMicLevelMeter->setSource(nullptr);
 		delete mSimpleCaptureGraph;
 		mSimpleCaptureGraph = nullptr;
 	}
@@ -267,6 +270,10 @@ void SettingsModel::createCaptureGraph() {
 	mSimpleCaptureGraph =
 			new MediastreamerUtils::SimpleCaptureGraph(Utils::appStringToCoreString(getCaptureDevice()), Utils::appStringToCoreString(getPlaybackDevice()));
 	mSimpleCaptureGraph->start();
+	MediastreamerUtils::SimpleCaptureGraph *graph = mSimpleCaptureGraph;
+	mMicLevelMeter->setSource([graph](float &level, float &peak) {
+		return graph->getCaptureLevels(level, peak);
+	});
 	emit captureGraphRunningChanged(getCaptureGraphRunning());
 }
 void SettingsModel::startCaptureGraph(){
@@ -282,6 +289,8 @@ void SettingsModel::stopCaptureGraph(){
 }
 void SettingsModel::deleteCaptureGraph(){
 	if (mSimpleCaptureGraph) {
+		// The meter must not use the graph anymore.
+		mMicLevelMeter->setSource(nullptr);
 		if (mSimpleCaptureGraph->isRunning()) {
 			mSimpleCaptureGraph->stop();
 		}
@@ -314,13 +323,8 @@ bool SettingsModel::getCaptureGraphRunning() {
 	return mSimpleCaptureGraph && mSimpleCaptureGraph->isRunning() && !getIsInCall();
 }
 
-float SettingsModel::getMicVolume() {
-	float v = 0.0;
-
-	if (mSimpleCaptureGraph && mSimpleCaptureGraph->isRunning()) {
-		v = mSimpleCaptureGraph->getCaptureVolume();
-	}
-	return v;
+AudioLevelMeter *SettingsModel::getMicLevelMeter () const {
+	return mMicLevelMeter;
 }
 
 float SettingsModel::getPlaybackGain() const {
@@ -790,6 +794,69 @@ void SettingsModel::setAutoDownloadMaxSize(int maxSize){
 		emit autoDownloadMaxSizeChanged(maxSize);
 	}
 }
+
+int SettingsModel::getMaxConcurrentTransfers () const {
+	return qMax(1, mConfig->getInt(UiSection, "max_concurrent_transfers", 3));
+}
+
+void SettingsModel::setMaxConcurrentTransfers (int count) {
+	mConfig->setInt(UiSection, "max_concurrent_transfers", count);
+	emit maxConcurrentTransfersChanged(count);
+}
+
+int SettingsModel::getUploadTransferBandwidth () const {
+	return mConfig->getInt(UiSection, "upload_transfer_bandwidth", 0);
+}
+
+void SettingsModel::setUploadTransferBandwidth (int bandwidth) {
+	mConfig->setInt(UiSection, "upload_transfer_bandwidth", bandwidth);
+	emit uploadTransferBandwidthChanged(bandwidth);
+}
+
+int SettingsModel::getDownloadTransferBandwidth () const {
+	return mConfig->getInt(UiSection, "download_transfer_bandwidth", 0);
+}
+
+void SettingsModel::setDownloadTransferBandwidth (int bandwidth) {
+	mConfig->setInt(UiSection, "download_transfer_bandwidth", bandwidth);
+	emit downloadTransferBandwidthChanged(bandwidth);
+}
+
+bool SettingsModel::getPauseTransfersDuringCalls () const {
+	return !!mConfig->getInt(UiSection, "pause_transfers_during_calls", 1);
+}
+
+void SettingsModel::setPauseTransfersDuringCalls (bool status) {
+	mConfig->setInt(UiSection, "pause_transfers_during_calls", status);
+	emit pauseTransfersDuringCallsChanged(status);
+}
+
+bool SettingsModel::getImageCompressionEnabled () const {
+	return !!mConfig->getInt(UiSection, "image_compression_enabled", 1);
+}
+
+void SettingsModel::setImageCompressionEnabled (bool status) {
+	mConfig->setInt(UiSection, "image_compression_enabled", status);
+	emit imageCompressionEnabledChanged(status);
+}
+
+int SettingsModel::getImageCompressionMaxDimension () const {
+	return qMax(1, mConfig->getInt(UiSection, "image_compression_max_dimension", 2048));
+}
+
+void SettingsModel::setImageCompressionMaxDimension (int dimension) {
+	mConfig->setInt(UiSection, "image_compression_max_dimension", dimension);
+	emit imageCompressionMaxDimensionChanged(dimension);
+}
+
+int SettingsModel::getImageCompressionQuality () const {
+	return qBound(0, mConfig->getInt(UiSection, "image_compression_quality", 85), 100);
+}
+
+void SettingsModel::setImageCompressionQuality (int quality) {
+	mConfig->setInt(UiSection, "image_compression_quality", quality);
+	emit imageCompressionQualityChanged(quality);
+}
 	
 // -----------------------------------------------------------------------------
 
@@ -1405,6 +1472,16 @@ void SettingsModel::configureRlsUri (const std::string& domain) {
 void SettingsModel::configureRlsUri (const shared_ptr<const linphone::Account> &account) {
 	configureRlsUri(account->getParams()->getDomain());
 }
+
+// Used without resource list server: the other contacts are polled by batches.
+int SettingsModel::getMaxPresenceSubscriptions () const {
+	return mConfig->getInt(UiSection, "max_presence_subscriptions", 100);
+}
+
+void SettingsModel::setMaxPresenceSubscriptions (int count) {
+	mConfig->setInt(UiSection, "max_presence_subscriptions", count);
+	emit maxPresenceSubscriptionsChanged(count);
+}
 //------------------------------------------------------------------------------
 
 bool SettingsModel::tunnelAvailable() const{
@@ -1613,6 +1690,15 @@ void SettingsModel::setUseMinimalTimelineFilter(const bool& useMinimal) {
 	emit useMinimalTimelineFilterChanged();
 }
 
+bool SettingsModel::isStartupSnapshotEnabled() const{
+	return !!mConfig->getInt(UiSection, "startup_snapshot_enabled", 1);
+}
+
+void SettingsModel::setStartupSnapshotEnabled(const bool& enabled) {
+	mConfig->setInt(UiSection, "startup_snapshot_enabled", enabled);
+	emit startupSnapshotEnabledChanged();
+}
+
 // =============================================================================
 // Advanced.
 // =============================================================================
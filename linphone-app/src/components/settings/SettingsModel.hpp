@@ -32,6 +32,7 @@
 #include "utils/LinphoneEnums.hpp"
 
 // =============================================================================
+class AudioLevelMeter;
 class TunnelModel;
 
 class SettingsModel : public QObject {
@@ -62,6 +63,7 @@ class SettingsModel : public QObject {
 	// Audio. --------------------------------------------------------------------
 	
 	Q_PROPERTY(bool captureGraphRunning READ getCaptureGraphRunning NOTIFY captureGraphRunningChanged)
+	Q_PROPERTY(AudioLevelMeter *micLevelMeter READ getMicLevelMeter CONSTANT)// Level of the capture graph.
 	
 	Q_PROPERTY(QStringList captureDevices READ getCaptureDevices NOTIFY captureDevicesChanged)
 	Q_PROPERTY(QStringList playbackDevices READ getPlaybackDevices NOTIFY playbackDevicesChanged)
@@ -117,6 +119,13 @@ class SettingsModel : public QObject {
 	Q_PROPERTY(bool callRecorderEnabled READ getCallRecorderEnabled WRITE setCallRecorderEnabled NOTIFY callRecorderEnabledChanged)
 	Q_PROPERTY(bool automaticallyRecordCalls READ getAutomaticallyRecordCalls WRITE setAutomaticallyRecordCalls NOTIFY automaticallyRecordCallsChanged)
 	Q_PROPERTY(int autoDownloadMaxSize READ getAutoDownloadMaxSize WRITE setAutoDownloadMaxSize NOTIFY autoDownloadMaxSizeChanged)
+	Q_PROPERTY(int maxConcurrentTransfers READ getMaxConcurrentTransfers WRITE setMaxConcurrentTransfers NOTIFY maxConcurrentTransfersChanged)
+	Q_PROPERTY(int uploadTransferBandwidth READ getUploadTransferBandwidth WRITE setUploadTransferBandwidth NOTIFY uploadTransferBandwidthChanged)
+	Q_PROPERTY(int downloadTransferBandwidth READ getDownloadTransferBandwidth WRITE setDownloadTransferBandwidth NOTIFY downloadTransferBandwidthChanged)
+	Q_PROPERTY(bool pauseTransfersDuringCalls READ getPauseTransfersDuringCalls WRITE setPauseTransfersDuringCalls NOTIFY pauseTransfersDuringCallsChanged)
+	Q_PROPERTY(bool imageCompressionEnabled READ getImageCompressionEnabled WRITE setImageCompressionEnabled NOTIFY imageCompressionEnabledChanged)
+	Q_PROPERTY(int imageCompressionMaxDimension READ getImageCompressionMaxDimension WRITE setImageCompressionMaxDimension NOTIFY imageCompressionMaxDimensionChanged)
+	Q_PROPERTY(int imageCompressionQuality READ getImageCompressionQuality WRITE setImageCompressionQuality NOTIFY imageCompressionQualityChanged)
 	
 	Q_PROPERTY(bool callPauseEnabled READ getCallPauseEnabled WRITE setCallPauseEnabled NOTIFY callPauseEnabledChanged)
 	Q_PROPERTY(bool muteMicrophoneEnabled READ getMuteMicrophoneEnabled WRITE setMuteMicrophoneEnabled NOTIFY muteMicrophoneEnabledChanged)
@@ -188,6 +197,7 @@ class SettingsModel : public QObject {
 	Q_PROPERTY(int dscpVideo READ getDscpVideo WRITE setDscpVideo NOTIFY dscpVideoChanged)
 	
 	Q_PROPERTY(bool rlsUriEnabled READ getRlsUriEnabled WRITE setRlsUriEnabled NOTIFY rlsUriEnabledChanged)
+	Q_PROPERTY(int maxPresenceSubscriptions READ getMaxPresenceSubscriptions WRITE setMaxPresenceSubscriptions NOTIFY maxPresenceSubscriptionsChanged)
 	
 	// UI. -----------------------------------------------------------------------
 	
@@ -212,6 +222,7 @@ class SettingsModel : public QObject {
 	
 	Q_PROPERTY(bool mipmapEnabled READ isMipmapEnabled WRITE setMipmapEnabled NOTIFY mipmapEnabledChanged)
 	Q_PROPERTY(bool useMinimalTimelineFilter READ useMinimalTimelineFilter WRITE setUseMinimalTimelineFilter NOTIFY useMinimalTimelineFilterChanged)
+	Q_PROPERTY(bool startupSnapshotEnabled READ isStartupSnapshotEnabled WRITE setStartupSnapshotEnabled NOTIFY startupSnapshotEnabledChanged)
 	
 	// Advanced. -----------------------------------------------------------------
 	
@@ -309,7 +320,7 @@ public:
 	void accessAudioSettings();
 	void closeAudioSettings();
 	
-	Q_INVOKABLE float getMicVolume();
+	AudioLevelMeter *getMicLevelMeter () const;
 	
 	float getPlaybackGain() const;
 	void setPlaybackGain(float gain);
@@ -414,6 +425,27 @@ public:
 	int getAutoDownloadMaxSize() const;
 	void setAutoDownloadMaxSize(int maxSize);
 	
+	int getMaxConcurrentTransfers () const;
+	void setMaxConcurrentTransfers (int count);
+	
+	int getUploadTransferBandwidth () const;// In kbit/s. 0 if unlimited.
+	void setUploadTransferBandwidth (int bandwidth);
+	
+	int getDownloadTransferBandwidth () const;// In kbit/s. 0 if unlimited.
+	void setDownloadTransferBandwidth (int bandwidth);
+	
+	bool getPauseTransfersDuringCalls () const;
+	void setPauseTransfersDuringCalls (bool status);
+	
+	bool getImageCompressionEnabled () const;
+	void setImageCompressionEnabled (bool status);
+	
+	int getImageCompressionMaxDimension () const;// In pixels.
+	void setImageCompressionMaxDimension (int dimension);
+	
+	int getImageCompressionQuality () const;// JPEG quality, from 0 to 100.
+	void setImageCompressionQuality (int quality);
+	
 	bool getCallPauseEnabled () const;
 	void setCallPauseEnabled (bool status);
 	
@@ -538,6 +570,9 @@ public:
 	void configureRlsUri (const std::string& domain);
 	void configureRlsUri (const std::shared_ptr<const linphone::Account> &account);
 	
+	int getMaxPresenceSubscriptions () const;
+	void setMaxPresenceSubscriptions (int count);
+	
 	Q_INVOKABLE bool tunnelAvailable() const;
 	Q_INVOKABLE TunnelModel * getTunnel() const;
 	
@@ -590,6 +625,9 @@ public:
 	bool useMinimalTimelineFilter() const;
 	void setUseMinimalTimelineFilter(const bool& useMinimal);
 	
+	bool isStartupSnapshotEnabled() const;
+	void setStartupSnapshotEnabled(const bool& enabled);
+	
 	// Advanced. ---------------------------------------------------------------------------
 	
 	
@@ -711,6 +749,13 @@ signals:
 	void callRecorderEnabledChanged (bool status);
 	void automaticallyRecordCallsChanged (bool status);
 	void autoDownloadMaxSizeChanged (int maxSize);
+	void maxConcurrentTransfersChanged (int count);
+	void uploadTransferBandwidthChanged (int bandwidth);
+	void downloadTransferBandwidthChanged (int bandwidth);
+	void pauseTransfersDuringCallsChanged (bool status);
+	void imageCompressionEnabledChanged (bool status);
+	void imageCompressionMaxDimensionChanged (int dimension);
+	void imageCompressionQualityChanged (int quality);
 	
 	void callPauseEnabledChanged (bool status);
 	void muteMicrophoneEnabledChanged (bool status);
@@ -768,6 +813,7 @@ signals:
 	void dscpVideoChanged (int dscp);
 	
 	void rlsUriEnabledChanged (bool status);
+	void maxPresenceSubscriptionsChanged (int count);
 		
 	// UI. -----------------------------------------------------------------------
 	
@@ -785,6 +831,7 @@ signals:
 	void exitOnCloseChanged (bool value);
 	void mipmapEnabledChanged();
 	void useMinimalTimelineFilterChanged();
+	void startupSnapshotEnabledChanged();
 	
 	void checkForUpdateEnabledChanged();
 	void versionCheckUrlChanged();
@@ -807,6 +854,7 @@ private:
 	int mCurrentSettingsTab = 0;
 	MediastreamerUtils::SimpleCaptureGraph *mSimpleCaptureGraph = nullptr;
 	int mCaptureGraphListenerCount = 0;
+	AudioLevelMeter *mMicLevelMeter = nullptr;
 	
 	std::shared_ptr<linphone::Config> mConfig;
 };
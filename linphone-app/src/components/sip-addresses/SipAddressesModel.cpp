@@ -18,11 +18,17 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
 #include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
 #include <QUrl>
 #include <QtDebug>
 
+#include "app/paths/Paths.hpp"
+
 #include "components/call/CallModel.hpp"
 #include "components/chat-room/ChatRoomModel.hpp"
 #include "components/contact/ContactModel.hpp"
@@ -32,6 +38,7 @@
 #include "components/core/CoreManager.hpp"
 #include "components/history/HistoryModel.hpp"
 #include "components/settings/AccountSettingsModel.hpp"
+#include "components/settings/SettingsModel.hpp"
 #include "utils/Utils.hpp"
 
 #include "SipAddressesModel.hpp"
@@ -40,6 +47,27 @@
 
 using namespace std;
 
+namespace {
+  constexpr quint32 SnapshotMagic = 0x4c534153; // "LSAS"
+  constexpr quint16 SnapshotVersion = 2;
+}
+
+// A snapshot is only valid for the profile that wrote it: same database and same accounts.
+static QByteArray getSnapshotProfileKey () {
+	shared_ptr<linphone::Core> core = CoreManager::getInstance()->getCore();
+	QStringList identities;
+	for (const auto &account : core->getAccountList()) {
+		auto identity = account->getParams()->getIdentityAddress();
+		if (identity)
+			identities << Utils::coreStringToAppString(identity->asStringUriOnly());
+	}
+	identities.sort();
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(core->getConfig()->getString("storage", "uri", "").c_str());
+	hash.addData(identities.join('\n').toUtf8());
+	return hash.result();
+}
+
 // -----------------------------------------------------------------------------
 
 static inline QVariantMap buildVariantMap (const SipAddressesModel::SipAddressEntry &sipAddressEntry) {
@@ -52,10 +80,15 @@ static inline QVariantMap buildVariantMap (const SipAddressesModel::SipAddressEn
 }
 
 SipAddressesModel::SipAddressesModel (QObject *parent) : QAbstractListModel(parent) {
-	initSipAddresses();
-	
 	CoreManager *coreManager = CoreManager::getInstance();
 	
+	if (coreManager->getSettingsModel()->isStartupSnapshotEnabled() && loadSnapshot()) {
+		initSipAddressesFromContacts();
+		initRefs();
+		mSnapshotPending = true;// Wait for `reconcileWithCore()`.
+	} else
+		initSipAddresses();
+	
 	mCoreHandlers = coreManager->getHandlers();
 	
 	QObject::connect(coreManager, &CoreManager::chatRoomModelCreated, this, &SipAddressesModel::handleChatRoomModelCreated);
@@ -76,10 +109,12 @@ SipAddressesModel::SipAddressesModel (QObject *parent) : QAbstractListModel(pare
 
 // -----------------------------------------------------------------------------
 void SipAddressesModel::reset(){
+	mSnapshotPending = false;
+	beginResetModel();
 	mPeerAddressToSipAddressEntry.clear();
 	mRefs.clear();
-	resetInternalData();
 	initSipAddresses();
+	endResetModel();
 	emit sipAddressReset();
 }
 int SipAddressesModel::rowCount (const QModelIndex &) const {
@@ -588,13 +623,149 @@ void SipAddressesModel::initSipAddresses () {
 	qInfo() << "Sip addresses model from Chats :" << stepsTimer.restart() << "ms.";
 	initSipAddressesFromCalls();
 	qInfo() << "Sip addresses model from Calls :" << stepsTimer.restart() << "ms.";
-	initRefs();
-	qInfo() << "Sip addresses model from Refs :" << stepsTimer.restart() << "ms.";
 	initSipAddressesFromContacts();
 	qInfo() << "Sip addresses model from Contacts :" << stepsTimer.restart() << "ms.";
+	initRefs();
+	qInfo() << "Sip addresses model from Refs :" << stepsTimer.restart() << "ms.";
 	qInfo() << "Sip addresses model initialized in:" << timer.elapsed() << "ms.";
 }
 
+// -----------------------------------------------------------------------------
+// Snapshot.
+// -----------------------------------------------------------------------------
+
+// Format: magic, version, profile key, then for each peer address: the address and its conference entries.
+// Contacts and presences are not stored: they are mapped from `ContactsListModel` and the core.
+void SipAddressesModel::saveSnapshot () const {
+	QElapsedTimer timer;
+	timer.start();
+	
+	const QString filePath = Utils::coreStringToAppString(Paths::getSipAddressesSnapshotFilePath());
+	if (mSnapshotPending) {// Nothing new was loaded from the core. Keep the last snapshot.
+		qInfo() << QStringLiteral("Sip addresses snapshot is not reconciled, skip saving.");
+		return;
+	}
+	
+	QSaveFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly)) {
+		qWarning() << QStringLiteral("Unable to write sip addresses snapshot: `%1`.").arg(filePath);
+		return;
+	}
+	
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_9);
+	stream << SnapshotMagic << SnapshotVersion << getSnapshotProfileKey() << qint32(mPeerAddressToSipAddressEntry.count());
+	for (const auto &sipAddressEntry : mPeerAddressToSipAddressEntry) {
+		stream << sipAddressEntry.sipAddress << qint32(sipAddressEntry.localAddressToConferenceEntry.count());
+		for (auto it = sipAddressEntry.localAddressToConferenceEntry.cbegin(); it != sipAddressEntry.localAddressToConferenceEntry.cend(); ++it)
+			stream << it.key() << qint32(it->unreadMessageCount) << qint32(it->missedCallCount) << it->timestamp.toMSecsSinceEpoch();
+	}
+	
+	if (stream.status() != QDataStream::Ok || !file.commit())
+		qWarning() << QStringLiteral("Unable to commit sip addresses snapshot: `%1`.").arg(filePath);
+	else
+		qInfo() << "Sip addresses snapshot saved in:" << timer.elapsed() << "ms.";
+}
+
+bool SipAddressesModel::loadSnapshot () {
+	QElapsedTimer timer;
+	timer.start();
+	
+	QFile file(Utils::coreStringToAppString(Paths::getSipAddressesSnapshotFilePath()));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_9);
+	quint32 magic;
+	quint16 version;
+	QByteArray profileKey;
+	qint32 peerCount;
+	stream >> magic >> version;
+	if (stream.status() != QDataStream::Ok || magic != SnapshotMagic || version != SnapshotVersion) {
+		qWarning() << QStringLiteral("Ignore incompatible sip addresses snapshot: `%1`.").arg(file.fileName());
+		return false;
+	}
+	stream >> profileKey >> peerCount;
+	if (stream.status() != QDataStream::Ok || peerCount < 0) {
+		qWarning() << QStringLiteral("Corrupted sip addresses snapshot: `%1`.").arg(file.fileName());
+		return false;
+	}
+	if (profileKey != getSnapshotProfileKey()) {
+		qInfo() << QStringLiteral("Ignore sip addresses snapshot of another profile: `%1`.").arg(file.fileName());
+		return false;
+	}
+	
+	for (qint32 i = 0; i < peerCount && stream.status() == QDataStream::Ok; ++i) {
+		QString peerAddress;
+		qint32 localCount;
+		stream >> peerAddress >> localCount;
+		auto &localToConferenceEntry = getSipAddressEntry(peerAddress)->localAddressToConferenceEntry;
+		for (qint32 j = 0; j < localCount && stream.status() == QDataStream::Ok; ++j) {
+			QString localAddress;
+			qint32 unreadMessageCount, missedCallCount;
+			qint64 timestamp;
+			stream >> localAddress >> unreadMessageCount >> missedCallCount >> timestamp;
+			localToConferenceEntry[localAddress] = { unreadMessageCount, missedCallCount, false, QDateTime::fromMSecsSinceEpoch(timestamp) };
+		}
+	}
+	
+	if (stream.status() != QDataStream::Ok) {
+		qWarning() << QStringLiteral("Corrupted sip addresses snapshot: `%1`.").arg(file.fileName());
+		mPeerAddressToSipAddressEntry.clear();
+		return false;
+	}
+	
+	qInfo() << "Sip addresses model from snapshot (" << mPeerAddressToSipAddressEntry.count() << "entries) :" << timer.elapsed() << "ms.";
+	return true;
+}
+
+// Replace snapshot values by the core ones. Presences received in the meantime are kept.
+void SipAddressesModel::reconcileWithCore () {
+	if (!mSnapshotPending)
+		return;
+	mSnapshotPending = false;
+	
+	QElapsedTimer timer;
+	timer.start();
+	
+	QHash<QString, Presence::PresenceStatus> presences;
+	for (const auto &sipAddressEntry : mPeerAddressToSipAddressEntry)
+		if (sipAddressEntry.presenceStatus != Presence::Offline)
+			presences[sipAddressEntry.sipAddress] = sipAddressEntry.presenceStatus;
+	
+	beginResetModel();
+	mPeerAddressToSipAddressEntry.clear();
+	mRefs.clear();
+	initSipAddresses();
+	for (auto it = presences.cbegin(); it != presences.cend(); ++it) {
+		auto entry = mPeerAddressToSipAddressEntry.find(it.key());
+		if (entry != mPeerAddressToSipAddressEntry.end())
+			entry->presenceStatus = it.value();
+	}
+	endResetModel();
+	
+	for (auto it = mObservers.begin(); it != mObservers.end(); ++it) {
+		SipAddressObserver *observer = it.value();
+		auto entry = mPeerAddressToSipAddressEntry.find(it.key());
+		if (entry == mPeerAddressToSipAddressEntry.end()) {
+			observer->setContact(nullptr);
+			observer->setUnreadMessageCount(0);
+			continue;
+		}
+		observer->setContact(entry->contact);
+		auto conferenceEntry = entry->localAddressToConferenceEntry.find(Utils::cleanSipAddress(observer->getLocalAddress()));
+		observer->setUnreadMessageCount(conferenceEntry == entry->localAddressToConferenceEntry.end()
+			? 0
+			: conferenceEntry->unreadMessageCount + conferenceEntry->missedCallCount);
+	}
+	
+	qInfo() << "Sip addresses snapshot reconciled in:" << timer.elapsed() << "ms.";
+	emit sipAddressReset();
+}
+
+// -----------------------------------------------------------------------------
+
 void SipAddressesModel::initSipAddressesFromChat () {
 	for (const auto &chatRoom : CoreManager::getInstance()->getCore()->getChatRooms()) {
 		auto lastMessage = chatRoom->getLastMessageInHistory();
@@ -639,9 +810,13 @@ void SipAddressesModel::initSipAddressesFromCalls () {
 	}
 }
 
+// Only fill entries: rows are built by `initRefs()`, in a reset.
 void SipAddressesModel::initSipAddressesFromContacts () {
-	for (auto &contact : CoreManager::getInstance()->getContactsListModel()->mList)
-		handleContactAdded(contact.objectCast<ContactModel>());
+	for (auto &contact : CoreManager::getInstance()->getContactsListModel()->mList) {
+		QSharedPointer<ContactModel> contactModel = contact.objectCast<ContactModel>();
+		for (const auto &sipAddress : contactModel->getVcardModel()->getSipAddresses())
+			addOrUpdateSipAddress(*getSipAddressEntry(sipAddress.toString()), contactModel);
+	}
 }
 
 void SipAddressesModel::initRefs () {
@@ -56,6 +56,12 @@ public:
   SipAddressesModel (QObject *parent = Q_NULLPTR);
   
   void reset();
+  
+  // Startup snapshot: the model is filled from the last clean shutdown and reconciled with the core later.
+  void saveSnapshot () const;
+  bool isSnapshotPending () const {
+    return mSnapshotPending;
+  }
 
   int rowCount (const QModelIndex &index = QModelIndex()) const override;
 
@@ -90,6 +96,7 @@ signals:
  
 public slots:
   void handleAllCallCountReset ();
+  void reconcileWithCore ();
 
 private:
   bool removeRow (int row, const QModelIndex &parent = QModelIndex());
@@ -146,6 +153,8 @@ private:
 
   void initRefs ();
 
+  bool loadSnapshot ();
+
   void updateObservers (const QString &sipAddress, QSharedPointer<ContactModel> contact);
   void updateObservers (const QString &sipAddress, const Presence::PresenceStatus &presenceStatus);
   void updateObservers (const QString &peerAddress, const QString &localAddress, int messageCount, int missedCallCount);
@@ -163,6 +172,8 @@ private:
 
   QMultiHash<QString, SipAddressObserver *> mObservers;
 
+  bool mSnapshotPending = false;
+
   std::shared_ptr<CoreHandlers> mCoreHandlers;
 };
 
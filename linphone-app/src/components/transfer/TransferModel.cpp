@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QDebug>
+#include <QFileInfo>
+
+#include "components/chat-events/ChatMessageListener.hpp"
+#include "utils/Utils.hpp"
+
+#include "TransferModel.hpp"
+
+// =============================================================================
+
+TransferModel::TransferModel (std::shared_ptr<linphone::ChatMessage> message, std::shared_ptr<linphone::Content> content, Priority priority, QObject *parent) : QObject(parent) {
+	mChatMessage = message;
+	mContent = content;
+	mPriority = priority;
+}
+
+TransferModel::~TransferModel () {
+	if (mListener)
+		mChatMessage->removeListener(mListener);
+}
+
+std::shared_ptr<linphone::ChatMessage> TransferModel::getChatMessage () const {
+	return mChatMessage;
+}
+
+std::shared_ptr<linphone::Content> TransferModel::getContent () const {
+	return mContent;
+}
+
+QString TransferModel::getName () const {
+	if (mContent)
+		return Utils::coreStringToAppString(mContent->getName());
+	QStringList names;
+	for (const auto &content : mChatMessage->getContents())
+		if (content->isFile() || content->isFileTransfer())
+			names << Utils::coreStringToAppString(content->getName());
+	return names.join(", ");
+}
+
+bool TransferModel::isOutgoing () const {
+	return !mContent;
+}
+
+TransferModel::Priority TransferModel::getPriority () const {
+	return mPriority;
+}
+
+void TransferModel::setPriority (Priority priority) {
+	if (mPriority != priority) {
+		mPriority = priority;
+		emit priorityChanged();
+	}
+}
+
+bool TransferModel::isActive () const {
+	return mActive;
+}
+
+bool TransferModel::isFinished () const {
+	return mFinished;
+}
+
+quint64 TransferModel::getTransferredBytes () const {
+	return mTransferredBytes;
+}
+
+quint64 TransferModel::getTotalBytes () const {
+	if (mContent)
+		return quint64(mContent->getFileSize());
+	quint64 total = 0;
+	for (const auto &content : mChatMessage->getContents())
+		total += quint64(content->getFileSize());
+	return total;
+}
+
+quint64 TransferModel::takeTransferredDelta () {
+	const quint64 delta = mTransferredBytes - mMeasuredBytes;
+	mMeasuredBytes = mTransferredBytes;
+	return delta;
+}
+
+// -----------------------------------------------------------------------------
+
+void TransferModel::start () {
+	if (mActive || mFinished)
+		return;
+	mListener = std::make_shared<ChatMessageListener>();
+	QObject::connect(mListener.get(), &ChatMessageListener::fileTransferProgressIndication, this, &TransferModel::handleFileTransferProgressIndication);
+	QObject::connect(mListener.get(), &ChatMessageListener::msgStateChanged, this, &TransferModel::handleMsgStateChanged);
+	mChatMessage->addListener(mListener);
+	mActive = true;
+	emit activeChanged();
+	
+	if (mContent) {
+		if (!mChatMessage->downloadContent(mContent)) {
+			qWarning() << QStringLiteral("Unable to download file of entry %1.").arg(getName());
+			finish(false);
+		}
+	} else// The message has been sent: only follow the upload.
+		handleMsgStateChanged(mChatMessage, mChatMessage->getState());
+}
+
+void TransferModel::cancel () {
+	if (mActive)
+		mChatMessage->cancelFileTransfer();
+	finish(false);
+}
+
+bool TransferModel::isDownloadedContent (const std::shared_ptr<linphone::Content> &content) const {
+	if (!mContent || !content)
+		return false;
+	if (content == mContent)
+		return true;
+	const std::string filePath = mContent->getFilePath();
+	return !filePath.empty() && content->getFilePath() == filePath;
+}
+
+// The message state is shared by all its contents: check that the file of this one has been written.
+bool TransferModel::isContentDownloaded () const {
+	const QString filePath = Utils::coreStringToAppString(mContent->getFilePath());
+	return !filePath.isEmpty() && QFileInfo(filePath).size() >= qint64(mContent->getFileSize());
+}
+
+void TransferModel::finish (bool success) {
+	if (mFinished)
+		return;
+	mFinished = true;
+	if (mListener) {
+		mChatMessage->removeListener(mListener);
+		mListener = nullptr;
+	}
+	if (mActive) {
+		mActive = false;
+		emit activeChanged();
+	}
+	emit finished(success);
+}
+
+// -----------------------------------------------------------------------------
+
+void TransferModel::handleFileTransferProgressIndication (const std::shared_ptr<linphone::ChatMessage> &, const std::shared_ptr<linphone::Content> &content, size_t offset, size_t total) {
+	if (mContent && !isDownloadedContent(content))// Another content of the message.
+		return;
+	quint64 &contentOffset = mOffsets[content.get()];
+	mTransferredBytes += quint64(offset) - qMin(contentOffset, quint64(offset));
+	contentOffset = quint64(offset);
+	emit transferredBytesChanged();
+	if (mContent && total > 0 && offset >= total)
+		finish(true);
+}
+
+void TransferModel::handleMsgStateChanged (const std::shared_ptr<linphone::ChatMessage> &, linphone::ChatMessage::State state) {
+	// A download is finished by the progress of its own content: the message is done when its first content is.
+	if (mContent && state != linphone::ChatMessage::State::FileTransferError) {
+		if (state == linphone::ChatMessage::State::FileTransferDone && isContentDownloaded())
+			finish(true);
+		return;
+	}
+	switch (state) {
+		case linphone::ChatMessage::State::FileTransferDone:
+		case linphone::ChatMessage::State::Delivered:
+		case linphone::ChatMessage::State::DeliveredToUser:
+		case linphone::ChatMessage::State::Displayed:
+			finish(true);
+			break;
+		case linphone::ChatMessage::State::FileTransferError:
+		case linphone::ChatMessage::State::NotDelivered:
+			finish(false);
+			break;
+		default:
+			break;
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFER_MODEL_H_
+#define TRANSFER_MODEL_H_
+
+#include <linphone++/linphone.hh>
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+
+// =============================================================================
+
+class ChatMessageListener;
+
+// A chat attachment transfer handled by the TransferScheduler: the download of a content,
+// or the upload of the file contents of a message. Uploads are started by the SDK when the message is sent.
+class TransferModel : public QObject {
+	Q_OBJECT
+public:
+	enum Priority {
+		BackgroundPriority = 0,// Paused during calls.
+		VisiblePriority,// Shown in a chat room.
+		UserPriority// Uploads of sent messages: never queued.
+	};
+	Q_ENUM(Priority)
+	
+	Q_PROPERTY(QString name READ getName CONSTANT)
+	Q_PROPERTY(bool outgoing READ isOutgoing CONSTANT)
+	Q_PROPERTY(Priority priority READ getPriority NOTIFY priorityChanged)
+	Q_PROPERTY(bool active READ isActive NOTIFY activeChanged)
+	Q_PROPERTY(quint64 transferredBytes READ getTransferredBytes NOTIFY transferredBytesChanged)
+	Q_PROPERTY(quint64 totalBytes READ getTotalBytes CONSTANT)
+	
+	TransferModel (std::shared_ptr<linphone::ChatMessage> message, std::shared_ptr<linphone::Content> content, Priority priority, QObject *parent = nullptr);
+	virtual ~TransferModel ();
+	
+	std::shared_ptr<linphone::ChatMessage> getChatMessage () const;
+	std::shared_ptr<linphone::Content> getContent () const;// Null for uploads.
+	
+	QString getName () const;
+	bool isOutgoing () const;
+	
+	Priority getPriority () const;
+	void setPriority (Priority priority);
+	
+	bool isActive () const;
+	bool isFinished () const;
+	quint64 getTransferredBytes () const;
+	quint64 getTotalBytes () const;
+	quint64 takeTransferredDelta ();// Bytes transferred since the last call.
+	
+	void start ();
+	void cancel ();
+	
+signals:
+	void priorityChanged ();
+	void activeChanged ();
+	void transferredBytesChanged ();
+	void finished (bool success);
+	
+private:
+	void handleFileTransferProgressIndication (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content, size_t offset, size_t total);
+	void handleMsgStateChanged (const std::shared_ptr<linphone::ChatMessage> &message, linphone::ChatMessage::State state);
+	
+	bool isDownloadedContent (const std::shared_ptr<linphone::Content> &content) const;
+	bool isContentDownloaded () const;
+	void finish (bool success);
+	
+	std::shared_ptr<linphone::ChatMessage> mChatMessage;
+	std::shared_ptr<linphone::Content> mContent;
+	std::shared_ptr<ChatMessageListener> mListener;
+	
+	Priority mPriority;
+	bool mActive = false;
+	bool mFinished = false;
+	QHash<const linphone::Content *, quint64> mOffsets;
+	quint64 mTransferredBytes = 0;
+	quint64 mMeasuredBytes = 0;
+};
+
+Q_DECLARE_METATYPE(QSharedPointer<TransferModel>)
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+#include "app/paths/Paths.hpp"
+#include "components/core/CoreHandlers.hpp"
+#include "components/core/CoreManager.hpp"
+#include "components/settings/SettingsModel.hpp"
+#include "utils/Utils.hpp"
+
+#include "TransferScheduler.hpp"
+
+// =============================================================================
+
+TransferScheduler::TransferScheduler (QObject *parent) : ProxyListModel(parent) {
+	mRateTimer.setInterval(RateInterval);
+	QObject::connect(&mRateTimer, &QTimer::timeout, this, &TransferScheduler::updateRates);
+	
+	CoreManager *coreManager = CoreManager::getInstance();
+	QObject::connect(coreManager->getHandlers().get(), &CoreHandlers::callStateChanged, this, &TransferScheduler::updatePaused);
+	SettingsModel *settingsModel = coreManager->getSettingsModel();
+	QObject::connect(settingsModel, &SettingsModel::pauseTransfersDuringCallsChanged, this, &TransferScheduler::updatePaused);
+	QObject::connect(settingsModel, &SettingsModel::maxConcurrentTransfersChanged, this, &TransferScheduler::schedule);
+	QObject::connect(settingsModel, &SettingsModel::uploadTransferBandwidthChanged, this, &TransferScheduler::schedule);
+	QObject::connect(settingsModel, &SettingsModel::downloadTransferBandwidthChanged, this, &TransferScheduler::schedule);
+	updatePaused();
+	restoreQueue();
+}
+
+// -----------------------------------------------------------------------------
+
+void TransferScheduler::download (std::shared_ptr<linphone::ChatMessage> message, std::shared_ptr<linphone::Content> content, TransferModel::Priority priority) {
+	auto transfer = find(message, content);
+	if (transfer)
+		transfer->setPriority(qMax(transfer->getPriority(), priority));
+	else {
+		add(QSharedPointer<TransferModel>::create(message, content, priority));
+		saveQueue();
+	}
+	schedule();
+}
+
+void TransferScheduler::upload (std::shared_ptr<linphone::ChatMessage> message) {
+	auto transfer = QSharedPointer<TransferModel>::create(message, nullptr, TransferModel::UserPriority);
+	add(transfer);
+	transfer->start();
+	schedule();
+}
+
+bool TransferScheduler::isScheduled (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content) const {
+	return !find(message, content).isNull();
+}
+
+bool TransferScheduler::cancel (const std::shared_ptr<linphone::ChatMessage> &message) {
+	auto transfer = find(message, nullptr);
+	if (!transfer)
+		return false;
+	transfer->cancel();
+	return true;
+}
+
+void TransferScheduler::setPriority (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content, TransferModel::Priority priority) {
+	auto transfer = find(message, content);
+	if (transfer && !transfer->isActive() && transfer->getPriority() != priority) {
+		transfer->setPriority(priority);
+		schedule();
+	}
+}
+
+int TransferScheduler::getActiveCount () const {
+	return mActiveCount;
+}
+
+bool TransferScheduler::isPaused () const {
+	return mPaused;
+}
+
+// -----------------------------------------------------------------------------
+
+// A null content matches any transfer of the message. Finished transfers are ignored.
+QSharedPointer<TransferModel> TransferScheduler::find (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content) const {
+	for (const auto &item : mList) {
+		auto transfer = item.objectCast<TransferModel>();
+		if (!transfer->isFinished() && transfer->getChatMessage() == message && (!content || transfer->getContent() == content))
+			return transfer;
+	}
+	return QSharedPointer<TransferModel>();
+}
+
+void TransferScheduler::add (QSharedPointer<TransferModel> transfer) {
+	TransferModel *model = transfer.get();
+	// Queued: the transfer can be removed from the list while it emits.
+	QObject::connect(model, &TransferModel::finished, this, [this, model]() {
+		handleTransferFinished(model);
+	}, Qt::QueuedConnection);
+	QObject::connect(model, &TransferModel::activeChanged, this, [this, model]() {
+		mActiveCount += model->isActive() ? 1 : -1;
+		emit activeCountChanged(mActiveCount);
+	});
+	ProxyListModel::add(transfer);
+}
+
+void TransferScheduler::schedule () {
+	const int maxCount = CoreManager::getInstance()->getSettingsModel()->getMaxConcurrentTransfers();
+	if (mActiveCount == 0)// Nothing is measured.
+		mUploadRate = mDownloadRate = 0;
+	while (mActiveCount < maxCount) {
+		QSharedPointer<TransferModel> next;
+		for (const auto &item : mList) {
+			auto transfer = item.objectCast<TransferModel>();
+			if (transfer->isActive() || transfer->isFinished() || (next && transfer->getPriority() <= next->getPriority()))
+				continue;
+			if ((mPaused && transfer->getPriority() == TransferModel::BackgroundPriority) || isThrottled(transfer->isOutgoing()))
+				continue;
+			next = transfer;
+		}
+		if (!next)
+			break;
+		qInfo() << QStringLiteral("Start transfer of `%1` (%2, priority %3).")
+				   .arg(next->getName()).arg(next->isOutgoing() ? "upload" : "download").arg(next->getPriority());
+		next->start();
+	}
+	if (mActiveCount > 0)
+		mRateTimer.start();
+	else
+		mRateTimer.stop();
+}
+
+bool TransferScheduler::isThrottled (bool outgoing) const {
+	SettingsModel *settingsModel = CoreManager::getInstance()->getSettingsModel();
+	const quint64 bandwidth = quint64(qMax(0, outgoing ? settingsModel->getUploadTransferBandwidth() : settingsModel->getDownloadTransferBandwidth()));
+	return bandwidth > 0 && (outgoing ? mUploadRate : mDownloadRate) >= bandwidth * 1000 / 8;
+}
+
+void TransferScheduler::updatePaused () {
+	auto core = CoreManager::getInstance()->getCore();
+	const bool paused = CoreManager::getInstance()->getSettingsModel()->getPauseTransfersDuringCalls() && core->getCallsNb() > 0;
+	if (mPaused != paused) {
+		mPaused = paused;
+		qInfo() << (paused ? QStringLiteral("Pause queued transfers during calls.") : QStringLiteral("Resume queued transfers."));
+		emit pausedChanged(mPaused);
+	}
+	schedule();
+}
+
+void TransferScheduler::updateRates () {
+	quint64 uploaded = 0, downloaded = 0;
+	for (const auto &item : mList) {
+		auto transfer = item.objectCast<TransferModel>();
+		if (transfer->isActive())
+			(transfer->isOutgoing() ? uploaded : downloaded) += transfer->takeTransferredDelta();
+	}
+	mUploadRate = uploaded * 1000 / RateInterval;
+	mDownloadRate = downloaded * 1000 / RateInterval;
+	schedule();
+}
+
+void TransferScheduler::handleTransferFinished (TransferModel *transfer) {
+	const bool outgoing = transfer->isOutgoing();
+	remove(transfer);
+	if (!outgoing)
+		saveQueue();
+	schedule();
+}
+
+// -----------------------------------------------------------------------------
+
+// Format: magic, version, then for each unfinished download: chat room local and peer addresses,
+// message id, content name and priority. Running downloads are saved too: the SDK does not resume them.
+void TransferScheduler::saveQueue () const {
+	const QString filePath = Utils::coreStringToAppString(Paths::getTransfersQueueFilePath());
+	QSaveFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly)) {
+		qWarning() << QStringLiteral("Unable to write transfers queue: `%1`.").arg(filePath);
+		return;
+	}
+	
+	QList<QSharedPointer<TransferModel>> downloads;
+	for (const auto &item : mList) {
+		auto transfer = item.objectCast<TransferModel>();
+		if (!transfer->isOutgoing() && !transfer->isFinished())
+			downloads << transfer;
+	}
+	
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_9);
+	stream << QueueMagic << QueueVersion << qint32(downloads.size());
+	for (const auto &transfer : downloads) {
+		auto message = transfer->getChatMessage();
+		auto chatRoom = message->getChatRoom();
+		stream << Utils::coreStringToAppString(chatRoom->getLocalAddress()->asStringUriOnly())
+			<< Utils::coreStringToAppString(chatRoom->getPeerAddress()->asStringUriOnly())
+			<< Utils::coreStringToAppString(message->getMessageId())
+			<< Utils::coreStringToAppString(transfer->getContent()->getName())
+			<< qint32(transfer->getPriority());
+	}
+	if (stream.status() != QDataStream::Ok || !file.commit())
+		qWarning() << QStringLiteral("Unable to commit transfers queue: `%1`.").arg(filePath);
+}
+
+void TransferScheduler::restoreQueue () {
+	QFile file(Utils::coreStringToAppString(Paths::getTransfersQueueFilePath()));
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+	
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_9);
+	quint32 magic;
+	quint16 version;
+	qint32 count;
+	stream >> magic >> version >> count;
+	if (stream.status() != QDataStream::Ok || magic != QueueMagic || version != QueueVersion || count < 0) {
+		qWarning() << QStringLiteral("Ignore incompatible transfers queue: `%1`.").arg(file.fileName());
+		return;
+	}
+	
+	auto chatRooms = CoreManager::getInstance()->getCore()->getChatRooms();
+	for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+		QString localAddress, peerAddress, messageId, contentName;
+		qint32 priority;
+		stream >> localAddress >> peerAddress >> messageId >> contentName >> priority;
+		if (stream.status() != QDataStream::Ok)
+			break;
+		
+		auto chatRoom = std::find_if(chatRooms.cbegin(), chatRooms.cend(), [&](const std::shared_ptr<linphone::ChatRoom> &chatRoom) {
+			return Utils::coreStringToAppString(chatRoom->getLocalAddress()->asStringUriOnly()) == localAddress
+				&& Utils::coreStringToAppString(chatRoom->getPeerAddress()->asStringUriOnly()) == peerAddress;
+		});
+		auto message = chatRoom == chatRooms.cend() ? nullptr : (*chatRoom)->findMessage(Utils::appStringToCoreString(messageId));
+		if (!message)
+			continue;
+		for (const auto &content : message->getContents())
+			if (content->isFileTransfer() && Utils::coreStringToAppString(content->getName()) == contentName && !find(message, content)) {
+				qInfo() << QStringLiteral("Restore transfer of `%1`.").arg(contentName);
+				add(QSharedPointer<TransferModel>::create(message, content, TransferModel::Priority(qBound(0, priority, int(TransferModel::VisiblePriority)))));
+				break;
+			}
+	}
+	saveQueue();
+	schedule();
+}
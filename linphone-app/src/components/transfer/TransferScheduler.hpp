@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFER_SCHEDULER_H_
+#define TRANSFER_SCHEDULER_H_
+
+#include <linphone++/linphone.hh>
+#include <QTimer>
+
+#include "app/proxyModel/ProxyListModel.hpp"
+#include "TransferModel.hpp"
+
+// =============================================================================
+
+// Queue of chat attachment transfers. Downloads are started by priority, then in request order,
+// while they are under the concurrency limit and the bandwidth caps of their direction.
+// During calls, background downloads are paused. Pending downloads are saved and restored at next start.
+// The SDK uploads files when a message is sent and cannot throttle a running transfer: uploads are
+// only followed, they are counted in the limits and delay the downloads.
+class TransferScheduler : public ProxyListModel {
+	Q_OBJECT
+	
+	Q_PROPERTY(int activeCount READ getActiveCount NOTIFY activeCountChanged)
+	Q_PROPERTY(bool paused READ isPaused NOTIFY pausedChanged)
+	
+public:
+	TransferScheduler (QObject *parent = nullptr);
+	
+	void download (std::shared_ptr<linphone::ChatMessage> message, std::shared_ptr<linphone::Content> content, TransferModel::Priority priority);
+	void upload (std::shared_ptr<linphone::ChatMessage> message);// The message must have been sent.
+	
+	bool isScheduled (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content = nullptr) const;
+	bool cancel (const std::shared_ptr<linphone::ChatMessage> &message);// Return false if the message has no scheduled transfer.
+	void setPriority (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content, TransferModel::Priority priority);
+	
+	int getActiveCount () const;
+	bool isPaused () const;
+	
+signals:
+	void activeCountChanged (int count);
+	void pausedChanged (bool paused);
+	
+private:
+	QSharedPointer<TransferModel> find (const std::shared_ptr<linphone::ChatMessage> &message, const std::shared_ptr<linphone::Content> &content) const;
+	void add (QSharedPointer<TransferModel> transfer);
+	
+	void saveQueue () const;
+	void restoreQueue ();
+	
+	void schedule ();
+	bool isThrottled (bool outgoing) const;
+	void updatePaused ();
+	void updateRates ();
+	void handleTransferFinished (TransferModel *transfer);
+	
+	int mActiveCount = 0;
+	bool mPaused = false;
+	quint64 mUploadRate = 0;// In bytes/s.
+	quint64 mDownloadRate = 0;
+	QTimer mRateTimer;
+	
+	static constexpr int RateInterval = 1000;
+	static constexpr quint32 QueueMagic = 0x4c545153;// "LTQS"
+	static constexpr quint16 QueueVersion = 1;
+};
+
+#endif
@@ -9,6 +9,9 @@ constexpr char Constants::LanguagePath[];
 constexpr char Constants::QmlViewMainWindow[];
 constexpr char Constants::QmlViewCallsWindow[];
 constexpr char Constants::QmlViewSettingsWindow[];
+constexpr int Constants::SubWindowsPreloadDelay;
+constexpr char Constants::QmlViewConfirmDialog[];
+constexpr char Constants::QmlViewNewConferenceDialog[];
 
 #ifdef ENABLE_UPDATE_CHECK
 constexpr int Constants::VersionUpdateCheckInterval;
@@ -35,6 +38,7 @@ constexpr char Constants::PathCodecs[];
 constexpr char Constants::PathData[];
 constexpr char Constants::PathTools[];
 constexpr char Constants::PathLogs[];
+constexpr char Constants::PathOutgoingImages[];
 #ifdef APPLE
 constexpr char Constants::PathPlugins[];
 #else
@@ -43,9 +47,12 @@ constexpr char Constants::PathPlugins[];
 constexpr char Constants::PathPluginsApp[];
 constexpr char Constants::PathSounds[];
 constexpr char Constants::PathThumbnails[];
+constexpr char Constants::PathThumbnailsIndex[];
+constexpr char Constants::PathWaveforms[];
 constexpr char Constants::PathUserCertificates[];
 
 constexpr char Constants::PathCallHistoryList[];
+constexpr char Constants::PathCallQualityArchive[];
 constexpr char Constants::PathConfig[];
 constexpr char Constants::PathDatabase[];
 constexpr char Constants::PathFactoryConfig[];
@@ -53,15 +60,21 @@ constexpr char Constants::PathRootCa[];
 constexpr char Constants::PathFriendsList[];
 constexpr char Constants::PathLimeDatabase[];
 constexpr char Constants::PathMessageHistoryList[];
+constexpr char Constants::PathSipAddressesSnapshot[];
+constexpr char Constants::PathTransfersQueue[];
 constexpr char Constants::PathZrtpSecrets[];
 
 // Max image size in bytes. (100Kb)
 constexpr qint64 Constants::MaxImageSize;
 constexpr int Constants::ThumbnailImageFileWidth;
 constexpr int Constants::ThumbnailImageFileHeight;
+constexpr qint64 Constants::ThumbnailsMaxDiskSize;
+constexpr int Constants::WaveformSamplesCount;
 
 // In Bytes.
 constexpr qint64 Constants::FileSizeLimit;
+constexpr qint64 Constants::ImageCompressionMinFileSize;
+constexpr int Constants::DecodedImagesMaxMemorySize;
 
 constexpr char Constants::DefaultXmlrpcUri[];
 constexpr char Constants::DefaultConferenceURI[];
@@ -94,6 +107,9 @@ constexpr char Constants::PluginUrlH264[];
 constexpr char Constants::PluginUrlH264[];
 #endif // ifdef Q_OS_WIN64
 #endif // ifdef Q_OS_LINUX
+#if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
+constexpr int Constants::PluginDownloadSegmentCount;
+#endif // if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
 constexpr char Constants::VcardScheme[];
 
 constexpr int Constants::CbsCallInterval;
@@ -117,8 +133,6 @@ constexpr char Constants::TranslationUrl[];
 
 constexpr int Constants::MaxMosaicParticipants;
 
-constexpr char Constants::LinphoneBZip2_exe[];
-constexpr char Constants::LinphoneBZip2_dll[];
 constexpr char Constants::DefaultRlsUri[];
 constexpr char Constants::DefaultLogsEmail[];
 
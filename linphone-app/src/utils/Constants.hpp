@@ -65,8 +65,6 @@ public:
 	
 	static constexpr int MaxMosaicParticipants = 6;// From 7, the mosaic quality will be limited to avoid useless computations
 	
-	static constexpr char LinphoneBZip2_exe[] = "https://www.linphone.org/releases/windows/tools/bzip2/bzip2.exe";
-	static constexpr char LinphoneBZip2_dll[] = "https://www.linphone.org/releases/windows/tools/bzip2/bzip2.dll";
 	static constexpr char DefaultRlsUri[] = "sips:rls@sip.linphone.org";
 	static constexpr char DefaultLogsEmail[] = "linphone-desktop@belledonne-communications.com";
 	static constexpr char DefaultConferenceURI[] = "sip:conference-factory@sip.linphone.org";
@@ -90,8 +88,12 @@ public:
 	// Max image size in bytes. (100Kb)
 	static constexpr qint64 MaxImageSize = 102400;// In Bytes.
 	static constexpr qint64 FileSizeLimit = 524288000;// In Bytes.
+	static constexpr qint64 ImageCompressionMinFileSize = 1048576;// In Bytes. Smaller photos are sent as-is.
+	static constexpr int DecodedImagesMaxMemorySize = 32768;// In KB.
 	static constexpr int ThumbnailImageFileWidth = 100;
 	static constexpr int ThumbnailImageFileHeight = 100;
+	static constexpr qint64 ThumbnailsMaxDiskSize = 104857600;// In Bytes.
+	static constexpr int WaveformSamplesCount = 100;
 
 	static constexpr char PathAssistantConfig[] = "/" EXECUTABLE_NAME "/assistant/";
 	static constexpr char PathAvatars[] = "/avatars/";
@@ -100,6 +102,7 @@ public:
 	static constexpr char PathData[] =  "/" EXECUTABLE_NAME;
 	static constexpr char PathTools[] =  "/tools/";
 	static constexpr char PathLogs[] = "/logs/";
+	static constexpr char PathOutgoingImages[] = "/outgoing-images/";
 #ifdef APPLE
 	static constexpr char PathPlugins[] = "/Plugins/";
 #else
@@ -108,9 +111,12 @@ public:
 	static constexpr char PathPluginsApp[] = "app/";
 	static constexpr char PathSounds[] = "/sounds/" EXECUTABLE_NAME;
 	static constexpr char PathThumbnails[] = "/thumbnails/";
+	static constexpr char PathThumbnailsIndex[] = "index";
+	static constexpr char PathWaveforms[] = "waveforms/";// In the thumbnails directory.
 	static constexpr char PathUserCertificates[] = "/usr-crt/";
 	
 	static constexpr char PathCallHistoryList[] = "/call-history.db";
+	static constexpr char PathCallQualityArchive[] = "/call-quality.jsonl";
 	static constexpr char PathConfig[] = "/linphonerc";
 	static constexpr char PathDatabase[] = "/linphone.db";
 	static constexpr char PathFactoryConfig[] = "/" EXECUTABLE_NAME "/linphonerc-factory";
@@ -118,6 +124,8 @@ public:
 	static constexpr char PathFriendsList[] = "/friends.db";
 	static constexpr char PathLimeDatabase[] = "/x3dh.c25519.sqlite3";
 	static constexpr char PathMessageHistoryList[] = "/message-history.db";
+	static constexpr char PathSipAddressesSnapshot[] = "/sip-addresses.snapshot";
+	static constexpr char PathTransfersQueue[] = "/transfers.queue";
 	static constexpr char PathZrtpSecrets[] = "/zidcache";
 	
 	static constexpr char LanguagePath[] = ":/languages/";
@@ -126,6 +134,10 @@ public:
 	static constexpr char QmlViewMainWindow[] = "qrc:/ui/views/App/Main/MainWindow.qml";
 	static constexpr char QmlViewCallsWindow[] = "qrc:/ui/views/App/Calls/CallsWindow.qml";
 	static constexpr char QmlViewSettingsWindow[] = "qrc:/ui/views/App/Settings/SettingsWindow.qml";
+	static constexpr int SubWindowsPreloadDelay = 1000;// Delay after the first frame of the main window.
+	// Dialogs opened often: compiled in background after the startup.
+	static constexpr char QmlViewConfirmDialog[] = "qrc:/ui/modules/Common/Dialog/ConfirmDialog.qml";
+	static constexpr char QmlViewNewConferenceDialog[] = "qrc:/ui/views/App/Dialog/NewConference.qml";
 	
 	static constexpr char MainQmlUri[] = "Linphone";
 	
@@ -169,6 +181,9 @@ public:
 	static constexpr char PluginUrlH264[] = "http://ciscobinary.openh264.org/openh264-2.1.0-win32.dll.bz2";
 #endif // ifdef Q_OS_WIN64
 #endif // ifdef Q_OS_LINUX
+#if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
+	static constexpr int PluginDownloadSegmentCount = 4;// Parallel range requests of codec updates.
+#endif // if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
 
 //--------------------------------------------------------------------------------	
 };
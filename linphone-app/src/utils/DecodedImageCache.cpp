@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QImageIOHandler>
+#include <QImageReader>
+#include <QMutex>
+
+#include "Constants.hpp"
+
+#include "DecodedImageCache.hpp"
+
+// =============================================================================
+
+namespace {
+	QMutex Mutex;
+	// Cost in KB.
+	QCache<QString, QImage> Images(Constants::DecodedImagesMaxMemorySize);
+}
+
+QImage DecodedImageCache::getImage (const QString &path, const QSize &requestedSize) {
+	QFileInfo info(path);
+	if (!info.isFile())
+		return QImage();
+	const QString key = QStringLiteral("%1|%2|%3|%4x%5").arg(path).arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size())
+		.arg(requestedSize.width()).arg(requestedSize.height());
+	{
+		QMutexLocker locker(&Mutex);
+		QImage *image = Images.object(key);
+		if (image)
+			return *image;
+	}
+	
+	QImage image = decode(path, requestedSize);
+	if (!image.isNull()) {
+		QMutexLocker locker(&Mutex);
+		Images.insert(key, new QImage(image), qMax(1, image.bytesPerLine() * image.height() / 1024));
+	}
+	return image;
+}
+
+void DecodedImageCache::clear () {
+	QMutexLocker locker(&Mutex);
+	Images.clear();
+}
+
+// -----------------------------------------------------------------------------
+
+QImage DecodedImageCache::decode (const QString &path, const QSize &requestedSize) {
+	QImageReader reader(path);
+	if (!reader.canRead()) {// Try to determine format from headers instead of using suffix
+		reader.setFileName(path);
+		reader.setDecideFormatFromContent(true);
+	}
+	reader.setAutoTransform(true);
+	
+	QSize size = reader.size();
+	if (size.isValid() && (requestedSize.width() > 0 || requestedSize.height() > 0)) {
+		// The requested size applies to the transformed image.
+		QSize target = requestedSize;
+		if (reader.transformation() & QImageIOHandler::TransformationRotate90)
+			target.transpose();
+		if (target.width() <= 0)
+			target.setWidth(size.width() * target.height() / size.height());
+		else if (target.height() <= 0)
+			target.setHeight(size.height() * target.width() / size.width());
+		QSize scaledSize = size.scaled(target, Qt::KeepAspectRatioByExpanding);
+		if (scaledSize.width() < size.width() && scaledSize.height() < size.height())
+			reader.setScaledSize(scaledSize);
+	}
+	return reader.read();
+}
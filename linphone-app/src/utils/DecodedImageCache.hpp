@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DECODED_IMAGE_CACHE_H_
+#define DECODED_IMAGE_CACHE_H_
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// =============================================================================
+
+// Decode images once, at the requested size, and keep them in a shared memory cache.
+// Entries are keyed by path, modification time, file size and requested size. Thread-safe.
+class DecodedImageCache {
+public:
+	// An invalid or empty requested size decodes the image at its full size.
+	// The decoded image covers the requested size (aspect ratio kept) and is never upscaled.
+	static QImage getImage (const QString &path, const QSize &requestedSize = QSize());
+	
+	static void clear ();
+	
+private:
+	DecodedImageCache () = delete;
+	
+	static QImage decode (const QString &path, const QSize &requestedSize);
+};
+
+#endif // DECODED_IMAGE_CACHE_H_
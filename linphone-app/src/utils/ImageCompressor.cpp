@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QBuffer>
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+
+#include "Constants.hpp"
+#include "QExifImageHeader.hpp"
+
+#include "ImageCompressor.hpp"
+
+// =============================================================================
+
+bool ImageCompressor::isCompressible (const QString &filePath, int maxDimension) {
+	QImageReader reader(filePath);
+	if (reader.format() != "jpeg" || reader.imageCount() > 1)
+		return false;
+	const QSize size = reader.size();
+	return qMax(size.width(), size.height()) > maxDimension || QFileInfo(filePath).size() > Constants::ImageCompressionMinFileSize;
+}
+
+bool ImageCompressor::compress (
+	const QString &filePath,
+	const QString &destination,
+	int maxDimension,
+	int quality,
+	const std::function<void(double)> &progress
+) {
+	auto setProgress = [&progress](double value) {
+		if (progress)
+			progress(value);
+	};
+	
+	QImageReader reader(filePath);
+	reader.setAutoTransform(false);// The orientation is kept in EXIF.
+	const QSize size = reader.size();
+	if (size.isValid() && qMax(size.width(), size.height()) > maxDimension)
+		reader.setScaledSize(size.scaled(maxDimension, maxDimension, Qt::KeepAspectRatio));
+	setProgress(0.1);
+	
+	QImage image = reader.read();
+	if (image.isNull()) {
+		qWarning() << QStringLiteral("Unable to read image `%1`: %2.").arg(filePath).arg(reader.errorString());
+		return false;
+	}
+	if (qMax(image.width(), image.height()) > maxDimension)// Scaled size may be not supported by the reader.
+		image = image.scaled(maxDimension, maxDimension, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+	setProgress(0.6);
+	
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::ReadWrite);
+	QImageWriter writer(&buffer, "jpeg");
+	writer.setQuality(quality);
+	writer.setOptimizedWrite(true);
+	if (!writer.write(image)) {
+		qWarning() << QStringLiteral("Unable to encode image `%1`: %2.").arg(filePath).arg(writer.errorString());
+		return false;
+	}
+	setProgress(0.9);
+	
+	QExifImageHeader exif;
+	if (exif.loadFromJpeg(filePath)) {
+		for (QExifImageHeader::GpsTag tag : exif.gpsTags())
+			exif.remove(tag);
+		exif.setThumbnail(QImage());
+		if (exif.contains(QExifImageHeader::PixelXDimension))
+			exif.setValue(QExifImageHeader::PixelXDimension, QExifValue(quint32(image.width())));
+		if (exif.contains(QExifImageHeader::PixelYDimension))
+			exif.setValue(QExifImageHeader::PixelYDimension, QExifValue(quint32(image.height())));
+		buffer.seek(0);
+		if (!exif.saveToJpeg(&buffer))
+			qWarning() << QStringLiteral("Unable to copy EXIF data of `%1`.").arg(filePath);
+	}
+	
+	QSaveFile file(destination);
+	if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+		qWarning() << QStringLiteral("Unable to write compressed image `%1`: %2.").arg(destination).arg(file.errorString());
+		return false;
+	}
+	qInfo() << QStringLiteral("Image `%1` compressed from %2 to %3 bytes (%4x%5).")
+			   .arg(filePath).arg(QFileInfo(filePath).size()).arg(data.size()).arg(image.width()).arg(image.height());
+	setProgress(1.0);
+	return true;
+}
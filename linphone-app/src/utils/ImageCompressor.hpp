@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGE_COMPRESSOR_H_
+#define IMAGE_COMPRESSOR_H_
+
+#include <QString>
+#include <functional>
+
+// =============================================================================
+
+// Downscales and re-encodes JPEG photos before sending them.
+// Pixels are kept as stored: the EXIF orientation is copied, location tags are removed.
+class ImageCompressor {
+public:
+	// True if the file is a JPEG image bigger than maxDimension or than Constants::ImageCompressionMinFileSize.
+	static bool isCompressible (const QString &filePath, int maxDimension);
+	
+	// Blocking: to be called from a worker thread. `progress` receives values in [0, 1].
+	static bool compress (
+		const QString &filePath,
+		const QString &destination,
+		int maxDimension,
+		int quality,
+		const std::function<void(double)> &progress = nullptr
+	);
+	
+private:
+	ImageCompressor () = delete;
+};
+
+#endif // IMAGE_COMPRESSOR_H_
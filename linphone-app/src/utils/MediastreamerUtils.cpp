@@ -91,6 +91,7 @@ void SimpleCaptureGraph::init() {
 }
 
 void SimpleCaptureGraph::start() {
+	std::lock_guard<std::mutex> lock(mutex);
 	if (!running && audioCapture) {
 		running = true;
 		ms_ticker_attach(ticker, audioCapture);
@@ -99,6 +100,7 @@ void SimpleCaptureGraph::start() {
 }
 
 void SimpleCaptureGraph::stop() {
+	std::lock_guard<std::mutex> lock(mutex);
 	if (running && audioCapture){
 		ms_ticker_detach(ticker, audioCapture);
 		running = false;
@@ -109,6 +111,7 @@ void SimpleCaptureGraph::destroy() {
 	if (running) {
 		stop();
 	}
+	std::lock_guard<std::mutex> lock(mutex);
 	
 	if (audioSink)
 		ms_filter_unlink(playbackVolumeFilter, 0, audioSink, 0);
@@ -168,12 +171,14 @@ void SimpleCaptureGraph::setPlaybackGain(float gain) {
 	}
 }
 
-float SimpleCaptureGraph::getCaptureVolume() {
-	float vol = 0;
-
-	if (captureVolumeFilter) {
-		ms_filter_call_method(captureVolumeFilter, MS_VOLUME_GET, &vol);
-		vol = MediastreamerUtils::dbToLinear(vol);
-	}
-	return vol;
+bool SimpleCaptureGraph::getCaptureLevels(float &level, float &peak) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!isRunning() || !captureVolumeFilter)
+		return false;
+	float vol = 0, maxVol = 0;
+	ms_filter_call_method(captureVolumeFilter, MS_VOLUME_GET, &vol);
+	ms_filter_call_method(captureVolumeFilter, MS_VOLUME_GET_MAX, &maxVol);
+	level = MediastreamerUtils::dbToLinear(vol);
+	peak = MediastreamerUtils::dbToLinear(maxVol);
+	return true;
 }
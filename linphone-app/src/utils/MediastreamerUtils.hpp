@@ -21,7 +21,9 @@
 #ifndef MEDIASTREAMER_UTILS_H_
 #define MEDIASTREAMER_UTILS_H_
 
+#include <atomic>
 #include <cmath>
+#include <mutex>
 
 #include "mediastreamer2/mssndcard.h"
 #include "mediastreamer2/msvolume.h"
@@ -68,7 +70,8 @@ namespace MediastreamerUtils {
 		void start();
 		void stop();
 
-		float getCaptureVolume();
+		// Mean and max volumes of the capture, linear. Return false if the graph is not running.
+		bool getCaptureLevels(float &level, float &peak);
 
 		float getCaptureGain();
 		float getPlaybackGain();
@@ -82,7 +85,9 @@ namespace MediastreamerUtils {
 		void init();
 		void destroy();
 
-		bool running = false;
+		// Levels are read from a metering thread: the filters are accessed under the mutex.
+		std::atomic<bool> running{false};
+		std::mutex mutex;
 
 		std::string captureCardId;
 		std::string playbackCardId;
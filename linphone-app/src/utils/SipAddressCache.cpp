@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <linphone++/linphone.hh>
+#include <QCache>
+#include <QMutex>
+#include <QStringList>
+
+#include "components/core/CoreManager.hpp"
+#include "Utils.hpp"
+
+#include "SipAddressCache.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr int CleanedAddressesCacheSize = 4096;
+	constexpr int InterpretedUrlsCacheSize = 1024;
+	constexpr int InternedAddressesMinSweepSize = 2 * CleanedAddressesCacheSize;
+	
+	using InternedData = SipAddressHandle::Data;
+	
+	QMutex Mutex;
+	
+	// Raw address => handle. Evicted entries release their handle.
+	QCache<QString, SipAddressHandle> CleanedAddresses(CleanedAddressesCacheSize);
+	// Canonical address and port => interned data. Expired entries are swept when the table doubles.
+	QHash<QString, std::weak_ptr<const InternedData>> InternedAddresses;
+	int InternedAddressesSweepSize = InternedAddressesMinSweepSize;
+	quint32 LastId = 0;
+	
+	QCache<QString, std::shared_ptr<const linphone::Address>> InterpretedUrls(InterpretedUrlsCacheSize);
+}
+
+static QString computeCleanSipAddress (const QString &sipAddress, int &port) {
+	port = 0;
+	std::shared_ptr<linphone::Address> addr = linphone::Factory::get()->createAddress(sipAddress.toStdString());
+	if( addr) {
+		addr->clean();
+		port = addr->getPort();
+		QStringList fields = Utils::coreStringToAppString(addr->asStringUriOnly()).split('@');
+		if(fields.size() > 0){// maybe useless but it's just to be sure to have a domain
+			fields.removeLast();
+			QString domain = Utils::coreStringToAppString(addr->getDomain());
+			if( domain.count(':')>1)
+				fields.append('['+domain+']');
+			else
+				fields.append(domain);
+			return fields.join('@');
+		}
+	}
+	return sipAddress;
+}
+
+// Must be called with `Mutex` locked.
+static void sweepInternedAddresses () {
+	for (auto it = InternedAddresses.begin(); it != InternedAddresses.end(); ) {
+		if (it->expired())
+			it = InternedAddresses.erase(it);
+		else
+			++it;
+	}
+	InternedAddresses.squeeze();
+	InternedAddressesSweepSize = qMax(InternedAddressesMinSweepSize, 2 * InternedAddresses.size());
+}
+
+// Must be called with `Mutex` locked.
+static std::shared_ptr<const InternedData> intern (const QString &cleanedAddress, int port) {
+	// The cleaned address drops the port: keep it in the key to not merge distinct endpoints.
+	std::weak_ptr<const InternedData> &interned = InternedAddresses[port > 0 ? cleanedAddress + ';' + QString::number(port) : cleanedAddress];
+	std::shared_ptr<const InternedData> data = interned.lock();
+	if (data)
+		return data;
+	data = std::make_shared<const InternedData>(InternedData{ ++LastId, cleanedAddress, port });
+	interned = data;
+	if (InternedAddresses.size() >= InternedAddressesSweepSize)
+		sweepInternedAddresses();
+	return data;
+}
+
+// -----------------------------------------------------------------------------
+
+SipAddressHandle SipAddressCache::getHandle (const QString &sipAddress) {
+	if (sipAddress.isEmpty())
+		return SipAddressHandle();
+	
+	QMutexLocker locker(&Mutex);
+	SipAddressHandle *cachedHandle = CleanedAddresses.object(sipAddress);
+	if (cachedHandle)
+		return *cachedHandle;
+	
+	// Parsing is done without lock: it may be long.
+	locker.unlock();
+	int port;
+	const QString cleanedAddress = computeCleanSipAddress(sipAddress, port);
+	locker.relock();
+	
+	SipAddressHandle handle(intern(cleanedAddress, port));
+	CleanedAddresses.insert(sipAddress, new SipAddressHandle(handle));
+	// Cleaning is idempotent, unless the port was stripped.
+	if (port <= 0 && cleanedAddress != sipAddress && !CleanedAddresses.contains(cleanedAddress))
+		CleanedAddresses.insert(cleanedAddress, new SipAddressHandle(handle));
+	return handle;
+}
+
+SipAddressHandle SipAddressCache::getHandle (const std::shared_ptr<const linphone::Address> &address) {
+	return address ? getHandle(Utils::coreStringToAppString(address->asStringUriOnly())) : SipAddressHandle();
+}
+
+SipAddressHandle SipAddressCache::getCleanHandle (const QString &sipAddress) {
+	return getHandle(cleanSipAddress(sipAddress));
+}
+
+QString SipAddressCache::cleanSipAddress (const QString &sipAddress) {
+	return getHandle(sipAddress).toString();
+}
+
+bool SipAddressCache::weakEqual (const QString &a, const QString &b) {
+	return getHandle(a) == getHandle(b);
+}
+
+// -----------------------------------------------------------------------------
+
+std::shared_ptr<linphone::Address> SipAddressCache::interpretUrl (const QString &address) {
+	{
+		QMutexLocker locker(&Mutex);
+		std::shared_ptr<const linphone::Address> *cachedAddress = InterpretedUrls.object(address);
+		if (cachedAddress)
+			return *cachedAddress ? (*cachedAddress)->clone() : nullptr;
+	}
+	
+	std::shared_ptr<linphone::Address> interpretedAddress = CoreManager::getInstance()->getCore()->interpretUrl(Utils::appStringToCoreString(address));
+	
+	QMutexLocker locker(&Mutex);
+	InterpretedUrls.insert(address, new std::shared_ptr<const linphone::Address>(interpretedAddress ? interpretedAddress->clone() : nullptr));
+	return interpretedAddress;
+}
+
+void SipAddressCache::clearInterpretedUrls () {
+	QMutexLocker locker(&Mutex);
+	InterpretedUrls.clear();
+}
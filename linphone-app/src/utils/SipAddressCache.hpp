@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIP_ADDRESS_CACHE_H_
+#define SIP_ADDRESS_CACHE_H_
+
+#include <memory>
+
+#include <QHash>
+#include <QString>
+
+// =============================================================================
+
+namespace linphone {
+	class Address;
+}
+
+// Canonical (cleaned) sip address. Handles of the same address and port share the same interned data:
+// comparing them is a pointer comparison, like `linphone::Address::weakEqual`.
+// The interned address lives while a handle references it.
+class SipAddressHandle {
+public:
+	// Interned address. Only created by `SipAddressCache`.
+	struct Data {
+		quint32 id;
+		QString sipAddress;// Without port.
+		int port;
+	};
+	
+	SipAddressHandle () = default;
+	
+	bool isNull () const {
+		return !mData;
+	}
+	
+	quint32 getId () const {
+		return mData ? mData->id : 0;
+	}
+	
+	QString toString () const {
+		return mData ? mData->sipAddress : QString();
+	}
+	
+	int getPort () const {
+		return mData ? mData->port : 0;
+	}
+	
+	bool operator== (const SipAddressHandle &other) const {
+		return mData == other.mData;
+	}
+	
+	bool operator!= (const SipAddressHandle &other) const {
+		return mData != other.mData;
+	}
+	
+	bool operator< (const SipAddressHandle &other) const {
+		return getId() < other.getId();
+	}
+	
+private:
+	friend class SipAddressCache;
+	
+	SipAddressHandle (const std::shared_ptr<const Data> &data) : mData(data) {}
+	
+	std::shared_ptr<const Data> mData;
+};
+
+inline uint qHash (const SipAddressHandle &handle, uint seed = 0) {
+	return ::qHash(handle.getId(), seed);
+}
+
+// Bounded LRU caches in front of `linphone::Address` parsing.
+// Canonical addresses are interned while handles (or cache entries) reference them. Thread-safe.
+class SipAddressCache {
+public:
+	static SipAddressHandle getHandle (const QString &sipAddress);
+	static SipAddressHandle getHandle (const std::shared_ptr<const linphone::Address> &address);
+	// Handle of the cleaned address: the port is ignored.
+	static SipAddressHandle getCleanHandle (const QString &sipAddress);
+	static QString cleanSipAddress (const QString &sipAddress);// Return at most : sip:username@domain
+	static bool weakEqual (const QString &a, const QString &b);
+	
+	// The returned address is a copy and can be modified.
+	static std::shared_ptr<linphone::Address> interpretUrl (const QString &address);
+	// Interpretation depends on the default account: to be called when accounts change.
+	static void clearInterpretedUrls ();
+	
+private:
+	SipAddressCache () = delete;
+};
+
+#endif // SIP_ADDRESS_CACHE_H_
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QSaveFile>
+#include <QTransform>
+#include <QtDebug>
+
+#include "app/paths/Paths.hpp"
+#include "Constants.hpp"
+#include "DecodedImageCache.hpp"
+#include "QExifImageHeader.hpp"
+#include "Utils.hpp"
+
+#include "ThumbnailStore.hpp"
+
+// =============================================================================
+
+namespace {
+	constexpr quint32 IndexMagic = 0x4c544853;
+	constexpr quint32 IndexVersion = 1;
+	
+	struct Entry {
+		qint64 size = 0;
+		qint64 lastAccess = 0;
+	};
+	
+	QMutex Mutex;
+	bool Loaded = false;
+	bool Dirty = false;
+	
+	// Thumbnail id => entry. Persisted in the index file.
+	QHash<QString, Entry> Entries;
+	qint64 TotalSize = 0;
+	// "path|size|mtime" => hash of the file. Avoid to hash again the same file.
+	QHash<QString, QString> FileHashes;
+}
+
+static QString getDirPath () {
+	return Utils::coreStringToAppString(Paths::getThumbnailsDirPath());
+}
+
+static QString getIndexPath () {
+	return getDirPath() + Constants::PathThumbnailsIndex;
+}
+
+// Must be called with the mutex locked.
+static void loadIndex () {
+	if (Loaded)
+		return;
+	Loaded = true;
+	
+	QFile file(getIndexPath());
+	if (file.open(QIODevice::ReadOnly)) {
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_9);
+		quint32 magic, version;
+		stream >> magic >> version;
+		if (magic == IndexMagic && version == IndexVersion) {
+			quint32 count;
+			stream >> count;
+			for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+				QString id;
+				Entry entry;
+				stream >> id >> entry.size >> entry.lastAccess;
+				Entries[id] = entry;
+			}
+			if (stream.status() == QDataStream::Ok) {
+				for (const Entry &entry : Entries)
+					TotalSize += entry.size;
+				return;
+			}
+		}
+		qWarning() << QStringLiteral("Unable to read thumbnails index. Rebuild it.");
+		Entries.clear();
+	}
+	
+	// No index: take existing thumbnails (from older versions too) to be able to evict them.
+	for (const QFileInfo &info : QDir(getDirPath()).entryInfoList(QDir::Files)) {
+		if (info.fileName() == Constants::PathThumbnailsIndex)
+			continue;
+		Entry entry;
+		entry.size = info.size();
+		entry.lastAccess = info.lastModified().toMSecsSinceEpoch();
+		Entries[info.fileName()] = entry;
+		TotalSize += entry.size;
+	}
+	Dirty = true;
+}
+
+// Must be called with the mutex locked.
+static void removeEntry (const QString &id) {
+	auto it = Entries.find(id);
+	if (it == Entries.end())
+		return;
+	TotalSize -= it->size;
+	Entries.erase(it);
+	Dirty = true;
+	QString path = getDirPath() + id;
+	if (QFileInfo(path).isFile() && !QFile::remove(path))
+		qWarning() << QStringLiteral("Unable to remove `%1`.").arg(path);
+}
+
+// Must be called with the mutex locked.
+static void evict () {
+	if (TotalSize <= Constants::ThumbnailsMaxDiskSize)
+		return;
+	QList<QPair<qint64, QString>> accesses;
+	for (auto it = Entries.cbegin(); it != Entries.cend(); ++it)
+		accesses << qMakePair(it->lastAccess, it.key());
+	std::sort(accesses.begin(), accesses.end());
+	for (const auto &access : accesses) {
+		if (TotalSize <= Constants::ThumbnailsMaxDiskSize)
+			break;
+		qInfo() << QStringLiteral("Evict thumbnail `%1`.").arg(access.second);
+		removeEntry(access.second);
+	}
+}
+
+// Must be called with the mutex locked.
+static void saveIndex () {
+	if (!Loaded || !Dirty)
+		return;
+	QSaveFile file(getIndexPath());
+	if (!file.open(QIODevice::WriteOnly)) {
+		qWarning() << QStringLiteral("Unable to write thumbnails index: `%1`.").arg(file.fileName());
+		return;
+	}
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_9);
+	stream << IndexMagic << IndexVersion << quint32(Entries.size());
+	for (auto it = Entries.cbegin(); it != Entries.cend(); ++it)
+		stream << it.key() << it->size << it->lastAccess;
+	if (file.commit())
+		Dirty = false;
+	else
+		qWarning() << QStringLiteral("Unable to write thumbnails index: `%1`.").arg(file.fileName());
+}
+
+// -----------------------------------------------------------------------------
+
+QString ThumbnailStore::getThumbnail (const QString &filePath) {
+	if (!Utils::isImage(filePath))
+		return QString();
+	
+	QString hash = getFileHash(filePath);
+	if (hash.isEmpty())
+		return QString();
+	QString id = QStringLiteral("%1-%2x%3.jpg").arg(hash).arg(Constants::ThumbnailImageFileWidth).arg(Constants::ThumbnailImageFileHeight);
+	{
+		QMutexLocker locker(&Mutex);
+		loadIndex();
+		auto it = Entries.find(id);
+		if (it != Entries.end()) {
+			if (QFileInfo(getDirPath() + id).isFile()) {
+				it->lastAccess = QDateTime::currentMSecsSinceEpoch();
+				Dirty = true;
+				return id;
+			}
+			removeEntry(id);
+		}
+	}
+	
+	QImage thumbnail = createImage(filePath);
+	if (thumbnail.isNull())
+		return QString();
+	QString thumbnailPath = getDirPath() + id;
+	if (!thumbnail.save(thumbnailPath, "jpg", 100)) {
+		qWarning() << QStringLiteral("Unable to create thumbnail of: `%1`.").arg(filePath);
+		return QString();
+	}
+	
+	QMutexLocker locker(&Mutex);
+	Entry entry;
+	entry.size = QFileInfo(thumbnailPath).size();
+	entry.lastAccess = QDateTime::currentMSecsSinceEpoch();
+	if (Entries.contains(id))// Created concurrently.
+		TotalSize -= Entries[id].size;
+	Entries[id] = entry;
+	TotalSize += entry.size;
+	Dirty = true;
+	evict();
+	saveIndex();
+	return Entries.contains(id) ? id : QString();
+}
+
+bool ThumbnailStore::contains (const QString &id) {
+	QMutexLocker locker(&Mutex);
+	loadIndex();
+	return Entries.contains(id) && QFileInfo(getDirPath() + id).isFile();
+}
+
+QImage ThumbnailStore::getImage (const QString &id, const QSize &requestedSize) {
+	{
+		QMutexLocker locker(&Mutex);
+		loadIndex();
+		auto it = Entries.find(id);
+		if (it != Entries.end()) {
+			it->lastAccess = QDateTime::currentMSecsSinceEpoch();
+			Dirty = true;
+		}
+	}
+	return DecodedImageCache::getImage(getDirPath() + id, requestedSize);
+}
+
+void ThumbnailStore::save () {
+	QMutexLocker locker(&Mutex);
+	saveIndex();
+}
+
+// -----------------------------------------------------------------------------
+
+QString ThumbnailStore::getFileHash (const QString &filePath) {
+	QFileInfo info(filePath);
+	QString key = filePath + '|' + QString::number(info.size()) + '|' + QString::number(info.lastModified().toMSecsSinceEpoch());
+	{
+		QMutexLocker locker(&Mutex);
+		auto it = FileHashes.find(key);
+		if (it != FileHashes.end())
+			return *it;
+	}
+	
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return QString();
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (!hash.addData(&file))
+		return QString();
+	QString result = QString::fromLatin1(hash.result().toHex());
+	
+	QMutexLocker locker(&Mutex);
+	FileHashes[key] = result;
+	return result;
+}
+
+QImage ThumbnailStore::createImage (const QString &filePath) {
+	QImageReader reader(filePath);
+	if (!reader.canRead()) {// Try to determine format from headers
+		reader.setFileName(filePath);
+		reader.setDecideFormatFromContent(true);
+	}
+	reader.setAutoTransform(false);// The orientation is applied below from EXIF.
+	// Decode directly at the thumbnail size when the reader supports it, instead of the full image.
+	const QSize size = reader.size();
+	if (size.isValid()) {
+		const QSize scaledSize = size.scaled(
+					Constants::ThumbnailImageFileWidth, Constants::ThumbnailImageFileHeight,
+					Qt::KeepAspectRatio
+					);
+		if (scaledSize.width() < size.width() && scaledSize.height() < size.height())
+			reader.setScaledSize(scaledSize);
+	}
+	QImage image = reader.read();
+	if (image.isNull())
+		return image;
+	
+	int rotation = 0;
+	QExifImageHeader exifImageHeader;
+	if (exifImageHeader.loadFromJpeg(filePath))
+		rotation = int(exifImageHeader.value(QExifImageHeader::ImageTag::Orientation).toShort());
+	QImage thumbnail = image.scaled(
+				Constants::ThumbnailImageFileWidth, Constants::ThumbnailImageFileHeight,
+				Qt::KeepAspectRatio, Qt::SmoothTransformation
+				);
+	
+	if (rotation != 0) {
+		QTransform transform;
+		if (rotation == 3 || rotation == 4)
+			transform.rotate(180);
+		else if (rotation == 5 || rotation == 6)
+			transform.rotate(90);
+		else if (rotation == 7 || rotation == 8)
+			transform.rotate(-90);
+		thumbnail = thumbnail.transformed(transform);
+		if (rotation == 2 || rotation == 4 || rotation == 5 || rotation == 7)
+			thumbnail = thumbnail.mirrored(true, false);
+	}
+	return thumbnail;
+}
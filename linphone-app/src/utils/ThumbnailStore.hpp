@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THUMBNAIL_STORE_H_
+#define THUMBNAIL_STORE_H_
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// =============================================================================
+
+// Content-addressed thumbnails: ids are built from the hash of the source file and the thumbnail size,
+// so the same image shared in several messages uses one thumbnail.
+// The store is bounded on disk: least recently used thumbnails are evicted. They are never removed
+// explicitly, as several messages can share one. Thread-safe.
+class ThumbnailStore {
+public:
+	// Return the id of the thumbnail of an image file, creating it if needed.
+	// Empty if the file is not a readable image.
+	static QString getThumbnail (const QString &filePath);
+	static bool contains (const QString &id);
+	static QImage getImage (const QString &id, const QSize &requestedSize = QSize());
+	
+	static void save ();
+	
+	// Hash of the file content, cached by path, size and modification date. Also used by other stores.
+	static QString getFileHash (const QString &filePath);
+	
+private:
+	ThumbnailStore () = delete;
+	
+	static QImage createImage (const QString &filePath);
+};
+
+#endif // THUMBNAIL_STORE_H_
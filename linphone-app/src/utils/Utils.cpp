@@ -28,6 +28,8 @@
 #include <QUrl>
 
 #include "config.h"
+#include "DecodedImageCache.hpp"
+#include "SipAddressCache.hpp"
 #include "Utils.hpp"
 #include "components/core/CoreManager.hpp"
 #include "components/contacts/ContactsListModel.hpp"
@@ -45,7 +47,7 @@ constexpr int SafeFilePathLimit = 100;
 }
 
 std::shared_ptr<linphone::Address> Utils::interpretUrl(const QString& address){
-	return CoreManager::getInstance()->getCore()->interpretUrl(Utils::appStringToCoreString(address));
+	return SipAddressCache::interpretUrl(address);
 }
 char *Utils::rstrstr (const char *a, const char *b) {
 	size_t a_len = strlen(a);
@@ -112,14 +114,17 @@ QString Utils::toString(const LinphoneEnums::TunnelMode& mode){
 	}
 }
 
-QImage Utils::getImage(const QString &pUri) {
-	QImage image(pUri);
+QImage Utils::getImage(const QString &pUri, const QSize &requestedSize) {
+	return DecodedImageCache::getImage(pUri, requestedSize);
+}
+
+bool Utils::isImage(const QString &pUri) {
 	QImageReader reader(pUri);
-	reader.setAutoTransform(true);
-	if(image.isNull()){// Try to determine format from headers instead of using suffix
-		reader.setDecideFormatFromContent(true);
-	}
-	return reader.read();
+	if(reader.canRead())
+		return true;
+	reader.setFileName(pUri);
+	reader.setDecideFormatFromContent(true);// Try to determine format from headers instead of using suffix
+	return reader.canRead();
 }
 QString Utils::getSafeFilePath (const QString &filePath, bool *soFarSoGood) {
 	if (soFarSoGood)
@@ -158,21 +163,7 @@ std::shared_ptr<linphone::Address> Utils::getMatchingLocalAddress(std::shared_pt
 }
 // Return at most : sip:username@domain
 QString Utils::cleanSipAddress (const QString &sipAddress) {
-	std::shared_ptr<linphone::Address> addr = linphone::Factory::get()->createAddress(sipAddress.toStdString());
-	if( addr) {
-		addr->clean();
-		QStringList fields = Utils::coreStringToAppString(addr->asStringUriOnly()).split('@');
-		if(fields.size() > 0){// maybe useless but it's just to be sure to have a domain
-			fields.removeLast();
-			QString domain = Utils::coreStringToAppString(addr->getDomain());
-			if( domain.count(':')>1)
-				fields.append('['+domain+']');
-			else
-				fields.append(domain);
-			return fields.join('@');
-		}
-	}
-	return sipAddress;
+	return SipAddressCache::cleanSipAddress(sipAddress);
 }
 // Data to retrieve WIN32 process
 #ifdef _WIN32
@@ -526,11 +517,11 @@ QString Utils::computeUserAgent(const std::shared_ptr<linphone::Config>& config)
 }
 
 bool Utils::isMe(const QString& address){
-	return !address.isEmpty() ? CoreManager::getInstance()->getAccountSettingsModel()->getUsedSipAddress()->weakEqual(Utils::interpretUrl(address)) : false;
+	return !address.isEmpty() ? isMe(Utils::interpretUrl(address)) : false;
 }
 
 bool Utils::isMe(const std::shared_ptr<const linphone::Address>& address){
-	return address ? CoreManager::getInstance()->getAccountSettingsModel()->getUsedSipAddress()->weakEqual(address) : false;
+	return address ? SipAddressCache::getHandle(CoreManager::getInstance()->getAccountSettingsModel()->getUsedSipAddress()) == SipAddressCache::getHandle(address) : false;
 }
 
 bool Utils::isAnimatedImage(const QString& path){
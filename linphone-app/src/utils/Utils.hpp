@@ -77,7 +77,8 @@ public:
 	// Reverse function of strstr.
 	static char *rstrstr (const char *a, const char *b);
 	// Return the path if it is an image else an empty path.
-	static QImage getImage(const QString &pUri);
+	static QImage getImage(const QString &pUri, const QSize &requestedSize = QSize());
+	static bool isImage(const QString &pUri);
 	// Returns the same path given in parameter if `filePath` exists.
 	// Otherwise returns a safe path with a unique number before the extension.
 	static QString getSafeFilePath (const QString &filePath, bool *soFarSoGood = nullptr);
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtDebug>
+#include <QtEndian>
+
+#include "app/paths/Paths.hpp"
+#include "Constants.hpp"
+#include "ThumbnailStore.hpp"
+#include "Utils.hpp"
+
+#include "WaveformStore.hpp"
+
+// =============================================================================
+
+namespace {
+	// Matroska element ids, with their length markers.
+	constexpr quint64 EbmlHeaderId = 0x1A45DFA3;
+	constexpr quint64 SegmentId = 0x18538067;
+	constexpr quint64 TracksId = 0x1654AE6B;
+	constexpr quint64 TrackEntryId = 0xAE;
+	constexpr quint64 TrackNumberId = 0xD7;
+	constexpr quint64 TrackTypeId = 0x83;
+	constexpr quint64 ClusterId = 0x1F43B675;
+	constexpr quint64 ClusterTimecodeId = 0xE7;
+	constexpr quint64 BlockGroupId = 0xA0;
+	constexpr quint64 BlockId = 0xA1;
+	constexpr quint64 SimpleBlockId = 0xA3;
+	
+	constexpr quint64 AudioTrackType = 2;
+	constexpr quint64 UnknownSize = ~quint64(0);
+	
+	constexpr quint16 WavPcmFormat = 1;
+	constexpr quint16 WavExtensibleFormat = 0xFFFE;
+	constexpr qint64 WavReadSize = 4096;// In frames.
+	
+	struct ExtractionPool : public QThreadPool {
+		ExtractionPool () {
+			setMaxThreadCount(1);
+		}
+	};
+	Q_GLOBAL_STATIC(ExtractionPool, Pool)
+}
+
+static QString getDirPath () {
+	return Utils::coreStringToAppString(Paths::getThumbnailsDirPath()) + Constants::PathWaveforms;
+}
+
+static QVector<float> toWaveform (const QByteArray &data) {
+	QVector<float> waveform;
+	waveform.reserve(data.size());
+	for (char value : data)
+		waveform << float(quint8(value)) / 255.f;
+	return waveform;
+}
+
+// -----------------------------------------------------------------------------
+
+QVector<float> WaveformStore::getWaveform (const QString &filePath) {
+	const QString hash = ThumbnailStore::getFileHash(filePath);
+	if (hash.isEmpty())
+		return QVector<float>();
+	const QString path = getDirPath() + QStringLiteral("%1-%2").arg(hash).arg(Constants::WaveformSamplesCount);
+	
+	QFile file(path);
+	if (file.open(QIODevice::ReadOnly)) {
+		const QByteArray data = file.readAll();
+		if (data.size() == Constants::WaveformSamplesCount)
+			return toWaveform(data);
+		qWarning() << QStringLiteral("Invalid waveform: `%1`. Extract it again.").arg(path);
+	}
+	
+	const QVector<float> waveform = extract(filePath);
+	if (waveform.isEmpty())
+		return waveform;
+	QByteArray data;
+	data.reserve(waveform.size());
+	for (float value : waveform)
+		data.append(char(qRound(qBound(0.f, value, 1.f) * 255.f)));
+	
+	QSaveFile saveFile(path);
+	if (!QDir().mkpath(getDirPath()) || !saveFile.open(QIODevice::WriteOnly) || saveFile.write(data) != data.size() || !saveFile.commit())
+		qWarning() << QStringLiteral("Unable to write waveform: `%1`.").arg(path);
+	return toWaveform(data);
+}
+
+QFuture<QVector<float>> WaveformStore::requestWaveform (const QString &filePath) {
+	return QtConcurrent::run(Pool(), [filePath]() {
+		return getWaveform(filePath);
+	});
+}
+
+// -----------------------------------------------------------------------------
+
+QVector<float> WaveformStore::extract (const QString &filePath) {
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		qWarning() << QStringLiteral("Unable to open `%1` to extract its waveform.").arg(filePath);
+		return QVector<float>();
+	}
+	const QByteArray magic = file.peek(4);
+	if (magic == "RIFF")
+		return extractWav(file);
+	if (magic.size() == 4 && qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(magic.constData())) == EbmlHeaderId)
+		return extractMatroska(file);
+	qInfo() << QStringLiteral("No waveform for `%1`: unsupported format.").arg(filePath);
+	return QVector<float>();
+}
+
+QVector<float> WaveformStore::extractWav (QIODevice &device) {
+	char header[12];
+	if (device.read(header, sizeof header) != qint64(sizeof header) || std::memcmp(header + 8, "WAVE", 4))
+		return QVector<float>();
+	
+	quint16 format = 0, channels = 0, bits = 0;
+	char chunk[8];
+	while (device.read(chunk, sizeof chunk) == qint64(sizeof chunk)) {
+		const quint32 chunkSize = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(chunk + 4));
+		if (!std::memcmp(chunk, "fmt ", 4)) {
+			const QByteArray fmt = device.read(chunkSize);
+			if (fmt.size() < 16)
+				return QVector<float>();
+			const uchar *data = reinterpret_cast<const uchar *>(fmt.constData());
+			format = qFromLittleEndian<quint16>(data);
+			channels = qFromLittleEndian<quint16>(data + 2);
+			bits = qFromLittleEndian<quint16>(data + 14);
+			if (format == WavExtensibleFormat && fmt.size() >= 26)
+				format = qFromLittleEndian<quint16>(data + 24);
+			if (chunkSize & 1)
+				device.seek(device.pos() + 1);
+		} else if (!std::memcmp(chunk, "data", 4)) {
+			if (format != WavPcmFormat || bits != 16 || channels == 0)
+				return QVector<float>();
+			const qint64 frameSize = 2 * channels;
+			// The size of the chunk is not set if the recording was not closed.
+			const qint64 framesCount = qMin<qint64>(chunkSize, device.size() - device.pos()) / frameSize;
+			if (framesCount <= 0)
+				return QVector<float>();
+			
+			QVector<float> peaks(Constants::WaveformSamplesCount, 0.f);
+			qint64 index = 0;
+			while (index < framesCount) {
+				const QByteArray buffer = device.read(qMin(framesCount - index, WavReadSize) * frameSize);
+				const qint64 count = buffer.size() / frameSize;
+				if (count == 0)
+					break;
+				const uchar *data = reinterpret_cast<const uchar *>(buffer.constData());
+				for (qint64 i = 0; i < count; ++i, ++index) {
+					float &peak = peaks[int(index * Constants::WaveformSamplesCount / framesCount)];
+					for (int channel = 0; channel < channels; ++channel) {
+						const float value = qAbs(float(qFromLittleEndian<qint16>(data + (i * channels + channel) * 2))) / 32768.f;
+						if (value > peak)
+							peak = value;
+					}
+				}
+			}
+			return peaks;
+		} else if (!device.seek(device.pos() + chunkSize + (chunkSize & 1)))
+			break;
+	}
+	return QVector<float>();
+}
+
+// -----------------------------------------------------------------------------
+
+static bool readVint (QIODevice &device, quint64 &value, bool isId) {
+	char c;
+	if (!device.getChar(&c))
+		return false;
+	const quint8 first = quint8(c);
+	int length = 1;
+	quint8 mask = 0x80;
+	while (length <= 8 && !(first & mask)) {
+		++length;
+		mask >>= 1;
+	}
+	if (length > (isId ? 4 : 8))
+		return false;
+	
+	// Ids keep their length marker, sizes don't.
+	value = isId ? first : quint64(first & (mask - 1));
+	bool allOnes = value == quint64(mask - 1);
+	for (int i = 1; i < length; ++i) {
+		if (!device.getChar(&c))
+			return false;
+		value = (value << 8) | quint8(c);
+		allOnes = allOnes && quint8(c) == 0xFF;
+	}
+	if (!isId && allOnes)
+		value = UnknownSize;
+	return true;
+}
+
+static bool readUnsigned (QIODevice &device, quint64 size, quint64 &value) {
+	if (size > 8)
+		return false;
+	const QByteArray data = device.read(qint64(size));
+	if (data.size() != int(size))
+		return false;
+	value = 0;
+	for (char c : data)
+		value = (value << 8) | quint8(c);
+	return true;
+}
+
+QVector<float> WaveformStore::extractMatroska (QIODevice &device) {
+	struct Frame {
+		qint64 time;// In timecode ticks.
+		qint64 size;
+	};
+	QVector<Frame> frames;
+	quint64 audioTrack = 0, trackNumber = 0, trackType = 0, clusterTimecode = 0;
+	
+	quint64 id, size;
+	while (readVint(device, id, true) && readVint(device, size, false)) {
+		switch (id) {
+			// Read the children of these elements in the same loop: their size can be unknown.
+			case SegmentId:
+			case TracksId:
+			case ClusterId:
+			case BlockGroupId:
+				continue;
+			case TrackEntryId:
+				trackNumber = trackType = 0;
+				continue;
+				
+			case TrackNumberId:
+			case TrackTypeId:
+			case ClusterTimecodeId: {
+				quint64 value;
+				if (!readUnsigned(device, size, value))
+					return QVector<float>();
+				if (id == ClusterTimecodeId)
+					clusterTimecode = value;
+				else {
+					if (id == TrackNumberId)
+						trackNumber = value;
+					else
+						trackType = value;
+					if (!audioTrack && trackNumber && trackType == AudioTrackType)
+						audioTrack = trackNumber;
+				}
+				continue;
+			}
+			
+			case SimpleBlockId:
+			case BlockId: {
+				if (size == UnknownSize)
+					return QVector<float>();
+				const qint64 end = device.pos() + qint64(size);
+				quint64 track;
+				char header[3];// Relative timecode and flags.
+				if (!readVint(device, track, false) || device.read(header, sizeof header) != qint64(sizeof header))
+					return QVector<float>();
+				if (!audioTrack || track == audioTrack) {
+					const qint16 timecode = qFromBigEndian<qint16>(reinterpret_cast<const uchar *>(header));
+					frames << Frame{ qint64(clusterTimecode) + timecode, end - device.pos() };
+				}
+				if (!device.seek(end))
+					break;
+				continue;
+			}
+			
+			default:
+				if (size == UnknownSize)
+					return QVector<float>();
+				if (!device.seek(device.pos() + qint64(size)))
+					break;
+				continue;
+		}
+		break;
+	}
+	if (frames.isEmpty())
+		return QVector<float>();
+	
+	// With Opus VBR and DTX, silence gives the smallest frames.
+	qint64 firstTime = frames.first().time, lastTime = firstTime;
+	qint64 minSize = frames.first().size, maxSize = minSize;
+	for (const Frame &frame : frames) {
+		firstTime = qMin(firstTime, frame.time);
+		lastTime = qMax(lastTime, frame.time);
+		minSize = qMin(minSize, frame.size);
+		maxSize = qMax(maxSize, frame.size);
+	}
+	QVector<float> peaks(Constants::WaveformSamplesCount, 0.f);
+	if (maxSize == minSize)
+		return peaks;
+	const qint64 duration = lastTime - firstTime + 1;
+	for (const Frame &frame : frames) {
+		float &peak = peaks[int((frame.time - firstTime) * Constants::WaveformSamplesCount / duration)];
+		peak = qMax(peak, float(frame.size - minSize) / float(maxSize - minSize));
+	}
+	return peaks;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WAVEFORM_STORE_H_
+#define WAVEFORM_STORE_H_
+
+#include <QFuture>
+#include <QString>
+#include <QVector>
+
+// =============================================================================
+
+class QIODevice;
+
+// Peak envelopes of audio files, computed once and stored on disk next to the thumbnails.
+// Like thumbnails, they are addressed by the hash of the file content. Thread-safe.
+class WaveformStore {
+public:
+	// Return Constants::WaveformSamplesCount values in [0, 1], extracting them if needed.
+	// Empty if the file is not a supported audio file.
+	static QVector<float> getWaveform (const QString &filePath);
+	// Same as getWaveform, run in background. Extractions are done one at a time.
+	static QFuture<QVector<float>> requestWaveform (const QString &filePath);
+	
+private:
+	WaveformStore () = delete;
+	
+	static QVector<float> extract (const QString &filePath);
+	// 16 bits PCM.
+	static QVector<float> extractWav (QIODevice &device);
+	// Voice recordings (Opus). There is no decoder in the application: the envelope is built from the
+	// sizes of the compressed frames, which follow the loudness with a variable bitrate.
+	static QVector<float> extractMatroska (QIODevice &device);
+};
+
+#endif // WAVEFORM_STORE_H_
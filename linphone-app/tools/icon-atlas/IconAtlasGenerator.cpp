@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2010-2020 Belledonne Communications SARL.
+ *
+ * This file is part of linphone-desktop
+ * (see https://www.linphone.org).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Build tool: pre-render internal SVG icons into an atlas.
+// Usage: icon-atlas-generator <images dir> <pages prefix> <atlas.index> <size>[,<size>...] <dpr>[,<dpr>...]
+// The atlas is split into pages (`<pages prefix>-<n>.png`): one page per dpr for the default sizes, then one page per
+// dpr and size. All pages are written, even empty ones, so the build system knows the outputs in advance.
+// Icons using color classes (`color-<name>-*`, see ImageProvider) depend on the theme. When they use a single color, they
+// are rendered with black then white instead of this color: the icon is linear in the color, so the black rendering and
+// the difference (the mask) are enough to tint it at runtime. The mask is packed in the same page.
+// Icons using several colors are left to runtime rendering.
+
+#include <algorithm>
+
+#include <QColor>
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QImage>
+#include <QPainter>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QSvgRenderer>
+#include <QTextStream>
+#include <QVector>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QtDebug>
+
+// =============================================================================
+
+namespace {
+	constexpr int AtlasWidth = 2048;
+	constexpr qint64 MaxImageSize = 102400;// Same as Constants::MaxImageSize.
+}
+
+struct Icon {
+	QString id;
+	QSize size;
+	QImage image;
+	int page;
+	QPoint position;
+	QString colorName;// Set on tinted icons and their mask.
+	bool isMask;
+};
+
+static QList<qreal> parseList (const QString &value) {
+	QList<qreal> list;
+	for (const QString &item : value.split(','))
+		if (!item.trimmed().isEmpty())
+			list << item.toDouble();
+	return list;
+}
+
+// Same substitution as ImageProvider: `color-<name>-(fill|stroke)` classes replace the attribute,
+// `color-<name>-style-(fill|stroke)` classes replace the style property. Used color names are added to `names`.
+static QByteArray colorize (const QByteArray &content, const QColor &color, QSet<QString> &names) {
+	static const QRegularExpression regex("^color-([^-]+)-(style-)?(fill|stroke)$");
+	
+	QByteArray result;
+	QXmlStreamReader reader(content);
+	QXmlStreamWriter writer(&result);
+	while (!reader.atEnd()) {
+		if (reader.readNext() != QXmlStreamReader::StartElement) {
+			writer.writeCurrentToken(reader);
+			continue;
+		}
+		
+		QXmlStreamAttributes attributes;
+		QStringList style = reader.attributes().value("style").toString().split(';', QString::SkipEmptyParts);
+		QSet<QString> overrode;
+		for (const QString &classValue : reader.attributes().value("class").toString().split(' ', QString::SkipEmptyParts)) {
+			const QRegularExpressionMatch match = regex.match(classValue);
+			if (!match.hasMatch())
+				continue;
+			names << match.captured(1);
+			const QString property = match.captured(3);
+			if (match.captured(2).isEmpty()) {
+				overrode << property;
+				attributes.append(property, color.name());
+			} else {
+				style.erase(std::remove_if(style.begin(), style.end(), [&property](const QString &value) {
+					return value.section(':', 0, 0).trimmed() == property;
+				}), style.end());
+				style << property + ':' + color.name();
+			}
+		}
+		for (const QXmlStreamAttribute &attribute : reader.attributes()) {
+			const bool isOverrode = attribute.prefix().isEmpty() && (overrode.contains(attribute.name().toString()) || attribute.name() == "style");
+			if (!isOverrode)
+				attributes.append(attribute);
+		}
+		if (!style.isEmpty())
+			attributes.append("style", style.join(';'));
+		
+		// Declarations apply to the next element.
+		for (const QXmlStreamNamespaceDeclaration &declaration : reader.namespaceDeclarations()) {
+			if (declaration.prefix().isEmpty())
+				writer.writeDefaultNamespace(declaration.namespaceUri().toString());
+			else
+				writer.writeNamespace(declaration.namespaceUri().toString(), declaration.prefix().toString());
+		}
+		writer.writeStartElement(reader.namespaceUri().toString(), reader.name().toString());
+		writer.writeAttributes(attributes);
+	}
+	return reader.hasError() ? QByteArray() : result;
+}
+
+static QImage render (QSvgRenderer &renderer, const QSize &size) {
+	QImage image(size, QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::transparent);
+	QPainter painter(&image);
+	renderer.render(&painter);
+	return image;
+}
+
+// Weight of the color in each pixel, stored in the alpha channel.
+static QImage computeMask (const QImage &black, const QImage &white) {
+	QImage mask(black.size(), QImage::Format_ARGB32_Premultiplied);
+	for (int y = 0; y < mask.height(); ++y) {
+		const QRgb *blackLine = reinterpret_cast<const QRgb *>(black.constScanLine(y));
+		const QRgb *whiteLine = reinterpret_cast<const QRgb *>(white.constScanLine(y));
+		QRgb *maskLine = reinterpret_cast<QRgb *>(mask.scanLine(y));
+		for (int x = 0; x < mask.width(); ++x) {
+			const int weight = qBound(0, qMax(
+				qMax(qRed(whiteLine[x]) - qRed(blackLine[x]), qGreen(whiteLine[x]) - qGreen(blackLine[x])),
+				qBlue(whiteLine[x]) - qBlue(blackLine[x])
+			), 255);
+			maskLine[x] = qRgba(weight, weight, weight, weight);
+		}
+	}
+	return mask;
+}
+
+int main (int argc, char *argv[]) {
+	QGuiApplication app(argc, argv);
+	if (argc != 6) {
+		qCritical() << "Usage:" << argv[0] << "<images dir> <atlas.png> <atlas.index> <sizes> <dprs>";
+		return 1;
+	}
+	const QString imagesPath = QString::fromLocal8Bit(argv[1]);
+	const QList<qreal> sizes = parseList(QString::fromLocal8Bit(argv[4]));
+	const QList<qreal> dprs = parseList(QString::fromLocal8Bit(argv[5]));
+	
+	QList<Icon> icons;
+	QStringList defaults;
+	for (const QFileInfo &info : QDir(imagesPath).entryInfoList({ "*.svg" }, QDir::Files, QDir::Name)) {
+		if (info.size() > MaxImageSize)
+			continue;
+		QFile file(info.filePath());
+		if (!file.open(QIODevice::ReadOnly))
+			continue;
+		const QByteArray content = file.readAll();
+		QSet<QString> names;
+		const QByteArray black = colorize(content, Qt::black, names);
+		if (names.size() > 1)
+			continue;
+		const QString colorName = names.isEmpty() ? QString() : *names.begin();
+		QSvgRenderer renderer(colorName.isEmpty() ? content : black);
+		QSvgRenderer whiteRenderer(colorName.isEmpty() ? QByteArray() : colorize(content, Qt::white, names));
+		if (!renderer.isValid() || (!colorName.isEmpty() && !whiteRenderer.isValid())) {
+			qWarning() << "Invalid svg file:" << info.filePath();
+			continue;
+		}
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+		renderer.setAspectRatioMode(Qt::KeepAspectRatio);
+		whiteRenderer.setAspectRatioMode(Qt::KeepAspectRatio);
+#endif
+		const QString id = info.completeBaseName();
+		const QSize defaultSize = renderer.defaultSize();
+		defaults << QStringLiteral("@%1 %2 %3").arg(id).arg(defaultSize.width()).arg(defaultSize.height());
+		
+		QList<QPair<int, QSize>> iconSizes;
+		for (int i = 0; i < dprs.size(); ++i) {
+			const int firstPage = i * (sizes.size() + 1);
+			iconSizes << qMakePair(firstPage, defaultSize * dprs[i]);// Same computation as ImageProvider when no size is requested.
+			for (int j = 0; j < sizes.size(); ++j)
+				iconSizes << qMakePair(firstPage + j + 1, QSize(qRound(sizes[j] * dprs[i]), qRound(sizes[j] * dprs[i])));
+		}
+		for (const auto &iconSize : iconSizes) {
+			const QSize &size = iconSize.second;
+			if (size.isEmpty() || std::any_of(icons.cbegin(), icons.cend(), [&](const Icon &icon) {
+				return icon.id == id && icon.size == size;
+			}))
+				continue;
+			const QImage image = render(renderer, size);
+			icons << Icon{ id, size, image, iconSize.first, QPoint(), colorName, false };
+			if (!colorName.isEmpty())
+				icons << Icon{ id, size, computeMask(image, render(whiteRenderer, size)), iconSize.first, QPoint(), colorName, true };
+		}
+	}
+	
+	// Shelf packing of each page, tallest first.
+	std::stable_sort(icons.begin(), icons.end(), [](const Icon &a, const Icon &b) {
+		return a.page != b.page ? a.page < b.page : a.size.height() > b.size.height();
+	});
+	const int pagesCount = dprs.size() * (sizes.size() + 1);
+	QVector<QSize> pageSizes(pagesCount, QSize(1, 1));
+	for (int page = 0, first = 0; page < pagesCount; ++page) {
+		int x = 0, y = 0, shelfHeight = 0, width = 1;
+		for (; first < icons.size() && icons[first].page == page; ++first) {
+			Icon &icon = icons[first];
+			if (x + icon.size.width() > AtlasWidth) {
+				x = 0;
+				y += shelfHeight;
+				shelfHeight = 0;
+			}
+			icon.position = QPoint(x, y);
+			x += icon.size.width();
+			width = qMax(width, x);
+			shelfHeight = qMax(shelfHeight, icon.size.height());
+		}
+		pageSizes[page] = QSize(width, qMax(1, y + shelfHeight));
+	}
+	
+	QSaveFile indexFile(QString::fromLocal8Bit(argv[3]));
+	if (!indexFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		qCritical() << "Unable to write index:" << indexFile.fileName();
+		return 1;
+	}
+	QTextStream index(&indexFile);
+	const QString pagesPrefix = QString::fromLocal8Bit(argv[2]);
+	for (int page = 0; page < pagesCount; ++page) {
+		QImage atlas(pageSizes[page], QImage::Format_ARGB32_Premultiplied);
+		atlas.fill(Qt::transparent);
+		{
+			QPainter painter(&atlas);
+			painter.setCompositionMode(QPainter::CompositionMode_Source);
+			for (const Icon &icon : icons) {
+				if (icon.page != page)
+					continue;
+				painter.drawImage(icon.position, icon.image);
+				if (icon.isMask)
+					continue;
+				index << icon.id << ' ' << page << ' ' << icon.position.x() << ' ' << icon.position.y() << ' '
+					<< icon.size.width() << ' ' << icon.size.height();
+				if (!icon.colorName.isEmpty()) {
+					auto mask = std::find_if(icons.cbegin(), icons.cend(), [&icon](const Icon &other) {
+						return other.isMask && other.id == icon.id && other.size == icon.size;
+					});
+					index << ' ' << icon.colorName << ' ' << mask->position.x() << ' ' << mask->position.y();
+				}
+				index << '\n';
+			}
+		}
+		const QString pagePath = QStringLiteral("%1-%2.png").arg(pagesPrefix).arg(page);
+		if (!atlas.save(pagePath, "png")) {
+			qCritical() << "Unable to write atlas page:" << pagePath;
+			return 1;
+		}
+	}
+	for (const QString &line : defaults)
+		index << line << '\n';
+	index.flush();
+	
+	if (!indexFile.commit()) {
+		qCritical() << "Unable to write index:" << indexFile.fileName();
+		return 1;
+	}
+	qInfo() << "Icon atlas:" << icons.size() << "images in" << pagesCount << "pages.";
+	return 0;
+}
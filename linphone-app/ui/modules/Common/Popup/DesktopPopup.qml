@@ -60,7 +60,7 @@ Item {
     opacity: 1.0
     height: _content[0] != null ? _content[0].height : 0
     width: _content[0] != null ? _content[0].width : 0
-    visible:true
+    visible: false // Shown by the notifier: the popup can be created in advance.
     Item {
       id: content
       anchors.fill:parent
@@ -97,7 +97,7 @@ Item {
       from: '*'
       to: ''
       ScriptAction {
-        script: window.close()
+        script: window.hide() // Keep the window resources: it can be reused.
       }
     }
   ]
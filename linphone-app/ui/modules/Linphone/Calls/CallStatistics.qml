@@ -10,7 +10,7 @@ import Linphone.Styles 1.0
 Popup {
 	id: callStatistics
 	
-	property var call
+	property var call	// Statistics are formatted only while the popup is open.
 	backgroundPopup: CallStatisticsStyle.outsideColor
 	showShadow: false	// if true, we get a brownish/yollow color due to alphas
 	// ---------------------------------------------------------------------------
@@ -52,7 +52,7 @@ Popup {
 						spacing: 30
 						Loader {
 							property string $label: qsTr('audioStatsLabel')
-							property var $data: callStatistics.call?callStatistics.call.audioStats:null
+							property var $data: callStatistics.isOpen && callStatistics.call ? callStatistics.call.audioStats : null
 							property bool $fillLayout: !encryptionLoader.active
 							
 							sourceComponent: media
@@ -62,7 +62,7 @@ Popup {
 							id: encryptionLoader
 							//: 'Media encryption' : title in call statistics for the encryption section
 							property string $label: qsTr('mediaEncryptionLabel')
-							property var $data: callStatistics.call ? callStatistics.call.encryptionStats : null
+							property var $data: callStatistics.isOpen && callStatistics.call ? callStatistics.call.encryptionStats : null
 							
 							sourceComponent: callStatistics.call && callStatistics.call.isSecured ? media : undefined
 							width: parent.width
@@ -77,7 +77,7 @@ Popup {
 					Loader {
 						id: videoLoader
 						property string $label: qsTr('videoStatsLabel')
-						property var $data: callStatistics.call?callStatistics.call.videoStats:null
+						property var $data: callStatistics.isOpen && callStatistics.call ? callStatistics.call.videoStats : null
 						
 						sourceComponent: callStatistics.call && callStatistics.call.videoEnabled ? media : undefined
 						width: sourceComponent ? parent.width : 0
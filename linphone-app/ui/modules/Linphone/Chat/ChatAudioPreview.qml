@@ -67,13 +67,7 @@ Rectangle{
 		VuMeter {
 			Layout.leftMargin: 6
 			Layout.rightMargin: 6
-			Timer {
-				interval: 50
-				repeat: true
-				running: audioPreviewBlock.isRecording
-				
-				onTriggered: parent.value = audioPreviewBlock.vocalRecorder.getCaptureVolume()
-			}
+			value: audioPreviewBlock.isRecording ? audioPreviewBlock.vocalRecorder.captureLevelMeter.level : 0
 			visible: audioPreviewBlock.isRecording
 		}
 		Item{
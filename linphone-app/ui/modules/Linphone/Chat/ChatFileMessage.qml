@@ -32,6 +32,8 @@ Row {
 	signal copySelectionDone()
 	signal forwardClicked()
 	height: fitHeight
+	onContentModelChanged: if(contentModel) contentModel.setVisible(true)
+	Component.onDestruction: if(contentModel) contentModel.setVisible(false)
 	visible: contentModel && !contentModel.isIcalendar() && (contentModel.isFile() || contentModel.isFileTransfer()) && !contentModel.isVoiceRecording()
 	// ---------------------------------------------------------------------------
 	// File message.
@@ -14,7 +14,7 @@ import 'Chat.js' as Logic
 
 // =============================================================================
 Item{
-	visible: mainListView.count > 0
+	visible: mainListView.count > 0 || contents.preparingCount > 0
 	Layout.preferredHeight: visible ? ChatFilePreviewStyle.height : 0
 	
 	function addFile(path){
@@ -70,6 +70,15 @@ Item{
 				}
 		}
 	}
+	ProgressBar{// Images being compressed before being added.
+		anchors.left: parent.left
+		anchors.right: mainListView.right
+		anchors.bottom: parent.bottom
+		visible: contents.preparingCount > 0
+		from: 0
+		to: 1
+		value: contents.preparingProgress
+	}
 	ActionButton{
 		anchors.verticalCenter: parent.verticalCenter
 		anchors.right: parent.right
@@ -44,6 +44,11 @@ Rectangle {
 	color: 'transparent' // No color by default.
 	height: ContactStyle.height
 	
+	PresenceVisibility {
+		contact: entry ? (entry.contactModel || entry.contact || null) : null
+		sipAddress: entry && entry.isOneToOne && entry.sipAddressUriOnly ? entry.sipAddressUriOnly : ''
+	}
+	
 	RowLayout {
 		anchors {
 			fill: parent
@@ -0,0 +1,31 @@
+import QtQml 2.2
+
+import Linphone 1.0
+
+// =============================================================================
+// Report a displayed contact to `ContactsListModel`: only displayed contacts get a live presence.
+// The contact can be given directly or found from a sip address.
+
+QtObject {
+	property var contact
+	property string sipAddress
+	
+	readonly property var _contact: contact
+									? contact
+									: (sipAddress ? ContactsListModel.getContactModelFromSipAddress(sipAddress) : null)
+	property var _reported: null
+	
+	function _report () {
+		if (_reported === _contact)
+			return
+		if (_reported)
+			ContactsListModel.setContactVisible(_reported, false)
+		_reported = _contact
+		if (_reported)
+			ContactsListModel.setContactVisible(_reported, true)
+	}
+	
+	on_ContactChanged: _report()
+	Component.onCompleted: _report()
+	Component.onDestruction: if (_reported) ContactsListModel.setContactVisible(_reported, false)
+}
@@ -184,12 +184,16 @@ DialogPlus {
 					//Empty slider handle
 					handle: Text {text: ''; visible: false }
 
+					property real callMicroVu: 0
+					value: call ? callMicroVu : SettingsModel.micLevelMeter.level
+
+					// The call volume is read from the call on the GUI thread: it cannot be pushed by a level meter.
 					Timer {
 						interval: 50
 						repeat: true
-						running: SettingsModel.captureGraphRunning || call || false
+						running: !!call
 
-						onTriggered: call ? parent.value = call.microVu : parent.value = SettingsModel.getMicVolume()
+						onTriggered: parent.callMicroVu = call.microVu
 					}
 				}
 			}
@@ -25,6 +25,7 @@ DialogPlus {
 
   function install () {
     dialog._installing = true
+    fileExtractor.extract()
     fileDownloader.download()
   }
 
@@ -123,17 +124,14 @@ DialogPlus {
     FileDownloader {
       id: fileDownloader
 
-      onDownloadFailed: dialog._endInstall(0)
-      onDownloadFinished: {
-        fileExtractor.file = filePath
-        progressBar.target = fileExtractor
-        fileExtractor.extract()
-      }
+      onDownloadFinished: progressBar.target = fileExtractor
     }
 
+    // Extracted while downloading.
     FileExtractor {
       id: fileExtractor
 
+      downloader: fileDownloader
       extractFolder: dialog.installFolder
       extractName: dialog.installName
 
@@ -282,13 +282,7 @@ Rectangle {
 				}
 				VuMeter {
 					enabled: !micro.microMuted
-					Timer {
-						interval: 50
-						repeat: true
-						running: parent.enabled
-						
-						onTriggered: parent.value = SettingsModel.getMicVolume()
-					}
+					value: enabled ? SettingsModel.micLevelMeter.level : 0
 				}
 				ActionSwitch {
 					id: speaker
@@ -91,6 +91,10 @@ ColumnLayout {
 				height: ContactsStyle.contact.height
 				width: parent ? parent.width : 0
 				
+				PresenceVisibility {
+					contact: $modelData
+				}
+				
 				// ---------------------------------------------------------------------
 				
 				Rectangle {
@@ -100,6 +100,9 @@ ColumnLayout  {
 				
 				image: Logic.getAvatar()
 				presenceLevel: chatRoomModel && chatRoomModel.presenceStatus
+				PresenceVisibility {
+					sipAddress: chatRoomModel && chatRoomModel.isOneToOne ? chatRoomModel.sipAddressUriOnly : ''
+				}
 				
 				//username: Logic.getUsername()
 				username: chatRoomModel?chatRoomModel.username:( conversation._sipAddressObserver ? UtilsCpp.getDisplayName(conversation._sipAddressObserver.peerAddress) : '')
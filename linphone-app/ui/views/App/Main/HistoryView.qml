@@ -55,6 +55,9 @@ ColumnLayout  {
 				presenceLevel: historyView._sipAddressObserver?Presence.getPresenceLevel(
 																	historyView._sipAddressObserver.presenceStatus
 																	):null
+				PresenceVisibility {
+					contact: historyView._sipAddressObserver ? historyView._sipAddressObserver.contact : null
+				}
 				
 				username: peerAddress && historyView._sipAddressObserver? UtilsCpp.getDisplayName(historyView._sipAddressObserver.peerAddress):null
 				visible:peerAddress
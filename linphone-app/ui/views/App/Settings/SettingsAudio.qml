@@ -158,13 +158,7 @@ TabContainer {
 							visible: false
 						}
 						
-						Timer {
-							interval: 50
-							repeat: true
-							running: SettingsModel.captureGraphRunning
-							
-							onTriggered: parent.value = SettingsModel.getMicVolume()
-						}
+						value: SettingsModel.captureGraphRunning ? SettingsModel.micLevelMeter.level : 0
 					}
 				}
 			}